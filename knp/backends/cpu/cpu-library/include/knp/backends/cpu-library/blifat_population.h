@@ -22,6 +22,8 @@
 #include <knp/backends/cpu-library/impl/blifat_population_impl.h>
 #include <knp/backends/cpu-library/impl/synaptic_resource_stdp_impl.h>
 
+#include <vector>
+
 /**
  * @brief Namespace for CPU backends.
  */
@@ -43,6 +45,30 @@ std::optional<core::messaging::SpikeMessage> calculate_blifat_population(
 }
 
 
+/**
+ * @brief Make one execution step for a population of BLIFAT neurons in lazy update mode.
+ * @details Only neurons that are active or receive impacts are calculated, quiescent neurons are updated analytically
+ * when needed.
+ * @tparam BlifatLikeNeuron type of a neuron with BLIFAT-like parameters stored in columns.
+ * @param population population to update.
+ * @param endpoint message endpoint used for message exchange.
+ * @param step_n execution step.
+ * @return indexes of spiked neurons.
+ */
+template <class BlifatLikeNeuron>
+std::optional<core::messaging::SpikeMessage> calculate_lazy_blifat_population(
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n)
+{
+    auto neuron_indexes{calculate_lazy_blifat_population_data(population, endpoint)};
+    if (neuron_indexes.empty()) return {};
+
+    knp::core::messaging::SpikeMessage res_message{{population.get_uid(), step_n}, neuron_indexes};
+    endpoint.send_message(res_message);
+    SPDLOG_DEBUG("Sent {} spike(s).", res_message.neuron_indexes_.size());
+    return res_message;
+}
+
+
 /**
  * @brief Make one execution step for a population of `SynapticResourceSTDPNeuron` neurons.
  * @tparam BlifatLikeNeuron type of a neuron with BLIFAT-like parameters.
@@ -69,20 +95,31 @@ std::optional<core::messaging::SpikeMessage> calculate_resource_stdp_population(
 
 
 /**
- * @brief Make one execution step for a population of BLIFAT neurons.
+ * @brief Make one execution step for a population of `SynapticResourceSTDPNeuron` neurons.
+ * @details The method uses a precomputed list of projections instead of searching the backend projection container.
+ * Locked projections from the list are not trained.
  * @tparam BlifatLikeNeuron type of a neuron with BLIFAT-like parameters.
+ * @tparam BaseSynapseType base synapse type.
  * @param population population to update.
+ * @param incoming_projections all STDP projections with the population as postsynaptic one.
+ * @param state learning state of the population kept between steps.
  * @param endpoint message endpoint used for message exchange.
  * @param step_n execution step.
- * @param mutex mutex.
- * @return indexes of spiked neurons.
+ * @return message containing indexes of spiked neurons.
  */
-template <class BlifatLikeNeuron>
-std::optional<knp::core::messaging::SpikeMessage> calculate_blifat_population(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n,
-    std::mutex &mutex)
+template <class BlifatLikeNeuron, class BaseSynapseType>
+std::optional<core::messaging::SpikeMessage> calculate_resource_stdp_population(
+    knp::core::Population<neuron_traits::SynapticResourceSTDPNeuron<BlifatLikeNeuron>> &population,
+    std::vector<knp::core::Projection<
+        synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, BaseSynapseType>> *> &incoming_projections,
+    ResourceSTDPState<synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, BaseSynapseType>> &state,
+    knp::core::MessageEndpoint &endpoint, size_t step_n)
 {
-    return calculate_blifat_population_impl(population, endpoint, step_n, mutex);
+    state.prepare(population.size());
+    auto message_opt = calculate_blifat_population_impl(population, endpoint, step_n, &state.dopamine_neurons_);
+    state.update_synapses(incoming_projections, population.size());
+    do_STDP_resource_plasticity(population, state, message_opt, step_n);
+    return message_opt;
 }
 
 }  // namespace knp::backends::cpu
@@ -21,7 +21,8 @@
 #pragma once
 #include <knp/backends/cpu-library/impl/delta_synapse_projection_impl.h>
 
-#include <unordered_map>
+#include <utility>
+#include <vector>
 /**
  * @brief Namespace for CPU backends.
  */
@@ -45,22 +46,26 @@ void calculate_delta_synapse_projection(
 
 
 /**
- * @brief Process a part of projection synapses.
+ * @brief Process synapses of a part of spiking presynaptic neurons.
+ * @details Only synapses of the spiking neurons are processed. The function doesn't modify shared data, so parts can
+ * be processed concurrently if each part has its own output container.
+ * @note Build projection index and synapse columns before calling the function from several threads. Synapses trained
+ * by STDP rules are read from the projection itself, so columns of such projections are not used.
  * @tparam DeltaLikeSynapse type of a synapse that requires synapse weight and delay as parameters.
  * @param projection projection to receive the message.
- * @param message_in_data processed spike data for the projection.
- * @param future_messages queue of future messages.
+ * @param spikes vector of `{neuron index, number of spikes}` pairs for the spiking presynaptic neurons.
+ * @param impacts output container of `{future step, impact}` pairs. The container is cleared before processing.
  * @param step_n current step.
- * @param part_start index of the starting synapse.
- * @param part_size number of synapses to process.
- * @param mutex mutex.
+ * @param part_start index of the first spiking neuron in the `spikes` vector.
+ * @param part_size number of spiking neurons to process.
  */
 template <class DeltaLikeSynapse>
-void calculate_projection_part(
-    knp::core::Projection<DeltaLikeSynapse> &projection, const std::unordered_map<size_t, size_t> &message_in_data,
-    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex)
+void calculate_projection_spikes_part(
+    const knp::core::Projection<DeltaLikeSynapse> &projection,
+    const std::vector<std::pair<core::messaging::SpikeIndex, size_t>> &spikes, DelayedImpacts &impacts,
+    uint64_t step_n, size_t part_start, size_t part_size)
 {
-    calculate_projection_part_impl(projection, message_in_data, future_messages, step_n, part_start, part_size, mutex);
+    calculate_projection_spikes_part_impl(projection, spikes, impacts, step_n, part_start, part_size);
 }
 
 }  // namespace knp::backends::cpu
@@ -28,6 +28,9 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <cmath>
+#include <memory>
 #include <unordered_map>
 #include <utility>
 #include <vector>
@@ -101,14 +104,14 @@ private:
 template <class DeltaLikeSynapse>
 inline void append_spike_times(
     knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse> &projection, const SpikeMessage &message,
-    const std::function<std::vector<size_t>(uint32_t)> &synapse_index_getter,
+    const std::function<knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse>::SynapseIndexRange(
+        uint32_t)> &synapse_index_getter,
     std::vector<uint32_t> knp::synapse_traits::STDPAdditiveRule<DeltaLikeSynapse>::*spike_queue)
 {
     // Fill synapses spike queue.
     for (auto neuron_index : message.neuron_indexes_)
     {
         // Might be able to change it into "traces".
-        // TODO: Inefficient, MUST be cached.
         for (auto synapse_index : synapse_index_getter(neuron_index))
         {
             auto &rule = std::get<core::SynapseElementAccess::synapse_data>(projection[synapse_index]).rule_;
@@ -124,7 +127,9 @@ inline void append_spike_times(
 
 inline void append_spike_times(
     knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse> &projection,
-    const std::vector<SpikeMessage> &spikes, const std::function<std::vector<size_t>(uint32_t)> &syn_index_getter,
+    const std::vector<SpikeMessage> &spikes,
+    const std::function<knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse>::SynapseIndexRange(
+        uint32_t)> &syn_index_getter,
     std::vector<uint32_t> knp::synapse_traits::STDPAdditiveRule<knp::synapse_traits::DeltaSynapse>::*spike_queue)
 {
     for (const auto &msg : spikes)
@@ -153,7 +158,7 @@ template <class DeltaLikeSynapse>
 void register_additive_stdp_spikes(
     knp::core::Projection<knp::synapse_traits::STDP<knp::synapse_traits::STDPAdditiveRule, DeltaLikeSynapse>>
         &projection,
-    std::vector<SpikeMessage> &all_messages)
+    SharedSpikeMessages &all_messages)
 {
     SPDLOG_DEBUG("Calculating additive STDP delta synapse projection...");
 
@@ -162,43 +167,38 @@ void register_additive_stdp_spikes(
 
     const auto &stdp_pops = projection.get_shared_parameters().stdp_populations_;
 
-    // Spike messages to process as usual.
-    std::vector<SpikeMessage> stdp_only_messages;
-    stdp_only_messages.reserve(all_messages.size());
-
     // TODO: Remove cycles.
     for (auto &msg : all_messages)
     {
-        const auto &stdp_pop_iter = stdp_pops.find(msg.header_.sender_uid_);
+        const auto &stdp_pop_iter = stdp_pops.find(msg->header_.sender_uid_);
         if (stdp_pop_iter == stdp_pops.end())
         {
             continue;
         }
 
         const auto &[uid, processing_type] = *stdp_pop_iter;
-        assert(uid == msg.header_.sender_uid_);
+        assert(uid == msg->header_.sender_uid_);
         if (processing_type == ProcessingType::STDPOnly || processing_type == ProcessingType::STDPAndSpike)
         {
             SPDLOG_TRACE("Add spikes to STDP projection postsynaptic history.");
             append_spike_times(
-                projection, msg,
-                [&projection](uint32_t neuron_index)
-                { return projection.find_synapses(neuron_index, ProjectionType::Search::by_postsynaptic); },
+                projection, *msg,
+                [&projection](uint32_t neuron_index) { return projection.synapses_of_postsynaptic(neuron_index); },
                 &knp::synapse_traits::STDPAdditiveRule<knp::synapse_traits::DeltaSynapse>::postsynaptic_spike_times_);
         }
         if (processing_type == ProcessingType::STDPAndSpike)
         {
             SPDLOG_TRACE("Add spikes to STDP projection presynaptic history.");
             append_spike_times(
-                projection, msg,
-                [&projection](uint32_t neuron_index)
-                { return projection.find_synapses(neuron_index, ProjectionType::Search::by_postsynaptic); },
+                projection, *msg,
+                [&projection](uint32_t neuron_index) { return projection.synapses_of_postsynaptic(neuron_index); },
                 &knp::synapse_traits::STDPAdditiveRule<knp::synapse_traits::DeltaSynapse>::presynaptic_spike_times_);
         }
         if (processing_type == ProcessingType::STDPOnly)
         {
             SPDLOG_TRACE("STDP-only synapse, remove message from list.");
-            msg.neuron_indexes_ = {};
+            // The message can be shared with other receivers, so it is replaced instead of being modified.
+            msg = std::make_shared<const SpikeMessage>(SpikeMessage{msg->header_, {}});
         }
 
         assert(processing_type == ProcessingType::STDPAndSpike || processing_type == ProcessingType::STDPOnly);
@@ -229,6 +229,187 @@ void update_projection_weights_additive_stdp(
             rule.postsynaptic_spike_times_.clear();
         }
     }
+    projection.mark_synapses_modified();
+}
+
+
+/**
+ * @brief Get value of a spike trace on the given step.
+ * @details If the trace was updated on a later step, it is not decayed.
+ * @param traces neuron traces.
+ * @param neuron_index neuron index.
+ * @param step step index.
+ * @param tau trace time constant.
+ * @return decayed trace value.
+ */
+inline float get_trace_value(
+    const std::vector<knp::synapse_traits::STDPTrace> &traces, size_t neuron_index, uint64_t step, float tau)
+{
+    if (neuron_index >= traces.size()) return 0;
+    const auto &trace = traces[neuron_index];
+    if (trace.value_ == 0 || step <= trace.step_) return trace.value_;
+    return trace.value_ * std::exp(-static_cast<float>(step - trace.step_) / tau);
+}
+
+
+/**
+ * @brief Add neuron spikes to their traces.
+ * @param traces neuron traces, resized if a neuron index is out of range.
+ * @param neuron_indexes indexes of spiked neurons.
+ * @param step spike step.
+ * @param tau trace time constant.
+ */
+inline void add_spikes_to_traces(
+    std::vector<knp::synapse_traits::STDPTrace> &traces, const knp::core::messaging::SpikeData &neuron_indexes,
+    uint64_t step, float tau)
+{
+    for (const auto neuron_index : neuron_indexes)
+    {
+        if (neuron_index >= traces.size()) traces.resize(neuron_index + 1);
+        // A spike of an earlier step doesn't move the trace step back.
+        traces[neuron_index] = {
+            get_trace_value(traces, neuron_index, step, tau) + 1, std::max(step, traces[neuron_index].step_)};
+    }
+}
+
+
+/**
+ * @brief Spikes received by an additive STDP projection in the trace mode.
+ */
+struct AdditiveSTDPTraceSpikes
+{
+    /**
+     * @brief Spike message.
+     */
+    std::shared_ptr<const SpikeMessage> message_;
+
+    /**
+     * @brief `true` if the spikes are postsynaptic.
+     */
+    bool is_postsynaptic_;
+
+    /**
+     * @brief `true` if the spikes are presynaptic.
+     */
+    bool is_presynaptic_;
+};
+
+
+/**
+ * @brief Change weights of additive STDP synapses using neuron spike traces.
+ * @details A postsynaptic spike increases weights of neuron synapses proportionally to the traces of presynaptic
+ * neurons. A presynaptic spike decreases weights of neuron synapses proportionally to the traces of postsynaptic
+ * neurons. Traces are not changed, so they must be updated after weight changes of all spikes of the step.
+ * @tparam DeltaLikeSynapse base synapse type.
+ * @param projection projection to update.
+ * @param spikes spikes of a population.
+ */
+template <class DeltaLikeSynapse>
+void apply_additive_stdp_traces(
+    knp::core::Projection<knp::synapse_traits::STDP<knp::synapse_traits::STDPAdditiveRule, DeltaLikeSynapse>>
+        &projection,
+    const AdditiveSTDPTraceSpikes &spikes)
+{
+    const auto &params = projection.get_shared_parameters().synapses_parameters_;
+    const uint64_t step = spikes.message_->header_.send_time_;
+
+    for (const auto neuron_index : spikes.message_->neuron_indexes_)
+    {
+        if (spikes.is_postsynaptic_)
+        {
+            for (const auto synapse_index : projection.synapses_of_postsynaptic(neuron_index))
+            {
+                auto &synapse = projection[synapse_index];
+                const float trace = get_trace_value(
+                    params.presynaptic_traces_, std::get<core::source_neuron_id>(synapse), step, params.tau_plus_);
+                std::get<core::synapse_data>(synapse).weight_ += params.a_plus_ * trace;
+            }
+        }
+        if (spikes.is_presynaptic_)
+        {
+            for (const auto synapse_index : projection.synapses_of_presynaptic(neuron_index))
+            {
+                auto &synapse = projection[synapse_index];
+                const float trace = get_trace_value(
+                    params.postsynaptic_traces_, std::get<core::target_neuron_id>(synapse), step, params.tau_minus_);
+                std::get<core::synapse_data>(synapse).weight_ -= params.a_minus_ * trace;
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Process spikes received by an additive STDP projection in the trace mode.
+ * @details Spikes of populations registered as STDP populations are postsynaptic. Other spikes and spikes of
+ * populations with `STDPAndSpike` processing type are presynaptic. All spikes of a step change weights using traces
+ * of previous steps, then they are added to the traces. Thus weight changes don't depend on the message order, and
+ * presynaptic and postsynaptic spikes of the same step are not paired.
+ * @tparam DeltaLikeSynapse base synapse type.
+ * @param projection projection to update.
+ * @param all_messages spike messages received by the projection.
+ */
+template <class DeltaLikeSynapse>
+void register_additive_stdp_traces(
+    knp::core::Projection<knp::synapse_traits::STDP<knp::synapse_traits::STDPAdditiveRule, DeltaLikeSynapse>>
+        &projection,
+    SharedSpikeMessages &all_messages)
+{
+    using ProjectionType = typename std::decay_t<decltype(projection)>;
+    using ProcessingType = typename ProjectionType::SharedSynapseParameters::ProcessingType;
+
+    const auto &stdp_pops = projection.get_shared_parameters().stdp_populations_;
+    std::vector<AdditiveSTDPTraceSpikes> all_spikes;
+    all_spikes.reserve(all_messages.size());
+    for (auto &msg : all_messages)
+    {
+        const auto stdp_pop_iter = stdp_pops.find(msg->header_.sender_uid_);
+        if (stdp_pop_iter == stdp_pops.end())
+        {
+            all_spikes.push_back({msg, false, true});
+            continue;
+        }
+
+        const auto processing_type = stdp_pop_iter->second;
+        all_spikes.push_back({msg, true, processing_type == ProcessingType::STDPAndSpike});
+        if (processing_type == ProcessingType::STDPOnly)
+        {
+            // The message can be shared with other receivers, so it is replaced instead of being modified.
+            msg = std::make_shared<const SpikeMessage>(SpikeMessage{msg->header_, {}});
+        }
+    }
+    if (all_spikes.empty()) return;
+
+    auto get_step = [](const AdditiveSTDPTraceSpikes &spikes) { return spikes.message_->header_.send_time_; };
+    std::stable_sort(
+        all_spikes.begin(), all_spikes.end(),
+        [&get_step](const auto &left, const auto &right) { return get_step(left) < get_step(right); });
+
+    auto &params = projection.get_shared_parameters().synapses_parameters_;
+    for (auto step_begin = all_spikes.begin(); step_begin != all_spikes.end();)
+    {
+        const uint64_t step = get_step(*step_begin);
+        const auto step_end = std::find_if(
+            step_begin, all_spikes.end(), [&get_step, step](const auto &spikes) { return get_step(spikes) != step; });
+
+        for (auto spikes = step_begin; spikes != step_end; ++spikes) apply_additive_stdp_traces(projection, *spikes);
+        for (auto spikes = step_begin; spikes != step_end; ++spikes)
+        {
+            if (spikes->is_postsynaptic_)
+            {
+                add_spikes_to_traces(
+                    params.postsynaptic_traces_, spikes->message_->neuron_indexes_, step, params.tau_minus_);
+            }
+            if (spikes->is_presynaptic_)
+            {
+                add_spikes_to_traces(
+                    params.presynaptic_traces_, spikes->message_->neuron_indexes_, step, params.tau_plus_);
+            }
+        }
+        step_begin = step_end;
+    }
+
+    projection.mark_synapses_modified();
 }
 
 
@@ -237,8 +418,13 @@ struct WeightUpdateSTDP<synapse_traits::STDP<synapse_traits::STDPAdditiveRule, D
 {
     using Synapse = synapse_traits::STDP<synapse_traits::STDPAdditiveRule, DeltaLikeSynapse>;
     static void init_projection(
-        knp::core::Projection<Synapse> &projection, std::vector<SpikeMessage> &all_messages, uint64_t step)
+        knp::core::Projection<Synapse> &projection, SharedSpikeMessages &all_messages, uint64_t step)
     {
+        if (projection.get_shared_parameters().synapses_parameters_.mode_ == synapse_traits::STDPAdditiveMode::traces)
+        {
+            register_additive_stdp_traces(projection, all_messages);
+            return;
+        }
         register_additive_stdp_spikes(projection, all_messages);
     }
 
@@ -246,6 +432,11 @@ struct WeightUpdateSTDP<synapse_traits::STDP<synapse_traits::STDPAdditiveRule, D
 
     static void modify_weights(knp::core::Projection<Synapse> &projection)
     {
+        // Weights are changed on spikes in the trace mode.
+        if (projection.get_shared_parameters().synapses_parameters_.mode_ == synapse_traits::STDPAdditiveMode::traces)
+        {
+            return;
+        }
         update_projection_weights_additive_stdp(projection);
     }
 };
@@ -21,7 +21,10 @@
 #pragma once
 #include <knp/core/messaging/messaging.h>
 #include <knp/core/projection.h>
+#include <knp/synapse-traits/stdp_common.h>
 
+#include <memory>
+#include <type_traits>
 #include <vector>
 
 /**
@@ -30,12 +33,46 @@
 namespace knp::backends::cpu
 {
 
+/**
+ * @brief Spike messages shared with other message receivers.
+ */
+using SharedSpikeMessages = std::vector<std::shared_ptr<const core::messaging::SpikeMessage>>;
+
+
+/**
+ * @brief Structure used to check if synapses of the given type are trained by an STDP rule.
+ * @tparam SynapseType synapse type.
+ */
+template <class SynapseType>
+struct is_stdp_synapse : std::false_type
+{
+};
+
+
+/**
+ * @brief Structure used to check if synapses of the given type are trained by an STDP rule.
+ * @tparam Rule STDP rule.
+ * @tparam SynapseType base synapse type.
+ */
+template <template <typename> typename Rule, typename SynapseType>
+struct is_stdp_synapse<synapse_traits::STDP<Rule, SynapseType>> : std::true_type
+{
+};
+
+
+/**
+ * @brief `true` if synapses of the given type are trained by an STDP rule.
+ * @tparam SynapseType synapse type.
+ */
+template <class SynapseType>
+constexpr bool is_stdp_synapse_v = is_stdp_synapse<SynapseType>::value;
+
+
 template <class DeltaLikeSynapse>
 struct WeightUpdateSTDP
 {
     static void init_projection(
-        const knp::core::Projection<DeltaLikeSynapse> &projection,
-        const std::vector<core::messaging::SpikeMessage> &messages, uint64_t step)
+        const knp::core::Projection<DeltaLikeSynapse> &projection, const SharedSpikeMessages &messages, uint64_t step)
     {
     }
 
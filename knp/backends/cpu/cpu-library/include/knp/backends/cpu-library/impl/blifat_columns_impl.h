@@ -0,0 +1,922 @@
+/**
+ * @file blifat_columns_impl.h
+ * @brief Calculation routines for BLIFAT neurons stored as columns.
+ * @kaspersky_support Artiom N.
+ * @date 17.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/messaging/messaging.h>
+#include <knp/neuron-traits/blifat.h>
+#include <knp/synapse-traits/output_types.h>
+
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <vector>
+
+// Vectorized routines are used only if AVX is enabled by the `KNP_ENABLE_AVX` CMake option and supported by the
+// target architecture. Otherwise, scalar routines are used.
+#if defined(KNP_ENABLE_AVX) && (defined(__AVX512F__) || defined(__AVX2__))
+#    include <immintrin.h>
+#endif
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+/**
+ * @brief BLIFAT neuron parameters stored as columns.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ */
+template <class Real>
+using BLIFATColumns = knp::neuron_traits::neuron_columns<knp::neuron_traits::BLIFATNeuronT<Real>>;
+
+
+/**
+ * @brief Type of the container of synaptic impact messages that can be shared with other receivers.
+ */
+using SharedImpactMessages = std::vector<std::shared_ptr<const core::messaging::SynapticImpactMessage>>;
+
+
+/**
+ * @brief Calculate the result of a synaptic impact on a neuron stored in columns.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param index neuron index.
+ * @param synapse_type type of input signal.
+ * @param impact_value value of input signal.
+ */
+template <class Real>
+void impact_column_neuron(
+    BLIFATColumns<Real> &columns, size_t index, const knp::synapse_traits::OutputType &synapse_type, float impact_value)
+{
+    switch (synapse_type)
+    {
+        case knp::synapse_traits::OutputType::EXCITATORY:
+            columns.potential_[index] += impact_value;
+            break;
+        case knp::synapse_traits::OutputType::INHIBITORY_CURRENT:
+            columns.potential_[index] -= impact_value;
+            break;
+        case knp::synapse_traits::OutputType::INHIBITORY_CONDUCTANCE:
+            columns.inhibitory_conductance_[index] += impact_value;
+            break;
+        case knp::synapse_traits::OutputType::DOPAMINE:
+            columns.dopamine_value_[index] += impact_value;
+            break;
+        case knp::synapse_traits::OutputType::BLOCKING:
+            columns.total_blocking_period_[index] = static_cast<unsigned int>(impact_value);
+            break;
+    }
+}
+
+
+/**
+ * @brief Process messages sent to a population stored in columns.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param messages synaptic impact messages sent to the population.
+ */
+template <class Real>
+void process_column_inputs(
+    BLIFATColumns<Real> &columns, const SharedImpactMessages &messages)
+{
+    for (const auto &message : messages)
+    {
+        for (const auto &impact : message->impacts_)
+        {
+            impact_column_neuron(
+                columns, impact.postsynaptic_neuron_index_, impact.synapse_type_, impact.impact_value_);
+        }
+    }
+}
+
+
+/**
+ * @brief Calculate a single neuron state before impacts.
+ * @details Scalar version used for population tails and for builds without AVX.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param index neuron index.
+ */
+template <class Real>
+void calculate_column_neuron_state(BLIFATColumns<Real> &columns, size_t index)
+{
+    const size_t static_index = columns.get_static_index(index);
+    ++columns.n_time_steps_since_last_firing_[index];
+    columns.dynamic_threshold_[index] *= columns.threshold_decay_[static_index];
+    columns.postsynaptic_trace_[index] *= columns.postsynaptic_trace_decay_[static_index];
+    columns.inhibitory_conductance_[index] *= columns.inhibitory_conductance_decay_[static_index];
+
+    auto &bursting_phase = columns.bursting_phase_[index];
+    auto &potential = columns.potential_[index];
+    if (bursting_phase && !--bursting_phase)
+    {
+        potential = potential * columns.potential_decay_[static_index] + columns.reflexive_weight_[static_index];
+    }
+    else
+    {
+        potential *= columns.potential_decay_[static_index];
+    }
+    columns.pre_impact_potential_[index] = potential;
+}
+
+
+/**
+ * @brief Calculate a single neuron state after impacts.
+ * @details Scalar version used for population tails and for builds without AVX.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param index neuron index.
+ * @return `true` if the neuron spiked.
+ */
+template <class Real>
+bool calculate_column_neuron_post_input_state(BLIFATColumns<Real> &columns, size_t index)
+{
+    const size_t static_index = columns.get_static_index(index);
+    auto &potential = columns.potential_[index];
+    auto &total_blocking_period = columns.total_blocking_period_[index];
+    if (total_blocking_period <= 0)
+    {
+        // Restore potential that the neuron had before impacts.
+        potential = columns.pre_impact_potential_[index];
+        bool was_negative = total_blocking_period < 0;
+        total_blocking_period += was_negative;
+        total_blocking_period += std::numeric_limits<int64_t>::max() * ((total_blocking_period == 0) && was_negative);
+    }
+    else
+    {
+        total_blocking_period -= 1;
+    }
+
+    const auto inhibitory_conductance = columns.inhibitory_conductance_[index];
+    const auto reversal_inhibitory_potential = columns.reversal_inhibitory_potential_[static_index];
+    if (inhibitory_conductance < 1)
+    {
+        potential -= (potential - reversal_inhibitory_potential) * inhibitory_conductance;
+    }
+    else
+    {
+        potential = reversal_inhibitory_potential;
+    }
+
+    bool spike = false;
+    if ((columns.n_time_steps_since_last_firing_[index] > columns.absolute_refractory_period_[static_index]) &&
+        (potential >= columns.activation_threshold_[static_index] + columns.dynamic_threshold_[index]))
+    {
+        columns.dynamic_threshold_[index] += columns.threshold_increment_[static_index];
+        columns.postsynaptic_trace_[index] += columns.postsynaptic_trace_increment_[static_index];
+
+        potential = columns.potential_reset_value_[static_index];
+        columns.bursting_phase_[index] = columns.bursting_period_[static_index];
+        columns.n_time_steps_since_last_firing_[index] = 0;
+        spike = true;
+    }
+
+    if (potential < columns.min_potential_[static_index])
+    {
+        potential = columns.min_potential_[static_index];
+    }
+
+    return spike;
+}
+
+
+#if defined(KNP_ENABLE_AVX) && defined(__AVX512F__)
+
+/**
+ * @brief Number of neurons calculated by a single vectorized routine call.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ */
+template <class Real>
+constexpr size_t blifat_columns_lane_count = 64 / sizeof(Real);
+
+
+/**
+ * @brief Mask that selects all lanes of a vector.
+ * @details Zero-masked conversions are used with this mask, as unmasked ones trigger false uninitialized value
+ * warnings in some GCC versions.
+ */
+constexpr __mmask8 blifat_columns_all_lanes = 0xFF;
+
+
+/**
+ * @brief Load values of a double-precision static parameter for `blifat_columns_lane_count<double>` neurons.
+ * @tparam SharedStatic `true` if the column contains a single value shared by all neurons.
+ * @param column parameter column.
+ * @param index index of the first neuron.
+ * @return parameter values.
+ */
+template <bool SharedStatic>
+__m512d load_static_pd(const std::vector<double> &column, size_t index)
+{
+    if constexpr (SharedStatic) return _mm512_set1_pd(column.front());
+    return _mm512_loadu_pd(column.data() + index);
+}
+
+
+/**
+ * @brief Load values of an unsigned 32-bit static parameter for `blifat_columns_lane_count<double>` neurons as 64-bit
+ * values.
+ * @tparam SharedStatic `true` if the column contains a single value shared by all neurons.
+ * @param column parameter column.
+ * @param index index of the first neuron.
+ * @return parameter values.
+ */
+template <bool SharedStatic>
+__m512i load_static_epu32(const std::vector<unsigned> &column, size_t index)
+{
+    if constexpr (SharedStatic) return _mm512_set1_epi64(column.front());
+    return _mm512_maskz_cvtepu32_epi64(
+        blifat_columns_all_lanes, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(column.data() + index)));
+}
+
+
+/**
+ * @brief Load values of a single-precision static parameter for `blifat_columns_lane_count<float>` neurons.
+ * @tparam SharedStatic `true` if the column contains a single value shared by all neurons.
+ * @param column parameter column.
+ * @param index index of the first neuron.
+ * @return parameter values.
+ */
+template <bool SharedStatic>
+__m512 load_static_ps(const std::vector<float> &column, size_t index)
+{
+    if constexpr (SharedStatic) return _mm512_set1_ps(column.front());
+    return _mm512_loadu_ps(column.data() + index);
+}
+
+
+/**
+ * @brief Count blocking periods of `blifat_columns_lane_count<double>` neurons towards zero.
+ * @details Positive periods are decreased. Negative periods are increased and set to maximum when they reach zero.
+ * @param blocking_data blocking periods of the neurons.
+ * @return mask of neurons which were blocked and keep potential changed by impacts.
+ */
+inline __mmask8 update_blocking_periods(int64_t *blocking_data)
+{
+    __m512i blocking = _mm512_loadu_si512(blocking_data);
+    const __m512i zero = _mm512_setzero_si512();
+    const __mmask8 is_blocked = _mm512_cmpgt_epi64_mask(blocking, zero);
+    const __mmask8 was_negative = _mm512_cmplt_epi64_mask(blocking, zero);
+    blocking = _mm512_mask_sub_epi64(blocking, is_blocked, blocking, _mm512_set1_epi64(1));
+    blocking = _mm512_mask_add_epi64(blocking, was_negative, blocking, _mm512_set1_epi64(1));
+    blocking = _mm512_mask_mov_epi64(
+        blocking, was_negative & _mm512_cmpeq_epi64_mask(blocking, zero),
+        _mm512_set1_epi64(std::numeric_limits<int64_t>::max()));
+    _mm512_storeu_si512(blocking_data, blocking);
+    return is_blocked;
+}
+
+
+/**
+ * @brief Calculate states of neurons before impacts using AVX-512.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<double>` neurons.
+ */
+template <bool SharedStatic>
+void calculate_column_neurons_state_simd(BLIFATColumns<double> &columns, size_t index)
+{
+    static_assert(sizeof(columns.n_time_steps_since_last_firing_[0]) == sizeof(int64_t));
+
+    auto *n_steps = reinterpret_cast<__m512i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    _mm512_storeu_si512(n_steps, _mm512_add_epi64(_mm512_loadu_si512(n_steps), _mm512_set1_epi64(1)));
+
+    auto decay = [index](std::vector<double> &values, const std::vector<double> &factors)
+    {
+        _mm512_storeu_pd(
+            values.data() + index,
+            _mm512_mul_pd(_mm512_loadu_pd(values.data() + index), load_static_pd<SharedStatic>(factors, index)));
+    };
+    decay(columns.dynamic_threshold_, columns.threshold_decay_);
+    decay(columns.postsynaptic_trace_, columns.postsynaptic_trace_decay_);
+    decay(columns.inhibitory_conductance_, columns.inhibitory_conductance_decay_);
+
+    // Bursting: decrease non-zero phases, add reflexive weight to neurons whose phase becomes zero.
+    auto *phase_data = reinterpret_cast<__m256i *>(columns.bursting_phase_.data() + index);
+    const __m256i phase = _mm256_loadu_si256(phase_data);
+    const __m512i phase_64 = _mm512_maskz_cvtepu32_epi64(blifat_columns_all_lanes, phase);
+    const __mmask8 is_bursting = _mm512_cmpneq_epu64_mask(phase_64, _mm512_setzero_si512());
+    const __mmask8 burst = _mm512_cmpeq_epu64_mask(phase_64, _mm512_set1_epi64(1));
+    _mm256_storeu_si256(
+        phase_data,
+        _mm512_maskz_cvtepi64_epi32(
+            blifat_columns_all_lanes, _mm512_mask_sub_epi64(phase_64, is_bursting, phase_64, _mm512_set1_epi64(1))));
+
+    __m512d potential = _mm512_mul_pd(
+        _mm512_loadu_pd(columns.potential_.data() + index),
+        load_static_pd<SharedStatic>(columns.potential_decay_, index));
+    potential =
+        _mm512_mask_add_pd(potential, burst, potential, load_static_pd<SharedStatic>(columns.reflexive_weight_, index));
+    _mm512_storeu_pd(columns.potential_.data() + index, potential);
+    _mm512_storeu_pd(columns.pre_impact_potential_.data() + index, potential);
+}
+
+
+/**
+ * @brief Calculate states of neurons after impacts using AVX-512.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<double>` neurons.
+ * @return bit mask of spiked neurons.
+ */
+template <bool SharedStatic>
+unsigned calculate_column_neurons_post_input_state_simd(BLIFATColumns<double> &columns, size_t index)
+{
+    // Blocking period: restore pre-impact potential of non-blocked neurons, count blocking periods towards zero.
+    const __mmask8 is_blocked = update_blocking_periods(columns.total_blocking_period_.data() + index);
+    __m512d potential = _mm512_mask_blend_pd(
+        is_blocked, _mm512_loadu_pd(columns.pre_impact_potential_.data() + index),
+        _mm512_loadu_pd(columns.potential_.data() + index));
+
+    // Inhibitory conductance.
+    const __m512d conductance = _mm512_loadu_pd(columns.inhibitory_conductance_.data() + index);
+    const __m512d reversal = load_static_pd<SharedStatic>(columns.reversal_inhibitory_potential_, index);
+    const __mmask8 is_conducting = _mm512_cmp_pd_mask(conductance, _mm512_set1_pd(1.0), _CMP_LT_OQ);
+    potential = _mm512_mask_blend_pd(
+        is_conducting, reversal,
+        _mm512_sub_pd(potential, _mm512_mul_pd(_mm512_sub_pd(potential, reversal), conductance)));
+
+    // Spike detection.
+    auto *n_steps_data = reinterpret_cast<__m512i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    const __m512i n_steps = _mm512_loadu_si512(n_steps_data);
+    const __m512i refractory_period = load_static_epu32<SharedStatic>(columns.absolute_refractory_period_, index);
+    __m512d dynamic_threshold = _mm512_loadu_pd(columns.dynamic_threshold_.data() + index);
+    const __m512d threshold =
+        _mm512_add_pd(load_static_pd<SharedStatic>(columns.activation_threshold_, index), dynamic_threshold);
+    const __mmask8 spike = _mm512_cmpgt_epu64_mask(n_steps, refractory_period) &
+                           _mm512_cmp_pd_mask(potential, threshold, _CMP_GE_OQ);
+
+    dynamic_threshold = _mm512_mask_add_pd(
+        dynamic_threshold, spike, dynamic_threshold, load_static_pd<SharedStatic>(columns.threshold_increment_, index));
+    _mm512_storeu_pd(columns.dynamic_threshold_.data() + index, dynamic_threshold);
+    const __m512d trace = _mm512_loadu_pd(columns.postsynaptic_trace_.data() + index);
+    _mm512_storeu_pd(
+        columns.postsynaptic_trace_.data() + index,
+        _mm512_mask_add_pd(
+            trace, spike, trace, load_static_pd<SharedStatic>(columns.postsynaptic_trace_increment_, index)));
+    potential =
+        _mm512_mask_blend_pd(spike, potential, load_static_pd<SharedStatic>(columns.potential_reset_value_, index));
+    _mm512_storeu_si512(n_steps_data, _mm512_mask_mov_epi64(n_steps, spike, _mm512_setzero_si512()));
+
+    // Minimal potential.
+    const __m512d min_potential = load_static_pd<SharedStatic>(columns.min_potential_, index);
+    potential =
+        _mm512_mask_blend_pd(_mm512_cmp_pd_mask(potential, min_potential, _CMP_LT_OQ), potential, min_potential);
+    _mm512_storeu_pd(columns.potential_.data() + index, potential);
+
+    return spike;
+}
+
+/**
+ * @brief Calculate states of single-precision neurons before impacts using AVX-512.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<float>` neurons.
+ */
+template <bool SharedStatic>
+void calculate_column_neurons_state_simd(BLIFATColumns<float> &columns, size_t index)
+{
+    static_assert(sizeof(columns.n_time_steps_since_last_firing_[0]) == sizeof(int64_t));
+
+    // 64-bit step counters of the neurons take two vectors.
+    auto *n_steps = reinterpret_cast<__m512i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    _mm512_storeu_si512(n_steps, _mm512_add_epi64(_mm512_loadu_si512(n_steps), _mm512_set1_epi64(1)));
+    _mm512_storeu_si512(n_steps + 1, _mm512_add_epi64(_mm512_loadu_si512(n_steps + 1), _mm512_set1_epi64(1)));
+
+    auto decay = [index](std::vector<float> &values, const std::vector<float> &factors)
+    {
+        _mm512_storeu_ps(
+            values.data() + index,
+            _mm512_mul_ps(_mm512_loadu_ps(values.data() + index), load_static_ps<SharedStatic>(factors, index)));
+    };
+    decay(columns.dynamic_threshold_, columns.threshold_decay_);
+    decay(columns.postsynaptic_trace_, columns.postsynaptic_trace_decay_);
+    decay(columns.inhibitory_conductance_, columns.inhibitory_conductance_decay_);
+
+    // Bursting: decrease non-zero phases, add reflexive weight to neurons whose phase becomes zero.
+    auto *phase_data = reinterpret_cast<__m512i *>(columns.bursting_phase_.data() + index);
+    const __m512i phase = _mm512_loadu_si512(phase_data);
+    const __mmask16 is_bursting = _mm512_cmpneq_epu32_mask(phase, _mm512_setzero_si512());
+    const __mmask16 burst = _mm512_cmpeq_epu32_mask(phase, _mm512_set1_epi32(1));
+    _mm512_storeu_si512(phase_data, _mm512_mask_sub_epi32(phase, is_bursting, phase, _mm512_set1_epi32(1)));
+
+    __m512 potential = _mm512_mul_ps(
+        _mm512_loadu_ps(columns.potential_.data() + index),
+        load_static_ps<SharedStatic>(columns.potential_decay_, index));
+    potential =
+        _mm512_mask_add_ps(potential, burst, potential, load_static_ps<SharedStatic>(columns.reflexive_weight_, index));
+    _mm512_storeu_ps(columns.potential_.data() + index, potential);
+    _mm512_storeu_ps(columns.pre_impact_potential_.data() + index, potential);
+}
+
+
+/**
+ * @brief Calculate states of single-precision neurons after impacts using AVX-512.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<float>` neurons.
+ * @return bit mask of spiked neurons.
+ */
+template <bool SharedStatic>
+unsigned calculate_column_neurons_post_input_state_simd(BLIFATColumns<float> &columns, size_t index)
+{
+    // 64-bit blocking periods and step counters of the neurons take two vectors, their masks are merged.
+    constexpr size_t half = blifat_columns_lane_count<double>;
+
+    // Blocking period: restore pre-impact potential of non-blocked neurons, count blocking periods towards zero.
+    auto *blocking_data = columns.total_blocking_period_.data() + index;
+    const auto is_blocked = static_cast<__mmask16>(
+        update_blocking_periods(blocking_data) | (update_blocking_periods(blocking_data + half) << half));
+    __m512 potential = _mm512_mask_blend_ps(
+        is_blocked, _mm512_loadu_ps(columns.pre_impact_potential_.data() + index),
+        _mm512_loadu_ps(columns.potential_.data() + index));
+
+    // Inhibitory conductance.
+    const __m512 conductance = _mm512_loadu_ps(columns.inhibitory_conductance_.data() + index);
+    const __m512 reversal = load_static_ps<SharedStatic>(columns.reversal_inhibitory_potential_, index);
+    const __mmask16 is_conducting = _mm512_cmp_ps_mask(conductance, _mm512_set1_ps(1.0F), _CMP_LT_OQ);
+    potential = _mm512_mask_blend_ps(
+        is_conducting, reversal,
+        _mm512_sub_ps(potential, _mm512_mul_ps(_mm512_sub_ps(potential, reversal), conductance)));
+
+    // Spike detection.
+    auto *n_steps_data = reinterpret_cast<__m512i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    const __m512i n_steps_low = _mm512_loadu_si512(n_steps_data);
+    const __m512i n_steps_high = _mm512_loadu_si512(n_steps_data + 1);
+    const auto &refractory_period = columns.absolute_refractory_period_;
+    const auto is_ready = static_cast<__mmask16>(
+        _mm512_cmpgt_epu64_mask(n_steps_low, load_static_epu32<SharedStatic>(refractory_period, index)) |
+        (_mm512_cmpgt_epu64_mask(n_steps_high, load_static_epu32<SharedStatic>(refractory_period, index + half))
+         << half));
+    __m512 dynamic_threshold = _mm512_loadu_ps(columns.dynamic_threshold_.data() + index);
+    const __m512 threshold =
+        _mm512_add_ps(load_static_ps<SharedStatic>(columns.activation_threshold_, index), dynamic_threshold);
+    const __mmask16 spike = is_ready & _mm512_cmp_ps_mask(potential, threshold, _CMP_GE_OQ);
+
+    dynamic_threshold = _mm512_mask_add_ps(
+        dynamic_threshold, spike, dynamic_threshold, load_static_ps<SharedStatic>(columns.threshold_increment_, index));
+    _mm512_storeu_ps(columns.dynamic_threshold_.data() + index, dynamic_threshold);
+    const __m512 trace = _mm512_loadu_ps(columns.postsynaptic_trace_.data() + index);
+    _mm512_storeu_ps(
+        columns.postsynaptic_trace_.data() + index,
+        _mm512_mask_add_ps(
+            trace, spike, trace, load_static_ps<SharedStatic>(columns.postsynaptic_trace_increment_, index)));
+    potential =
+        _mm512_mask_blend_ps(spike, potential, load_static_ps<SharedStatic>(columns.potential_reset_value_, index));
+    const __m512i zero = _mm512_setzero_si512();
+    _mm512_storeu_si512(n_steps_data, _mm512_mask_mov_epi64(n_steps_low, static_cast<__mmask8>(spike), zero));
+    _mm512_storeu_si512(
+        n_steps_data + 1, _mm512_mask_mov_epi64(n_steps_high, static_cast<__mmask8>(spike >> half), zero));
+
+    // Minimal potential.
+    const __m512 min_potential = load_static_ps<SharedStatic>(columns.min_potential_, index);
+    potential =
+        _mm512_mask_blend_ps(_mm512_cmp_ps_mask(potential, min_potential, _CMP_LT_OQ), potential, min_potential);
+    _mm512_storeu_ps(columns.potential_.data() + index, potential);
+
+    return spike;
+}
+
+#elif defined(KNP_ENABLE_AVX) && defined(__AVX2__)
+
+/**
+ * @brief Number of neurons calculated by a single vectorized routine call.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ */
+template <class Real>
+constexpr size_t blifat_columns_lane_count = 32 / sizeof(Real);
+
+
+/**
+ * @brief Load values of a double-precision static parameter for `blifat_columns_lane_count<double>` neurons.
+ * @tparam SharedStatic `true` if the column contains a single value shared by all neurons.
+ * @param column parameter column.
+ * @param index index of the first neuron.
+ * @return parameter values.
+ */
+template <bool SharedStatic>
+__m256d load_static_pd(const std::vector<double> &column, size_t index)
+{
+    if constexpr (SharedStatic) return _mm256_set1_pd(column.front());
+    return _mm256_loadu_pd(column.data() + index);
+}
+
+
+/**
+ * @brief Load values of an unsigned 32-bit static parameter for `blifat_columns_lane_count<double>` neurons as 64-bit
+ * values.
+ * @tparam SharedStatic `true` if the column contains a single value shared by all neurons.
+ * @param column parameter column.
+ * @param index index of the first neuron.
+ * @return parameter values.
+ */
+template <bool SharedStatic>
+__m256i load_static_epu32(const std::vector<unsigned> &column, size_t index)
+{
+    if constexpr (SharedStatic) return _mm256_set1_epi64x(column.front());
+    return _mm256_cvtepu32_epi64(_mm_loadu_si128(reinterpret_cast<const __m128i *>(column.data() + index)));
+}
+
+
+/**
+ * @brief Load values of a single-precision static parameter for `blifat_columns_lane_count<float>` neurons.
+ * @tparam SharedStatic `true` if the column contains a single value shared by all neurons.
+ * @param column parameter column.
+ * @param index index of the first neuron.
+ * @return parameter values.
+ */
+template <bool SharedStatic>
+__m256 load_static_ps(const std::vector<float> &column, size_t index)
+{
+    if constexpr (SharedStatic) return _mm256_set1_ps(column.front());
+    return _mm256_loadu_ps(column.data() + index);
+}
+
+
+/**
+ * @brief Count blocking periods of `blifat_columns_lane_count<double>` neurons towards zero.
+ * @details Positive periods are decreased. Negative periods are increased and set to maximum when they reach zero.
+ * Comparison masks have all bits set, so adding a mask subtracts 1 and subtracting a mask adds 1.
+ * @param blocking_data blocking periods of the neurons.
+ * @return mask of neurons which were blocked and keep potential changed by impacts, one 64-bit lane per neuron.
+ */
+inline __m256i update_blocking_periods(int64_t *blocking_data)
+{
+    auto *data = reinterpret_cast<__m256i *>(blocking_data);
+    __m256i blocking = _mm256_loadu_si256(data);
+    const __m256i zero = _mm256_setzero_si256();
+    const __m256i is_blocked = _mm256_cmpgt_epi64(blocking, zero);
+    const __m256i was_negative = _mm256_cmpgt_epi64(zero, blocking);
+    blocking = _mm256_sub_epi64(_mm256_add_epi64(blocking, is_blocked), was_negative);
+    blocking = _mm256_blendv_epi8(
+        blocking, _mm256_set1_epi64x(std::numeric_limits<int64_t>::max()),
+        _mm256_and_si256(was_negative, _mm256_cmpeq_epi64(blocking, zero)));
+    _mm256_storeu_si256(data, blocking);
+    return is_blocked;
+}
+
+
+/**
+ * @brief Check if step counters of `blifat_columns_lane_count<double>` neurons exceed their refractory periods.
+ * @details AVX2 has no unsigned 64-bit comparison, so values are compared with flipped sign bits.
+ * @param n_steps step counters of the neurons.
+ * @param refractory_period refractory periods of the neurons.
+ * @return mask of neurons which can spike, one 64-bit lane per neuron.
+ */
+inline __m256i compare_refractory_periods(__m256i n_steps, __m256i refractory_period)
+{
+    const __m256i sign_bit = _mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+    return _mm256_cmpgt_epi64(_mm256_xor_si256(n_steps, sign_bit), _mm256_xor_si256(refractory_period, sign_bit));
+}
+
+
+/**
+ * @brief Pack two masks with 64-bit lanes into a mask with 32-bit lanes.
+ * @param low mask of the first `blifat_columns_lane_count<double>` neurons.
+ * @param high mask of the next `blifat_columns_lane_count<double>` neurons.
+ * @return mask of `blifat_columns_lane_count<float>` neurons.
+ */
+inline __m256i pack_mask_epi64(__m256i low, __m256i high)
+{
+    const __m256i even_lanes = _mm256_setr_epi32(0, 2, 4, 6, 0, 2, 4, 6);
+    return _mm256_permute2x128_si256(
+        _mm256_permutevar8x32_epi32(low, even_lanes), _mm256_permutevar8x32_epi32(high, even_lanes), 0x20);
+}
+
+
+/**
+ * @brief Calculate states of neurons before impacts using AVX2.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<double>` neurons.
+ */
+template <bool SharedStatic>
+void calculate_column_neurons_state_simd(BLIFATColumns<double> &columns, size_t index)
+{
+    static_assert(sizeof(columns.n_time_steps_since_last_firing_[0]) == sizeof(int64_t));
+
+    auto *n_steps = reinterpret_cast<__m256i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    _mm256_storeu_si256(n_steps, _mm256_add_epi64(_mm256_loadu_si256(n_steps), _mm256_set1_epi64x(1)));
+
+    auto decay = [index](std::vector<double> &values, const std::vector<double> &factors)
+    {
+        _mm256_storeu_pd(
+            values.data() + index,
+            _mm256_mul_pd(_mm256_loadu_pd(values.data() + index), load_static_pd<SharedStatic>(factors, index)));
+    };
+    decay(columns.dynamic_threshold_, columns.threshold_decay_);
+    decay(columns.postsynaptic_trace_, columns.postsynaptic_trace_decay_);
+    decay(columns.inhibitory_conductance_, columns.inhibitory_conductance_decay_);
+
+    // Bursting: decrease non-zero phases, add reflexive weight to neurons whose phase becomes zero.
+    auto *phase_data = reinterpret_cast<__m128i *>(columns.bursting_phase_.data() + index);
+    const __m128i phase = _mm_loadu_si128(phase_data);
+    const __m128i is_idle = _mm_cmpeq_epi32(phase, _mm_setzero_si128());
+    const __m128i burst = _mm_cmpeq_epi32(phase, _mm_set1_epi32(1));
+    // Adding all ones subtracts 1 from non-zero phases.
+    _mm_storeu_si128(phase_data, _mm_add_epi32(phase, _mm_andnot_si128(is_idle, _mm_set1_epi32(-1))));
+
+    const __m256d decayed_potential = _mm256_mul_pd(
+        _mm256_loadu_pd(columns.potential_.data() + index),
+        load_static_pd<SharedStatic>(columns.potential_decay_, index));
+    const __m256d potential = _mm256_blendv_pd(
+        decayed_potential,
+        _mm256_add_pd(decayed_potential, load_static_pd<SharedStatic>(columns.reflexive_weight_, index)),
+        _mm256_castsi256_pd(_mm256_cvtepi32_epi64(burst)));
+    _mm256_storeu_pd(columns.potential_.data() + index, potential);
+    _mm256_storeu_pd(columns.pre_impact_potential_.data() + index, potential);
+}
+
+
+/**
+ * @brief Calculate states of neurons after impacts using AVX2.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<double>` neurons.
+ * @return bit mask of spiked neurons.
+ */
+template <bool SharedStatic>
+unsigned calculate_column_neurons_post_input_state_simd(BLIFATColumns<double> &columns, size_t index)
+{
+    // Blocking period: restore pre-impact potential of non-blocked neurons, count blocking periods towards zero.
+    const __m256i is_blocked = update_blocking_periods(columns.total_blocking_period_.data() + index);
+    __m256d potential = _mm256_blendv_pd(
+        _mm256_loadu_pd(columns.pre_impact_potential_.data() + index),
+        _mm256_loadu_pd(columns.potential_.data() + index), _mm256_castsi256_pd(is_blocked));
+
+    // Inhibitory conductance.
+    const __m256d conductance = _mm256_loadu_pd(columns.inhibitory_conductance_.data() + index);
+    const __m256d reversal = load_static_pd<SharedStatic>(columns.reversal_inhibitory_potential_, index);
+    potential = _mm256_blendv_pd(
+        reversal, _mm256_sub_pd(potential, _mm256_mul_pd(_mm256_sub_pd(potential, reversal), conductance)),
+        _mm256_cmp_pd(conductance, _mm256_set1_pd(1.0), _CMP_LT_OQ));
+
+    // Spike detection.
+    auto *n_steps_data = reinterpret_cast<__m256i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    const __m256i n_steps = _mm256_loadu_si256(n_steps_data);
+    const __m256i is_ready = compare_refractory_periods(
+        n_steps, load_static_epu32<SharedStatic>(columns.absolute_refractory_period_, index));
+    __m256d dynamic_threshold = _mm256_loadu_pd(columns.dynamic_threshold_.data() + index);
+    const __m256d spike = _mm256_and_pd(
+        _mm256_castsi256_pd(is_ready),
+        _mm256_cmp_pd(
+            potential,
+            _mm256_add_pd(load_static_pd<SharedStatic>(columns.activation_threshold_, index), dynamic_threshold),
+            _CMP_GE_OQ));
+
+    dynamic_threshold = _mm256_blendv_pd(
+        dynamic_threshold,
+        _mm256_add_pd(dynamic_threshold, load_static_pd<SharedStatic>(columns.threshold_increment_, index)), spike);
+    _mm256_storeu_pd(columns.dynamic_threshold_.data() + index, dynamic_threshold);
+    const __m256d trace = _mm256_loadu_pd(columns.postsynaptic_trace_.data() + index);
+    _mm256_storeu_pd(
+        columns.postsynaptic_trace_.data() + index,
+        _mm256_blendv_pd(
+            trace, _mm256_add_pd(trace, load_static_pd<SharedStatic>(columns.postsynaptic_trace_increment_, index)),
+            spike));
+    potential = _mm256_blendv_pd(potential, load_static_pd<SharedStatic>(columns.potential_reset_value_, index), spike);
+    _mm256_storeu_si256(n_steps_data, _mm256_andnot_si256(_mm256_castpd_si256(spike), n_steps));
+
+    // Minimal potential.
+    const __m256d min_potential = load_static_pd<SharedStatic>(columns.min_potential_, index);
+    potential = _mm256_blendv_pd(potential, min_potential, _mm256_cmp_pd(potential, min_potential, _CMP_LT_OQ));
+    _mm256_storeu_pd(columns.potential_.data() + index, potential);
+
+    return static_cast<unsigned>(_mm256_movemask_pd(spike));
+}
+
+/**
+ * @brief Calculate states of single-precision neurons before impacts using AVX2.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<float>` neurons.
+ */
+template <bool SharedStatic>
+void calculate_column_neurons_state_simd(BLIFATColumns<float> &columns, size_t index)
+{
+    static_assert(sizeof(columns.n_time_steps_since_last_firing_[0]) == sizeof(int64_t));
+
+    // 64-bit step counters of the neurons take two vectors.
+    auto *n_steps = reinterpret_cast<__m256i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    _mm256_storeu_si256(n_steps, _mm256_add_epi64(_mm256_loadu_si256(n_steps), _mm256_set1_epi64x(1)));
+    _mm256_storeu_si256(n_steps + 1, _mm256_add_epi64(_mm256_loadu_si256(n_steps + 1), _mm256_set1_epi64x(1)));
+
+    auto decay = [index](std::vector<float> &values, const std::vector<float> &factors)
+    {
+        _mm256_storeu_ps(
+            values.data() + index,
+            _mm256_mul_ps(_mm256_loadu_ps(values.data() + index), load_static_ps<SharedStatic>(factors, index)));
+    };
+    decay(columns.dynamic_threshold_, columns.threshold_decay_);
+    decay(columns.postsynaptic_trace_, columns.postsynaptic_trace_decay_);
+    decay(columns.inhibitory_conductance_, columns.inhibitory_conductance_decay_);
+
+    // Bursting: decrease non-zero phases, add reflexive weight to neurons whose phase becomes zero.
+    auto *phase_data = reinterpret_cast<__m256i *>(columns.bursting_phase_.data() + index);
+    const __m256i phase = _mm256_loadu_si256(phase_data);
+    const __m256i is_idle = _mm256_cmpeq_epi32(phase, _mm256_setzero_si256());
+    const __m256i burst = _mm256_cmpeq_epi32(phase, _mm256_set1_epi32(1));
+    // Adding all ones subtracts 1 from non-zero phases.
+    _mm256_storeu_si256(phase_data, _mm256_add_epi32(phase, _mm256_andnot_si256(is_idle, _mm256_set1_epi32(-1))));
+
+    const __m256 decayed_potential = _mm256_mul_ps(
+        _mm256_loadu_ps(columns.potential_.data() + index),
+        load_static_ps<SharedStatic>(columns.potential_decay_, index));
+    const __m256 potential = _mm256_blendv_ps(
+        decayed_potential,
+        _mm256_add_ps(decayed_potential, load_static_ps<SharedStatic>(columns.reflexive_weight_, index)),
+        _mm256_castsi256_ps(burst));
+    _mm256_storeu_ps(columns.potential_.data() + index, potential);
+    _mm256_storeu_ps(columns.pre_impact_potential_.data() + index, potential);
+}
+
+
+/**
+ * @brief Calculate states of single-precision neurons after impacts using AVX2.
+ * @tparam SharedStatic `true` if static parameters are shared by all neurons.
+ * @param columns neuron parameter columns.
+ * @param index index of the first of `blifat_columns_lane_count<float>` neurons.
+ * @return bit mask of spiked neurons.
+ */
+template <bool SharedStatic>
+unsigned calculate_column_neurons_post_input_state_simd(BLIFATColumns<float> &columns, size_t index)
+{
+    // 64-bit blocking periods and step counters of the neurons take two vectors, their masks are packed.
+    constexpr size_t half = blifat_columns_lane_count<double>;
+
+    // Blocking period: restore pre-impact potential of non-blocked neurons, count blocking periods towards zero.
+    auto *blocking_data = columns.total_blocking_period_.data() + index;
+    const __m256i is_blocked =
+        pack_mask_epi64(update_blocking_periods(blocking_data), update_blocking_periods(blocking_data + half));
+    __m256 potential = _mm256_blendv_ps(
+        _mm256_loadu_ps(columns.pre_impact_potential_.data() + index),
+        _mm256_loadu_ps(columns.potential_.data() + index), _mm256_castsi256_ps(is_blocked));
+
+    // Inhibitory conductance.
+    const __m256 conductance = _mm256_loadu_ps(columns.inhibitory_conductance_.data() + index);
+    const __m256 reversal = load_static_ps<SharedStatic>(columns.reversal_inhibitory_potential_, index);
+    potential = _mm256_blendv_ps(
+        reversal, _mm256_sub_ps(potential, _mm256_mul_ps(_mm256_sub_ps(potential, reversal), conductance)),
+        _mm256_cmp_ps(conductance, _mm256_set1_ps(1.0F), _CMP_LT_OQ));
+
+    // Spike detection.
+    auto *n_steps_data = reinterpret_cast<__m256i *>(columns.n_time_steps_since_last_firing_.data() + index);
+    const __m256i n_steps_low = _mm256_loadu_si256(n_steps_data);
+    const __m256i n_steps_high = _mm256_loadu_si256(n_steps_data + 1);
+    const auto &refractory_period = columns.absolute_refractory_period_;
+    const __m256i is_ready = pack_mask_epi64(
+        compare_refractory_periods(n_steps_low, load_static_epu32<SharedStatic>(refractory_period, index)),
+        compare_refractory_periods(n_steps_high, load_static_epu32<SharedStatic>(refractory_period, index + half)));
+    __m256 dynamic_threshold = _mm256_loadu_ps(columns.dynamic_threshold_.data() + index);
+    const __m256 spike = _mm256_and_ps(
+        _mm256_castsi256_ps(is_ready),
+        _mm256_cmp_ps(
+            potential,
+            _mm256_add_ps(load_static_ps<SharedStatic>(columns.activation_threshold_, index), dynamic_threshold),
+            _CMP_GE_OQ));
+
+    dynamic_threshold = _mm256_blendv_ps(
+        dynamic_threshold,
+        _mm256_add_ps(dynamic_threshold, load_static_ps<SharedStatic>(columns.threshold_increment_, index)), spike);
+    _mm256_storeu_ps(columns.dynamic_threshold_.data() + index, dynamic_threshold);
+    const __m256 trace = _mm256_loadu_ps(columns.postsynaptic_trace_.data() + index);
+    _mm256_storeu_ps(
+        columns.postsynaptic_trace_.data() + index,
+        _mm256_blendv_ps(
+            trace, _mm256_add_ps(trace, load_static_ps<SharedStatic>(columns.postsynaptic_trace_increment_, index)),
+            spike));
+    potential = _mm256_blendv_ps(potential, load_static_ps<SharedStatic>(columns.potential_reset_value_, index), spike);
+    // Spike mask lanes are sign-extended to 64 bits to reset step counters.
+    const __m256i spike_mask = _mm256_castps_si256(spike);
+    _mm256_storeu_si256(
+        n_steps_data, _mm256_andnot_si256(_mm256_cvtepi32_epi64(_mm256_castsi256_si128(spike_mask)), n_steps_low));
+    _mm256_storeu_si256(
+        n_steps_data + 1,
+        _mm256_andnot_si256(_mm256_cvtepi32_epi64(_mm256_extracti128_si256(spike_mask, 1)), n_steps_high));
+
+    // Minimal potential.
+    const __m256 min_potential = load_static_ps<SharedStatic>(columns.min_potential_, index);
+    potential = _mm256_blendv_ps(potential, min_potential, _mm256_cmp_ps(potential, min_potential, _CMP_LT_OQ));
+    _mm256_storeu_ps(columns.potential_.data() + index, potential);
+
+    return static_cast<unsigned>(_mm256_movemask_ps(spike));
+}
+
+#endif
+
+
+/**
+ * @brief Partially calculate neuron states before impacts.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index past the last neuron to calculate.
+ */
+template <class Real>
+void calculate_column_neurons_state_part(BLIFATColumns<Real> &columns, size_t part_start, size_t part_end)
+{
+    size_t index = part_start;
+#if defined(KNP_ENABLE_AVX) && (defined(__AVX512F__) || defined(__AVX2__))
+    const bool shared_static = columns.has_shared_static_parameters();
+    for (; index + blifat_columns_lane_count<Real> <= part_end; index += blifat_columns_lane_count<Real>)
+    {
+        if (shared_static)
+            calculate_column_neurons_state_simd<true>(columns, index);
+        else
+            calculate_column_neurons_state_simd<false>(columns, index);
+    }
+#endif
+    for (; index < part_end; ++index)
+    {
+        calculate_column_neuron_state(columns, index);
+    }
+}
+
+
+/**
+ * @brief Partially calculate neuron states after impacts.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param neuron_indexes output container, indexes of spiked neurons are appended to it in ascending order.
+ * @param part_start index of the first neuron to calculate.
+ * @param part_end index past the last neuron to calculate.
+ */
+template <class Real>
+void calculate_column_neurons_post_input_state_part(
+    BLIFATColumns<Real> &columns, knp::core::messaging::SpikeData &neuron_indexes, size_t part_start, size_t part_end)
+{
+    size_t index = part_start;
+#if defined(KNP_ENABLE_AVX) && (defined(__AVX512F__) || defined(__AVX2__))
+    const bool shared_static = columns.has_shared_static_parameters();
+    for (; index + blifat_columns_lane_count<Real> <= part_end; index += blifat_columns_lane_count<Real>)
+    {
+        const unsigned spike_mask = shared_static
+                                        ? calculate_column_neurons_post_input_state_simd<true>(columns, index)
+                                        : calculate_column_neurons_post_input_state_simd<false>(columns, index);
+        // Spikes are rare, so bursting phases of spiked neurons are set here instead of the vectorized routine.
+        for (unsigned spikes = spike_mask; spikes; spikes &= spikes - 1)
+        {
+            const size_t neuron_index = index + __builtin_ctz(spikes);
+            columns.bursting_phase_[neuron_index] =
+                columns.bursting_period_[columns.get_static_index(neuron_index)];
+            neuron_indexes.push_back(neuron_index);
+        }
+    }
+#endif
+    for (; index < part_end; ++index)
+    {
+        if (calculate_column_neuron_post_input_state(columns, index)) neuron_indexes.push_back(index);
+    }
+}
+
+
+/**
+ * @brief Calculate a step of a population stored in columns in lazy update mode.
+ * @details Only active neurons and neurons that receive impacts are calculated, so the step cost depends on the number
+ * of impacts instead of the population size if most neurons are quiescent. Lazy update mode is enabled if needed.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @param columns neuron parameter columns.
+ * @param messages synaptic impact messages sent to the population.
+ * @param neuron_indexes output parameter, indexes of spiked neurons sorted in ascending order.
+ */
+template <class Real>
+void calculate_lazy_column_neurons(
+    BLIFATColumns<Real> &columns, const SharedImpactMessages &messages, knp::core::messaging::SpikeData &neuron_indexes)
+{
+    if (!columns.is_lazy_update_enabled()) columns.enable_lazy_update();
+    for (const auto &message : messages)
+    {
+        for (const auto &impact : message->impacts_) columns.activate_neuron(impact.postsynaptic_neuron_index_);
+    }
+
+    const auto &active_neurons = columns.start_lazy_step();
+    for (const auto index : active_neurons) calculate_column_neuron_state(columns, index);
+    process_column_inputs(columns, messages);
+    for (const auto index : active_neurons)
+    {
+        if (calculate_column_neuron_post_input_state(columns, index)) neuron_indexes.push_back(index);
+    }
+    columns.finish_lazy_step();
+}
+
+}  // namespace knp::backends::cpu
@@ -29,13 +29,13 @@
 
 #include <algorithm>
 #include <limits>
-#include <mutex>
 #include <optional>
 #include <queue>
 #include <string>
 #include <utility>
 #include <vector>
 
+#include "blifat_columns_impl.h"
 #include "synaptic_resource_stdp_impl.h"
 
 /**
@@ -57,22 +57,21 @@ constexpr bool has_dopamine_plasticity<neuron_traits::SynapticResourceSTDPBLIFAT
 
 
 /**
- * @brief Apply STDP to all presynaptic connections of a single population.
- * @tparam NeuronType type of neuron that is compatible with STDP.
- * @param msg spikes emited by population.
- * @param working_projections all projections. The function skips projections that are not connected, locked or are of a
- * wrong type.
- * @param population population.
- * @param step current network step.
- * @note All projections are supposed to be of the same type.
+ * @brief Prepare neuron columns of a population for calculation of all neurons at every step.
+ * @details Lazy update mode is disabled, as routines that calculate all neurons at every step don't support it.
+ * Calculation routines prepare columns themselves, but disabling lazy update mode is not thread-safe. Call this
+ * function before processing parts of the population in parallel.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
+ * @param population population to switch.
  */
-template <class NeuronType>
-void process_spiking_neurons(
-    const core::messaging::SpikeMessage &msg,
-    std::vector<knp::core::Projection<
-        knp::synapse_traits::STDP<knp::synapse_traits::STDPSynapticResourceRule, synapse_traits::DeltaSynapse>> *>
-        &working_projections,
-    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step);
+template <class BlifatLikeNeuron>
+void prepare_neuron_columns(knp::core::Population<BlifatLikeNeuron> &population)
+{
+    if constexpr (neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>)
+    {
+        population.get_neuron_columns().disable_lazy_update();
+    }
+}
 
 
 /**
@@ -113,25 +112,131 @@ void impact_neuron(
  * @brief Process messages sent to the current population.
  * @param population population to update.
  * @param messages synaptic impact messages sent to the population.
+ * @param dopamine_neurons if not `nullptr`, neurons that receive dopamine impacts are added to the set.
  * @note The method is used for parallelization. See later if this method serves as a bottleneck.
  */
 template <class BlifatLikeNeuron>
 void process_inputs(
     knp::core::Population<BlifatLikeNeuron> &population,
-    const std::vector<core::messaging::SynapticImpactMessage> &messages)
+    const SharedImpactMessages &messages, NeuronIndexSet *dopamine_neurons = nullptr)
 {
     SPDLOG_TRACE("Process inputs.");
-    for (const auto &message : messages)
+    if constexpr (neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>)
+    {
+        process_column_inputs(population.get_neuron_columns(), messages);
+    }
+    else
+    {
+        for (const auto &message : messages)
+        {
+            for (const auto &impact : message->impacts_)
+            {
+                auto &neuron = population[impact.postsynaptic_neuron_index_];
+                impact_neuron<BlifatLikeNeuron>(neuron, impact.synapse_type_, impact.impact_value_);
+                if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
+                {
+                    if (impact.synapse_type_ == synapse_traits::OutputType::EXCITATORY)
+                    {
+                        neuron.is_being_forced_ |= message->is_forcing_;
+                    }
+                    else if (impact.synapse_type_ == synapse_traits::OutputType::DOPAMINE && dopamine_neurons)
+                    {
+                        dopamine_neurons->insert(impact.postsynaptic_neuron_index_);
+                    }
+                }
+            }
+        }
+    }
+}
+
+
+/**
+ * @brief Impacts of a message part grouped by ranges of postsynaptic neurons.
+ * @details Impacts of each range keep their message order, so applying ranges in parallel gives the same result as
+ * applying the message sequentially.
+ */
+struct ImpactBuckets
+{
+    /**
+     * @brief Message that contains the impacts.
+     */
+    const core::messaging::SynapticImpactMessage *message_;
+
+    /**
+     * @brief Index of the first message impact in the part.
+     */
+    size_t impact_begin_;
+
+    /**
+     * @brief Index of the message impact following the last impact in the part.
+     */
+    size_t impact_end_;
+
+    /**
+     * @brief Part impacts, one bucket per range of postsynaptic neurons.
+     */
+    std::vector<std::vector<const core::messaging::SynapticImpact *>> buckets_;
+};
+
+
+/**
+ * @brief Group impacts of a message part by ranges of postsynaptic neurons.
+ * @param impact_buckets message part with a bucket for each neuron range.
+ * @param range_size number of neurons in a range.
+ * @note The method is used for parallelization. Different message parts can be grouped concurrently.
+ */
+inline void fill_impact_buckets(ImpactBuckets &impact_buckets, size_t range_size)
+{
+    const auto &impacts = impact_buckets.message_->impacts_;
+    for (size_t index = impact_buckets.impact_begin_; index < impact_buckets.impact_end_; ++index)
+    {
+        const auto &impact = impacts[index];
+        impact_buckets.buckets_[impact.postsynaptic_neuron_index_ / range_size].push_back(&impact);
+    }
+}
+
+
+/**
+ * @brief Apply impacts to a range of population neurons.
+ * @param population population to update.
+ * @param message_parts message parts with impacts grouped by neuron ranges, in message order.
+ * @param range_index index of the neuron range to update.
+ * @param dopamine_neurons if not `nullptr`, output container of neurons that receive dopamine impacts. The container is
+ * cleared before processing and can contain repeated indexes.
+ * @note The method is used for parallelization. Different ranges can be updated concurrently if the population has
+ * already been prepared by `prepare_neuron_columns()`.
+ */
+template <class BlifatLikeNeuron>
+void process_inputs_part(
+    knp::core::Population<BlifatLikeNeuron> &population, const std::vector<ImpactBuckets> &message_parts,
+    size_t range_index, std::vector<size_t> *dopamine_neurons = nullptr)
+{
+    SPDLOG_TRACE("Process inputs part.");
+    if (dopamine_neurons) dopamine_neurons->clear();
+    for (const auto &message_part : message_parts)
     {
-        for (const auto &impact : message.impacts_)
+        for (const auto *impact : message_part.buckets_[range_index])
         {
-            auto &neuron = population[impact.postsynaptic_neuron_index_];
-            impact_neuron<BlifatLikeNeuron>(neuron, impact.synapse_type_, impact.impact_value_);
-            if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
+            if constexpr (neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>)
             {
-                if (impact.synapse_type_ == synapse_traits::OutputType::EXCITATORY)
+                impact_column_neuron(
+                    population.get_neuron_columns(), impact->postsynaptic_neuron_index_, impact->synapse_type_,
+                    impact->impact_value_);
+            }
+            else
+            {
+                auto &neuron = population[impact->postsynaptic_neuron_index_];
+                impact_neuron<BlifatLikeNeuron>(neuron, impact->synapse_type_, impact->impact_value_);
+                if constexpr (has_dopamine_plasticity<BlifatLikeNeuron>())
                 {
-                    neuron.is_being_forced_ |= message.is_forcing_;
+                    if (impact->synapse_type_ == synapse_traits::OutputType::EXCITATORY)
+                    {
+                        neuron.is_being_forced_ |= message_part.message_->is_forcing_;
+                    }
+                    else if (impact->synapse_type_ == synapse_traits::OutputType::DOPAMINE && dopamine_neurons)
+                    {
+                        dopamine_neurons->push_back(impact->postsynaptic_neuron_index_);
+                    }
                 }
             }
         }
@@ -181,11 +286,18 @@ void calculate_neurons_state_part(
 {
     size_t part_end = std::min(part_start + part_size, population.size());
     SPDLOG_TRACE("Calculate neuron state part.");
-    for (size_t i = part_start; i < part_end; ++i)
+    if constexpr (neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>)
     {
-        auto &neuron = population[i];
-        ++neuron.n_time_steps_since_last_firing_;
-        calculate_single_neuron_state<BlifatLikeNeuron>(neuron);
+        calculate_column_neurons_state_part(population.get_neuron_columns(), part_start, part_end);
+    }
+    else
+    {
+        for (size_t i = part_start; i < part_end; ++i)
+        {
+            auto &neuron = population[i];
+            ++neuron.n_time_steps_since_last_firing_;
+            calculate_single_neuron_state<BlifatLikeNeuron>(neuron);
+        }
     }
 }
 
@@ -195,14 +307,15 @@ void calculate_neurons_state_part(
  * @tparam BlifatLikeNeuron type of neuron which inference can be calculated as for a BLIFAT neuron.
  * @param population neurons population.
  * @param messages messages from the projection to the populations.
+ * @param dopamine_neurons if not `nullptr`, neurons that receive dopamine impacts are added to the set.
  */
 template <class BlifatLikeNeuron>
 void calculate_neurons_state(
     knp::core::Population<BlifatLikeNeuron> &population,
-    const std::vector<core::messaging::SynapticImpactMessage> &messages)
+    const SharedImpactMessages &messages, NeuronIndexSet *dopamine_neurons = nullptr)
 {
     calculate_neurons_state_part(population, 0, population.size());
-    process_inputs(population, messages);
+    process_inputs(population, messages, dopamine_neurons);
 }
 
 
@@ -271,11 +384,19 @@ void calculate_neurons_post_input_state(
     knp::core::Population<BlifatLikeNeuron> &population, knp::core::messaging::SpikeData &neuron_indexes)
 {
     SPDLOG_TRACE("Calculate neuron post-input state part.");
-    for (size_t index = 0; index < population.size(); ++index)
+    if constexpr (neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>)
     {
-        if (calculate_neuron_post_input_state<BlifatLikeNeuron>(population[index]))
+        calculate_column_neurons_post_input_state_part(
+            population.get_neuron_columns(), neuron_indexes, 0, population.size());
+    }
+    else
+    {
+        for (size_t index = 0; index < population.size(); ++index)
         {
-            neuron_indexes.push_back(index);
+            if (calculate_neuron_post_input_state<BlifatLikeNeuron>(population[index]))
+            {
+                neuron_indexes.push_back(index);
+            }
         }
     }
 }
@@ -284,32 +405,36 @@ void calculate_neurons_post_input_state(
 /**
  * @brief Partially calculate population after it receives synaptic impact messages.
  * @param population population to update.
- * @param message output spike message to update.
+ * @param neuron_indexes output container of spiked neuron indexes sorted in ascending order. The container is
+ * cleared before the calculation.
  * @param part_start index of the first neuron to update.
  * @param part_size number of neurons to calculate in a single call.
- * @param mutex mutex that is locked to update a message.
- * @note This method is used for parallelization.
+ * @note This method is used for parallelization. It doesn't modify shared data, so parts can be processed
+ * concurrently if each part has its own output container.
  */
 template <class BlifatLikeNeuron>
 void calculate_neurons_post_input_state_part(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::messaging::SpikeMessage &message, size_t part_start,
-    size_t part_size, std::mutex &mutex)
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::messaging::SpikeData &neuron_indexes,
+    size_t part_start, size_t part_size)
 {
     SPDLOG_TRACE("Calculate neuron post-input state part.");
     size_t part_end = std::min(part_start + part_size, population.size());
-    std::vector<size_t> output;
-    for (size_t i = part_start; i < part_end; ++i)
+    neuron_indexes.clear();
+    if constexpr (neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>)
     {
-        if (calculate_neuron_post_input_state<BlifatLikeNeuron>(population[i]))
+        calculate_column_neurons_post_input_state_part(
+            population.get_neuron_columns(), neuron_indexes, part_start, part_end);
+    }
+    else
+    {
+        for (size_t i = part_start; i < part_end; ++i)
         {
-            output.push_back(i);
+            if (calculate_neuron_post_input_state<BlifatLikeNeuron>(population[i]))
+            {
+                neuron_indexes.push_back(i);
+            }
         }
     }
-
-    // Updating common neuron indexes.
-    const std::lock_guard<std::mutex> lock(mutex);
-    message.neuron_indexes_.reserve(message.neuron_indexes_.size() + output.size());
-    message.neuron_indexes_.insert(message.neuron_indexes_.end(), output.begin(), output.end());
 }
 
 
@@ -318,18 +443,20 @@ void calculate_neurons_post_input_state_part(
  * @tparam BlifatLikeNeuron type of neuron which inference can be calculated the same as BLIFAT.
  * @param population population of BLIFAT-like neurons.
  * @param endpoint message endpoint.
+ * @param dopamine_neurons if not `nullptr`, neurons that receive dopamine impacts are added to the set.
  * @return indexes of spiked neurons.
  */
 template <class BlifatLikeNeuron>
 knp::core::messaging::SpikeData calculate_blifat_population_data(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint)
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint,
+    NeuronIndexSet *dopamine_neurons = nullptr)
 {
     SPDLOG_DEBUG("Calculating BLIFAT population {}...", std::string{population.get_uid()});
     // This whole function might be optimizable if we find a way to not loop over the whole population.
-    std::vector<core::messaging::SynapticImpactMessage> messages =
-        endpoint.unload_messages<core::messaging::SynapticImpactMessage>(population.get_uid());
+    const auto messages = endpoint.unload_shared_messages<core::messaging::SynapticImpactMessage>(population.get_uid());
 
-    calculate_neurons_state(population, messages);
+    prepare_neuron_columns(population);
+    calculate_neurons_state(population, messages, dopamine_neurons);
     knp::core::messaging::SpikeData neuron_indexes;
     calculate_neurons_post_input_state(population, neuron_indexes);
 
@@ -337,46 +464,46 @@ knp::core::messaging::SpikeData calculate_blifat_population_data(
 }
 
 
+/**
+ * @brief Process BLIFAT neuron population in lazy update mode and return spiked neuron indexes.
+ * @details Only neurons that are active or receive impacts are calculated. See `neuron_traits::neuron_columns`
+ * specialization for the neuron type for the description of lazy update mode.
+ * @tparam BlifatLikeNeuron type of neuron which inference can be calculated the same as BLIFAT.
+ * @param population population of BLIFAT-like neurons stored in columns.
+ * @param endpoint message endpoint.
+ * @return indexes of spiked neurons.
+ */
 template <class BlifatLikeNeuron>
-std::optional<core::messaging::SpikeMessage> calculate_blifat_population_impl(
-    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n)
+knp::core::messaging::SpikeData calculate_lazy_blifat_population_data(
+    knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint)
 {
-    auto neuron_indexes{calculate_blifat_population_data(population, endpoint)};
-    std::optional<knp::core::messaging::SpikeMessage> message_opt = {};
-    if (!neuron_indexes.empty())
-    {
-        knp::core::messaging::SpikeMessage res_message{{population.get_uid(), step_n}, neuron_indexes};
-        endpoint.send_message(res_message);
-        SPDLOG_DEBUG("Sent {} spike(s).", res_message.neuron_indexes_.size());
-        message_opt = std::move(res_message);
-    }
-    return message_opt;
+    static_assert(
+        neuron_traits::has_neuron_columns_v<BlifatLikeNeuron>, "Lazy update mode requires neuron column storage.");
+    SPDLOG_DEBUG("Calculating BLIFAT population {} in lazy update mode...", std::string{population.get_uid()});
+    const auto messages = endpoint.unload_shared_messages<core::messaging::SynapticImpactMessage>(population.get_uid());
+
+    knp::core::messaging::SpikeData neuron_indexes;
+    calculate_lazy_column_neurons(population.get_neuron_columns(), messages, neuron_indexes);
+    return neuron_indexes;
 }
 
 
-/**
- * @brief Make one execution step for a population of BLIFAT neurons.
- * @param population population to update.
- * @param endpoint message endpoint used for message exchange.
- * @param step_n execution step.
- * @param mutex mutex.
- * @return indexes of spiked neurons.
- */
 template <class BlifatLikeNeuron>
-std::optional<knp::core::messaging::SpikeMessage> calculate_blifat_population_impl(
+std::optional<core::messaging::SpikeMessage> calculate_blifat_population_impl(
     knp::core::Population<BlifatLikeNeuron> &population, knp::core::MessageEndpoint &endpoint, size_t step_n,
-    std::mutex &mutex)
+    NeuronIndexSet *dopamine_neurons = nullptr)
 {
-    auto neuron_indexes{calculate_blifat_population_data(population, endpoint)};
+    auto neuron_indexes{calculate_blifat_population_data(population, endpoint, dopamine_neurons)};
+    std::optional<knp::core::messaging::SpikeMessage> message_opt = {};
     if (!neuron_indexes.empty())
     {
-        knp::core::messaging::SpikeMessage res_message{{population.get_uid(), step_n}, neuron_indexes};
-        const std::lock_guard<std::mutex> guard(mutex);
-        endpoint.send_message(res_message);
-        SPDLOG_DEBUG("Sent {} spike(s).", res_message.neuron_indexes_.size());
-        return res_message;
+        message_opt.emplace(
+            knp::core::messaging::SpikeMessage{{population.get_uid(), step_n}, std::move(neuron_indexes)});
+        // The message is returned to the caller, so the message bus gets its only copy.
+        endpoint.send_message(knp::core::messaging::MessageVariant(*message_opt));
+        SPDLOG_DEBUG("Sent {} spike(s).", message_opt->neuron_indexes_.size());
     }
-    return {};
+    return message_opt;
 }
 
 }  // namespace knp::backends::cpu
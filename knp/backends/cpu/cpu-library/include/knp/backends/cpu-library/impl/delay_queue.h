@@ -0,0 +1,152 @@
+/**
+ * @file delay_queue.h
+ * @brief Circular buffer of delayed synaptic impacts.
+ * @kaspersky_support Artiom N.
+ * @date 17.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/core/messaging/synaptic_impact_message.h>
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+/**
+ * @brief Fixed-size circular buffer of synaptic impacts that will be sent on future steps.
+ * @details The buffer contains a slot for each of the following steps. Slots keep their memory after they are cleared,
+ * so after the buffer warms up, adding impacts doesn't allocate memory. The buffer length must be greater than the
+ * maximum synapse delay, otherwise the buffer grows when an impact with a larger delay is added.
+ */
+class DelayQueue
+{
+public:
+    /**
+     * @brief Type of the impact container stored in a single slot.
+     */
+    using Impacts = std::vector<knp::core::messaging::SynapticImpact>;
+
+public:
+    /**
+     * @brief Create a delay queue for impacts with a delay of one step.
+     */
+    DelayQueue() : DelayQueue(1) {}
+
+    /**
+     * @brief Create a delay queue.
+     * @param max_delay maximum delay of the impacts to store. The queue length is `max_delay + 1`.
+     */
+    explicit DelayQueue(size_t max_delay) : slots_(max_delay + 1) {}
+
+public:
+    /**
+     * @brief Get the number of queue slots.
+     * @return queue length.
+     */
+    [[nodiscard]] size_t size() const { return slots_.size(); }
+
+    /**
+     * @brief Add an impact that will be sent on a future step.
+     * @param current_step current step. Impacts of the previous steps must be already sent and cleared.
+     * @param future_step step on which the impact will be sent.
+     * @param impact impact to add.
+     */
+    void push(uint64_t current_step, uint64_t future_step, const knp::core::messaging::SynapticImpact &impact)
+    {
+        if (future_step - current_step >= slots_.size())
+        {
+            resize(current_step, future_step - current_step + 1);
+        }
+        get_impacts(future_step).push_back(impact);
+    }
+
+    /**
+     * @brief Add impacts that will be sent on future steps.
+     * @details Impacts are added in the container order.
+     * @param current_step current step. Impacts of the previous steps must be already sent and cleared.
+     * @param impacts container of `{future step, impact}` pairs.
+     */
+    template <class DelayedImpactContainer>
+    void push(uint64_t current_step, const DelayedImpactContainer &impacts)
+    {
+        for (const auto &[future_step, impact] : impacts)
+        {
+            push(current_step, future_step, impact);
+        }
+    }
+
+    /**
+     * @brief Get impacts that will be sent on the given step.
+     * @param step step number.
+     * @return impacts of the step.
+     */
+    [[nodiscard]] Impacts &get_impacts(uint64_t step) { return slots_[step % slots_.size()]; }
+
+    /**
+     * @brief Get impacts that will be sent on the given step.
+     * @param step step number.
+     * @return impacts of the step.
+     */
+    [[nodiscard]] const Impacts &get_impacts(uint64_t step) const { return slots_[step % slots_.size()]; }
+
+    /**
+     * @brief Remove impacts of the given step without releasing slot memory.
+     * @param step step number.
+     */
+    void clear_step(uint64_t step) { get_impacts(step).clear(); }
+
+    /**
+     * @brief Increase the queue length.
+     * @param current_step current step. Impacts of the previous steps must be already sent and cleared.
+     * @param new_size new queue length. The length is not decreased.
+     */
+    void resize(uint64_t current_step, size_t new_size)
+    {
+        if (new_size <= slots_.size()) return;
+
+        std::vector<Impacts> new_slots(new_size);
+        for (uint64_t step = current_step; step < current_step + slots_.size(); ++step)
+        {
+            std::swap(new_slots[step % new_size], get_impacts(step));
+        }
+        slots_ = std::move(new_slots);
+    }
+
+private:
+    std::vector<Impacts> slots_;
+};
+
+
+/**
+ * @brief Type of the message queue.
+ */
+using MessageQueue = DelayQueue;
+
+
+/**
+ * @brief Type of the container of `{future step, impact}` pairs calculated by a single thread.
+ */
+using DelayedImpacts = std::vector<std::pair<uint64_t, knp::core::messaging::SynapticImpact>>;
+
+}  // namespace knp::backends::cpu
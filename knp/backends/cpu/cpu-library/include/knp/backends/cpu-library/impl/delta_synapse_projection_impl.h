@@ -28,12 +28,11 @@
 #include <spdlog/spdlog.h>
 
 #include <algorithm>
-#include <mutex>
-#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include "additive_stdp_impl.h"
+#include "delay_queue.h"
 
 
 /**
@@ -41,18 +40,6 @@
  */
 namespace knp::backends::cpu
 {
-/**
- * @brief Type of the message queue.
- */
-using MessageQueue = std::unordered_map<uint64_t, knp::core::messaging::SynapticImpactMessage>;
-
-
-template <class DeltaLikeSynapse>
-void calculate_projection_part_impl(
-    knp::core::Projection<DeltaLikeSynapse> &projection, const std::unordered_map<size_t, size_t> &message_in_data,
-    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex);
-
-
 template <class DeltaLikeSynapse>
 void calculate_delta_synapse_projection_impl(
     knp::core::Projection<DeltaLikeSynapse> &projection, knp::core::MessageEndpoint &endpoint,
@@ -73,10 +60,26 @@ constexpr bool is_forcing<knp::core::Projection<synapse_traits::DeltaSynapse>>()
 }
 
 
+/**
+ * @brief Create a message queue that is long enough for all synapse delays of the projection.
+ * @param projection projection to create the queue for.
+ * @return message queue.
+ */
 template <typename ProjectionType>
-MessageQueue::const_iterator calculate_delta_synapse_projection_data(
-    ProjectionType &projection, std::vector<core::messaging::SpikeMessage> &messages, MessageQueue &future_messages,
-    size_t step_n,
+MessageQueue create_message_queue(const ProjectionType &projection)
+{
+    size_t max_delay = 1;
+    for (const auto &synapse : projection)
+    {
+        max_delay = std::max<size_t>(max_delay, std::get<core::synapse_data>(synapse).delay_);
+    }
+    return MessageQueue(max_delay);
+}
+
+
+template <typename ProjectionType>
+void calculate_delta_synapse_projection_data(
+    ProjectionType &projection, SharedSpikeMessages &messages, MessageQueue &future_messages, size_t step_n,
     std::function<knp::synapse_traits::synapse_parameters<knp::synapse_traits::DeltaSynapse>(
         const typename ProjectionType::SynapseParameters &)>
         sp_getter = [](const typename ProjectionType::SynapseParameters &synapse_params) { return synapse_params; })
@@ -87,15 +90,16 @@ MessageQueue::const_iterator calculate_delta_synapse_projection_data(
 
     for (const auto &message : messages)
     {
-        const auto &message_data = message.neuron_indexes_;
+        const auto &message_data = message->neuron_indexes_;
         for (const auto &spiked_neuron_index : message_data)
         {
-            auto synapses = projection.find_synapses(spiked_neuron_index, ProjectionType::Search::by_presynaptic);
-            for (auto synapse_index : synapses)
+            for (auto synapse_index : projection.synapses_of_presynaptic(spiked_neuron_index))
             {
                 auto &synapse = projection[synapse_index];
                 WeightUpdateSTDP<SynapseType>::init_synapse(std::get<core::synapse_data>(synapse), step_n);
                 const auto &synapse_params = sp_getter(std::get<core::synapse_data>(synapse));
+                // Impacts with zero delay would be sent on the previous step, so they are never delivered.
+                if (!synapse_params.delay_) continue;
 
                 // The message is sent on step N - 1, received on step N.
                 size_t future_step = synapse_params.delay_ + step_n - 1;
@@ -104,107 +108,158 @@ MessageQueue::const_iterator calculate_delta_synapse_projection_data(
                     static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
                     static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse))};
 
-                auto iter = future_messages.find(future_step);
-                if (iter != future_messages.end())
-                {
-                    iter->second.impacts_.push_back(impact);
-                }
-                else
-                {
-                    knp::core::messaging::SynapticImpactMessage message_out{
-                        {projection.get_uid(), step_n},
-                        projection.get_postsynaptic(),
-                        projection.get_presynaptic(),
-                        is_forcing<ProjectionType>(),
-                        {impact}};
-                    future_messages.insert(std::make_pair(future_step, message_out));
-                }
+                future_messages.push(step_n, future_step, impact);
             }
         }
     }
     WeightUpdateSTDP<SynapseType>::modify_weights(projection);
-    return future_messages.find(step_n);
 }
 
 
-template <class DeltaLikeSynapse>
-void calculate_projection_part_impl(
-    knp::core::Projection<DeltaLikeSynapse> &projection, const std::unordered_map<size_t, size_t> &message_in_data,
-    MessageQueue &future_messages, uint64_t step_n, size_t part_start, size_t part_size, std::mutex &mutex)
+/**
+ * @brief Apply STDP rule to projection synapses before synaptic impacts are calculated.
+ * @details The function registers spikes received by the projection and initializes synapses of spiking presynaptic
+ * neurons. Spike messages that must not produce impacts are replaced with empty ones.
+ * @tparam ProjectionType projection type.
+ * @param projection projection to update.
+ * @param messages spike messages received by the projection.
+ * @param step_n current step.
+ */
+template <typename ProjectionType>
+void init_stdp_projection(ProjectionType &projection, SharedSpikeMessages &messages, uint64_t step_n)
 {
-    size_t part_end = std::min(part_start + part_size, projection.size());
-    std::vector<std::pair<uint64_t, knp::core::messaging::SynapticImpact>> container;
-    for (size_t synapse_index = part_start; synapse_index < part_end; ++synapse_index)
+    using SynapseType = typename ProjectionType::ProjectionSynapseType;
+    WeightUpdateSTDP<SynapseType>::init_projection(projection, messages, step_n);
+
+    for (const auto &message : messages)
     {
-        auto &synapse = projection[synapse_index];
-        // update_step(synapse.params_, step_n);
-        // TODO: Move update logic here too.
-        auto iter = message_in_data.find(std::get<core::source_neuron_id>(synapse));
-        if (iter == message_in_data.end())
+        for (const auto &spiked_neuron_index : message->neuron_indexes_)
         {
-            continue;
+            for (auto synapse_index : projection.synapses_of_presynaptic(spiked_neuron_index))
+            {
+                WeightUpdateSTDP<SynapseType>::init_synapse(
+                    std::get<core::synapse_data>(projection[synapse_index]), step_n);
+            }
         }
+    }
+}
 
-        // Add new impact.
-        // The message is sent on step N - 1, received on step N.
-        uint64_t key = std::get<core::synapse_data>(synapse).delay_ + step_n - 1;
 
-        knp::core::messaging::SynapticImpact impact{
-            synapse_index, std::get<core::synapse_data>(synapse).weight_ * iter->second,
-            std::get<core::synapse_data>(synapse).output_type_,
-            static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
-            static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse))};
+/**
+ * @brief Send impacts of the current step as a single message and clear the queue slot.
+ * @param projection projection that sends the impacts.
+ * @param future_messages projection message queue.
+ * @param endpoint endpoint used to send the message.
+ * @param step_n current step.
+ */
+template <typename ProjectionType>
+void send_step_impacts(
+    const ProjectionType &projection, MessageQueue &future_messages, knp::core::MessageEndpoint &endpoint,
+    uint64_t step_n)
+{
+    auto &impacts = future_messages.get_impacts(step_n);
+    if (impacts.empty())
+    {
+        return;
+    }
+
+    SPDLOG_TRACE("Projection is sending an impact message.");
+    endpoint.send_message(knp::core::messaging::SynapticImpactMessage{
+        {projection.get_uid(), step_n},
+        projection.get_postsynaptic(),
+        projection.get_presynaptic(),
+        is_forcing<ProjectionType>(),
+        impacts});
+    future_messages.clear_step(step_n);
+}
+
 
-        container.emplace_back(key, impact);
+/**
+ * @brief Count spikes of each neuron.
+ * @param messages spike messages.
+ * @return vector of `{neuron index, number of spikes}` pairs sorted by neuron index.
+ */
+inline std::vector<std::pair<core::messaging::SpikeIndex, size_t>> count_spikes(const SharedSpikeMessages &messages)
+{
+    std::vector<core::messaging::SpikeIndex> spikes;
+    for (const auto &message : messages)
+    {
+        spikes.insert(spikes.end(), message->neuron_indexes_.begin(), message->neuron_indexes_.end());
     }
-    // Add impacts to future messages queue, it is a shared resource.
-    const std::lock_guard lock_guard(mutex);
-    const auto &projection_uid = projection.get_uid();
-    const auto &presynaptic_uid = projection.get_presynaptic();
-    const auto &postsynaptic_uid = projection.get_postsynaptic();
+    std::sort(spikes.begin(), spikes.end());
 
-    for (auto value : container)
+    std::vector<std::pair<core::messaging::SpikeIndex, size_t>> result;
+    for (auto neuron_index : spikes)
     {
-        auto iter = future_messages.find(value.first);
-        if (iter != future_messages.end())
+        if (result.empty() || result.back().first != neuron_index)
         {
-            iter->second.impacts_.push_back(value.second);
+            result.emplace_back(neuron_index, 1);
         }
         else
         {
-            knp::core::messaging::SynapticImpactMessage message_out{
-                {projection_uid, step_n},
-                postsynaptic_uid,
-                presynaptic_uid,
-                is_forcing<core::Projection<DeltaLikeSynapse>>(),
-                {value.second}};
-            future_messages.insert(std::make_pair(value.first, message_out));
+            ++result.back().second;
         }
     }
+    return result;
 }
 
 
-/**
- * @brief Convert spike vector to unordered map.
- * @param message spike message.
- * @return unordered map of `{index : number of instances}`. Number of instances usually equals `1`.
- */
-inline std::unordered_map<uint64_t, size_t> convert_spikes(const core::messaging::SpikeMessage &message)
+template <class DeltaLikeSynapse>
+void calculate_projection_spikes_part_impl(
+    const knp::core::Projection<DeltaLikeSynapse> &projection,
+    const std::vector<std::pair<core::messaging::SpikeIndex, size_t>> &spikes, DelayedImpacts &container,
+    uint64_t step_n, size_t part_start, size_t part_size)
 {
-    std::unordered_map<size_t, size_t> result;
-    for (auto neuron_idx : message.neuron_indexes_)
+    size_t part_end = std::min(part_start + part_size, spikes.size());
+    container.clear();
+    if constexpr (is_stdp_synapse_v<DeltaLikeSynapse>)
     {
-        auto iter = result.find(neuron_idx);
-        if (result.end() == iter)
+        // Weights of trained synapses change at every step, so they are read from the projection instead of columns.
+        for (size_t spike_index = part_start; spike_index < part_end; ++spike_index)
         {
-            result.insert({neuron_idx, 1});
+            const auto &[neuron_index, spikes_count] = spikes[spike_index];
+            for (auto synapse_index : projection.synapses_of_presynaptic(neuron_index))
+            {
+                const auto &synapse = projection[synapse_index];
+                const auto &synapse_params = std::get<core::synapse_data>(synapse);
+                // Impacts with zero delay would be sent on the previous step, so they are never delivered.
+                if (!synapse_params.delay_) continue;
+
+                // The message is sent on step N - 1, received on step N.
+                uint64_t key = synapse_params.delay_ + step_n - 1;
+
+                knp::core::messaging::SynapticImpact impact{
+                    synapse_index, synapse_params.weight_ * spikes_count, synapse_params.output_type_,
+                    static_cast<uint32_t>(std::get<core::source_neuron_id>(synapse)),
+                    static_cast<uint32_t>(std::get<core::target_neuron_id>(synapse))};
+
+                container.emplace_back(key, impact);
+            }
         }
-        else
+        return;
+    }
+
+    // Only the needed synapse fields are read from the columns.
+    const auto &columns = projection.get_synapse_columns();
+    for (size_t spike_index = part_start; spike_index < part_end; ++spike_index)
+    {
+        const auto &[neuron_index, spikes_count] = spikes[spike_index];
+        // Only synapses of the spiking neurons are processed.
+        for (auto synapse_index : projection.synapses_of_presynaptic(neuron_index))
         {
-            ++(iter->second);
+            // Impacts with zero delay would be sent on the previous step, so they are never delivered.
+            if (!columns.delays_[synapse_index]) continue;
+
+            // The message is sent on step N - 1, received on step N.
+            uint64_t key = columns.delays_[synapse_index] + step_n - 1;
+
+            knp::core::messaging::SynapticImpact impact{
+                synapse_index, columns.weights_[synapse_index] * spikes_count, columns.output_types_[synapse_index],
+                columns.source_neuron_ids_[synapse_index], columns.target_neuron_ids_[synapse_index]};
+
+            container.emplace_back(key, impact);
         }
     }
-    return result;
 }
 
 
@@ -215,15 +270,10 @@ void calculate_delta_synapse_projection_impl(
 {
     SPDLOG_DEBUG("Calculating delta synapse projection...");
 
-    auto messages = endpoint.unload_messages<core::messaging::SpikeMessage>(projection.get_uid());
-    auto out_iter = calculate_delta_synapse_projection_data(projection, messages, future_messages, step_n);
-    if (out_iter != future_messages.end())
-    {
-        SPDLOG_TRACE("Projection is sending an impact message.");
-        // Send a message and remove it from the queue.
-        endpoint.send_message(out_iter->second);
-        future_messages.erase(out_iter);
-    }
+    // Spike messages are shared by all projections that receive them.
+    auto messages = endpoint.unload_shared_messages<core::messaging::SpikeMessage>(projection.get_uid());
+    calculate_delta_synapse_projection_data(projection, messages, future_messages, step_n);
+    send_step_impacts(projection, future_messages, endpoint, step_n);
 }
 
 }  // namespace knp::backends::cpu
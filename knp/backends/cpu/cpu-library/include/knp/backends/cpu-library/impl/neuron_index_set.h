@@ -0,0 +1,110 @@
+/**
+ * @file neuron_index_set.h
+ * @brief Set of population neuron indexes.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+/**
+ * @brief Set of indexes of population neurons that need processing.
+ * @details The set stores a membership flag for each population neuron and a list of member indexes, so insertion
+ * takes constant time and iteration over the set doesn't depend on the population size.
+ */
+class NeuronIndexSet
+{
+public:
+    /**
+     * @brief Get population size the set was reset for.
+     * @return number of population neurons.
+     */
+    [[nodiscard]] size_t population_size() const { return is_member_.size(); }
+
+    /**
+     * @brief Reset the set for a population.
+     * @param population_size number of population neurons.
+     * @param fill if `true`, the set will contain all population neurons, otherwise the set will be empty.
+     */
+    void reset(size_t population_size, bool fill)
+    {
+        is_member_.assign(population_size, fill);
+        indexes_.resize(fill ? population_size : 0);
+        std::iota(indexes_.begin(), indexes_.end(), 0);
+    }
+
+    /**
+     * @brief Add a neuron to the set.
+     * @param index neuron index.
+     */
+    void insert(size_t index)
+    {
+        if (is_member_[index]) return;
+        is_member_[index] = true;
+        indexes_.push_back(index);
+    }
+
+    /**
+     * @brief Get neurons of the set.
+     * @return neuron indexes in the order of insertion.
+     */
+    [[nodiscard]] const std::vector<size_t> &get_indexes() const { return indexes_; }
+
+    /**
+     * @brief Remove all neurons from the set.
+     */
+    void clear()
+    {
+        for (const auto index : indexes_) is_member_[index] = false;
+        indexes_.clear();
+    }
+
+    /**
+     * @brief Remove neurons that satisfy a predicate from the set.
+     * @tparam Predicate type of a function that takes a neuron index and returns `true` if the neuron must be removed.
+     * @param predicate predicate.
+     */
+    template <class Predicate>
+    void erase_if(Predicate predicate)
+    {
+        const auto new_end = std::remove_if(
+            indexes_.begin(), indexes_.end(),
+            [this, &predicate](size_t index)
+            {
+                if (!predicate(index)) return false;
+                is_member_[index] = false;
+                return true;
+            });
+        indexes_.erase(new_end, indexes_.end());
+    }
+
+private:
+    std::vector<bool> is_member_;
+    std::vector<size_t> indexes_;
+};
+
+}  // namespace knp::backends::cpu
@@ -0,0 +1,143 @@
+/**
+ * @file part_size_tuner.h
+ * @brief Tuner of part sizes for parallel processing.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+/**
+ * @brief The PartSizeTuner class chooses the number of elements in parts that are processed by separate tasks.
+ * @details The tuner measures processing time of elements during the first `measured_step_count` steps with processed
+ * elements. Then it sets the part size so that a part takes at least `target_part_time` to process, which makes task
+ * overhead negligible, and each thread gets about `parts_per_thread` parts of the elements processed at a step, which
+ * balances the load. If elements are too cheap to give each thread a part of the target time, fewer parts are made.
+ */
+class PartSizeTuner
+{
+public:
+    /**
+     * @brief Number of steps with processed elements that are measured before the part size is tuned.
+     */
+    static constexpr uint64_t measured_step_count = 10;
+
+    /**
+     * @brief Minimal processing time of a part.
+     */
+    static constexpr std::chrono::nanoseconds target_part_time{50000};
+
+    /**
+     * @brief Number of parts per thread that are made if elements are expensive enough.
+     */
+    static constexpr size_t parts_per_thread = 4;
+
+    /**
+     * @brief Create a tuner with fixed part size.
+     * @param part_size part size.
+     */
+    explicit PartSizeTuner(size_t part_size = 1) : part_size_(std::max<size_t>(part_size, 1)) {}
+
+    /**
+     * @brief Create a tuner.
+     * @param part_size part size used until the size is tuned.
+     * @param thread_count number of threads that process parts.
+     * @param is_enabled if `false`, part size is not tuned.
+     */
+    PartSizeTuner(size_t part_size, size_t thread_count, bool is_enabled)
+        : part_size_(std::max<size_t>(part_size, 1)),
+          thread_count_(std::max<size_t>(thread_count, 1)),
+          is_enabled_(is_enabled)
+    {
+    }
+
+    /**
+     * @brief Get current part size.
+     * @return number of elements in a part.
+     */
+    [[nodiscard]] size_t get_part_size() const { return part_size_; }
+
+    /**
+     * @brief Check if processing time of parts must be measured.
+     * @return `true` if the part size is not tuned yet.
+     */
+    [[nodiscard]] bool is_measuring() const { return is_enabled_ && measured_steps_ < measured_step_count; }
+
+    /**
+     * @brief Add processing time of a part at the current step.
+     * @param time processing time.
+     * @param element_count number of processed elements.
+     */
+    void add_measurement(std::chrono::nanoseconds time, size_t element_count)
+    {
+        step_time_ += time;
+        step_elements_ += element_count;
+    }
+
+    /**
+     * @brief Finish measurements of the current step.
+     * @details Steps without processed elements are not counted. The part size is tuned after `measured_step_count`
+     * counted steps.
+     * @return `true` if the part size was changed.
+     */
+    bool finish_step()
+    {
+        if (!is_measuring() || !step_elements_) return false;
+
+        measured_time_ += step_time_;
+        measured_elements_ += step_elements_;
+        step_time_ = std::chrono::nanoseconds{0};
+        step_elements_ = 0;
+        if (++measured_steps_ < measured_step_count) return false;
+
+        // Time is measured in nanoseconds, so an element takes at least a nanosecond.
+        const double element_time =
+            std::max(static_cast<double>(measured_time_.count()) / static_cast<double>(measured_elements_), 1.0);
+        const double step_elements =
+            static_cast<double>(measured_elements_) / static_cast<double>(measured_step_count);
+        const auto timed_size = static_cast<size_t>(static_cast<double>(target_part_time.count()) / element_time);
+        const auto balanced_size =
+            static_cast<size_t>(std::ceil(step_elements / static_cast<double>(thread_count_ * parts_per_thread)));
+
+        const size_t old_part_size = part_size_;
+        part_size_ = std::max<size_t>({timed_size, balanced_size, 1});
+        return part_size_ != old_part_size;
+    }
+
+private:
+    size_t part_size_;
+    size_t thread_count_ = 1;
+    bool is_enabled_ = false;
+    uint64_t measured_steps_ = 0;
+    std::chrono::nanoseconds measured_time_{0};
+    size_t measured_elements_ = 0;
+    std::chrono::nanoseconds step_time_{0};
+    size_t step_elements_ = 0;
+};
+
+}  // namespace knp::backends::cpu
@@ -0,0 +1,58 @@
+/**
+ * @file parts.h
+ * @brief Helpers for data processed by parts.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <vector>
+
+
+/**
+ * @brief Namespace for CPU backends.
+ */
+namespace knp::backends::cpu
+{
+/**
+ * @brief Concatenate containers in their order.
+ * @details Offsets of the parts in the result are calculated as prefix sums of the part sizes, so the result is
+ * allocated once.
+ * @param first iterator pointing to the first container to concatenate.
+ * @param last iterator pointing past the last container to concatenate.
+ * @param result output container. Concatenated values are appended to it.
+ */
+template <class PartIterator, class Container>
+void concatenate_parts(PartIterator first, PartIterator last, Container &result)
+{
+    std::vector<size_t> offsets{result.size()};
+    for (auto part = first; part != last; ++part)
+    {
+        offsets.push_back(offsets.back() + part->size());
+    }
+
+    result.resize(offsets.back());
+    auto offset = offsets.begin();
+    for (auto part = first; part != last; ++part, ++offset)
+    {
+        std::copy(part->begin(), part->end(), result.begin() + *offset);
+    }
+}
+
+}  // namespace knp::backends::cpu
@@ -21,6 +21,7 @@
 
 #pragma once
 #include <knp/backends/cpu-library/impl/base_stdp_impl.h>
+#include <knp/backends/cpu-library/impl/neuron_index_set.h>
 #include <knp/core/messaging/spike_message.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
@@ -32,10 +33,12 @@
 #include <algorithm>
 #include <limits>
 #include <numeric>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
 #include <boost/mp11.hpp>
+#include <boost/range/iterator_range.hpp>
 
 
 /**
@@ -82,6 +85,43 @@ std::vector<knp::core::Projection<SynapseType> *> find_projection_by_type_and_po
 }
 
 
+/**
+ * @brief Projections of the given type grouped by UIDs of their postsynaptic populations.
+ * @tparam SynapseType projection synapse type.
+ */
+template <class SynapseType>
+using IncomingProjections =
+    std::unordered_map<knp::core::UID, std::vector<knp::core::Projection<SynapseType> *>, knp::core::uid_hash>;
+
+
+/**
+ * @brief Group projections of the given type by their postsynaptic populations.
+ * @details Backends build the map when projections are loaded instead of scanning all projections at every step.
+ * Locked projections are included, so the map stays valid when projections are locked or unlocked.
+ * @tparam SynapseType projection synapse type.
+ * @tparam ProjectionContainer type of a projection container.
+ * @param projections projection container.
+ * @return map of postsynaptic population UIDs to projections. Pointers stay valid until the container is changed.
+ */
+template <class SynapseType, class ProjectionContainer>
+IncomingProjections<SynapseType> group_projections_by_postsynaptic(ProjectionContainer &projections)
+{
+    IncomingProjections<SynapseType> result;
+    constexpr auto type_index = boost::mp11::mp_find<synapse_traits::AllSynapses, SynapseType>();
+    for (auto &projection : projections)
+    {
+        if (projection.arg_.index() != type_index)
+        {
+            continue;
+        }
+
+        auto *projection_ptr = &(std::get<type_index>(projection.arg_));
+        result[projection_ptr->get_postsynaptic()].push_back(projection_ptr);
+    }
+    return result;
+}
+
+
 template <class Synapse>
 using STDPSynapseParams = knp::synapse_traits::synapse_parameters<
     knp::synapse_traits::STDP<knp::synapse_traits::STDPSynapticResourceRule, Synapse>>;
@@ -89,11 +129,11 @@ using STDPSynapseParams = knp::synapse_traits::synapse_parameters<
 
 /**
  * @brief Recalculate synapse weights from synaptic resource.
- * @tparam WeightedSynapse synapse that has `weight_` parameter.
+ * @tparam SynapseRange range of pointers to parameters of synapses that have `weight_` parameter.
  * @param synapse_params synapse parameters.
  */
-template <class WeightedSynapse>
-void recalculate_synapse_weights(std::vector<STDPSynapseParams<WeightedSynapse> *> &synapse_params)
+template <class SynapseRange>
+void recalculate_synapse_weights(const SynapseRange &synapse_params)
 {
     // Synapse weight recalculation.
     for (auto synapse_ptr : synapse_params)
@@ -110,6 +150,14 @@ using StdpProjection =
     knp::core::Projection<knp::synapse_traits::STDP<knp::synapse_traits::STDPSynapticResourceRule, Synapse>>;
 
 
+template <class NeuronType>
+bool is_resource_above_threshold(
+    const neuron_traits::neuron_parameters<neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &neuron)
+{
+    return abs(neuron.free_synaptic_resource_) >= neuron.synaptic_resource_threshold_;
+}
+
+
 inline bool is_point_in_interval(uint64_t interval_begin, uint64_t interval_end, uint64_t point)
 {
     const bool is_after_begin = point >= interval_begin;
@@ -119,20 +167,171 @@ inline bool is_point_in_interval(uint64_t interval_begin, uint64_t interval_end,
 }
 
 
+/**
+ * @brief The PostsynapticSynapses class stores pointers to synapses of several projections grouped by postsynaptic
+ * neurons.
+ * @details Pointers to synapses connected to the neuron `N` are stored in the `synapses_` array between `offsets_[N]`
+ * and `offsets_[N + 1]`. Synapses of a neuron are ordered by projections and then by indexes in a projection.
+ * The structure is rebuilt only if the projection list or synapses of the projections change.
+ * @tparam SynapseType projection synapse type.
+ */
 template <class SynapseType>
-std::vector<synapse_traits::synapse_parameters<SynapseType> *> get_all_connected_synapses(
-    const std::vector<core::Projection<SynapseType> *> &projections_to_neuron, size_t neuron_index)
+class PostsynapticSynapses
 {
-    std::vector<synapse_traits::synapse_parameters<SynapseType> *> result;
-    for (auto *projection : projections_to_neuron)
+public:
+    /**
+     * @brief Pointer to synapse parameters.
+     */
+    using SynapseParamsPtr = synapse_traits::synapse_parameters<SynapseType> *;
+
+    /**
+     * @brief Range of pointers to parameters of synapses connected to a neuron.
+     */
+    using SynapseRange = boost::iterator_range<typename std::vector<SynapseParamsPtr>::const_iterator>;
+
+public:
+    /**
+     * @brief Rebuild the structure if projections were changed since the last update.
+     * @param projections projections with the same postsynaptic population.
+     * @param population_size number of neurons in the postsynaptic population.
+     */
+    void update(const std::vector<core::Projection<SynapseType> *> &projections, size_t population_size)
     {
-        auto synapses = projection->find_synapses(neuron_index, core::Projection<SynapseType>::Search::by_postsynaptic);
-        std::transform(
-            synapses.begin(), synapses.end(), std::back_inserter(result),
-            [&projection](auto const &index) { return &std::get<core::synapse_data>((*projection)[index]); });
+        if (!is_outdated(projections, population_size)) return;
+
+        sources_.clear();
+        offsets_.assign(population_size + 1, 0);
+        for (auto *projection : projections)
+        {
+            sources_.emplace_back(projection, projection->get_synapses_revision());
+            for (const auto &synapse : std::as_const(*projection))
+            {
+                const size_t neuron_index = std::get<core::target_neuron_id>(synapse);
+                // Synapses of neurons missing in the population are never trained.
+                if (neuron_index < population_size) ++offsets_[neuron_index + 1];
+            }
+        }
+        std::partial_sum(offsets_.begin(), offsets_.end(), offsets_.begin());
+
+        synapses_.resize(offsets_.back());
+        std::vector<size_t> positions(offsets_.begin(), offsets_.end() - 1);
+        for (auto *projection : projections)
+        {
+            for (size_t synapse_index = 0; synapse_index < projection->size(); ++synapse_index)
+            {
+                const size_t neuron_index =
+                    std::get<core::target_neuron_id>(std::as_const(*projection)[synapse_index]);
+                if (neuron_index < population_size)
+                {
+                    // Synapses are changed through the stored pointers, see `mark_synapses_modified()`.
+                    synapses_[positions[neuron_index]++] =
+                        &std::get<core::synapse_data>((*projection)[synapse_index]);
+                }
+            }
+        }
+    }
+
+    /**
+     * @brief Notify projections that their synapses were changed through the stored pointers.
+     */
+    void mark_synapses_modified() const
+    {
+        for (const auto &source : sources_) source.first->mark_synapses_modified();
+    }
+
+    /**
+     * @brief Get synapses connected to a postsynaptic neuron.
+     * @param neuron_index postsynaptic neuron index.
+     * @return range of pointers to synapse parameters.
+     */
+    [[nodiscard]] SynapseRange find(size_t neuron_index) const
+    {
+        if (neuron_index + 1 >= offsets_.size()) return {synapses_.cend(), synapses_.cend()};
+        return {synapses_.cbegin() + offsets_[neuron_index], synapses_.cbegin() + offsets_[neuron_index + 1]};
     }
-    return result;
-}
+
+private:
+    [[nodiscard]] bool is_outdated(
+        const std::vector<core::Projection<SynapseType> *> &projections, size_t population_size) const
+    {
+        if (offsets_.size() != population_size + 1 || sources_.size() != projections.size()) return true;
+        for (size_t i = 0; i < projections.size(); ++i)
+        {
+            if (sources_[i].first != projections[i] ||
+                sources_[i].second != projections[i]->get_synapses_revision())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Projections and their synapse revisions used to build the structure.
+    std::vector<std::pair<core::Projection<SynapseType> *, size_t>> sources_;
+    std::vector<size_t> offsets_;
+    std::vector<SynapseParamsPtr> synapses_;
+};
+
+
+/**
+ * @brief Learning state of a population of `SynapticResourceSTDPNeuron` neurons kept between steps.
+ * @details Plasticity passes process only neurons from the active sets instead of the whole population.
+ * If neuron parameters are changed outside the backend, the state must be reset.
+ * @tparam SynapseType projection synapse type.
+ */
+template <class SynapseType>
+struct ResourceSTDPState
+{
+    /**
+     * @brief Reset the state if it was built for a population of another size.
+     * @details All neurons are checked for free synaptic resource at the first step.
+     * @param population_size number of population neurons.
+     */
+    void prepare(size_t population_size)
+    {
+        if (resource_neurons_.population_size() == population_size) return;
+        dopamine_neurons_.reset(population_size, false);
+        resource_neurons_.reset(population_size, true);
+    }
+
+    /**
+     * @brief Update synapses of trained projections.
+     * @details Locked projections are not trained.
+     * @param incoming_projections all STDP projections with the population as postsynaptic one.
+     * @param population_size number of population neurons.
+     */
+    void update_synapses(
+        const std::vector<core::Projection<SynapseType> *> &incoming_projections, size_t population_size)
+    {
+        auto is_locked = [](const auto *projection) { return projection->is_locked(); };
+        if (std::none_of(incoming_projections.begin(), incoming_projections.end(), is_locked))
+        {
+            synapses_.update(incoming_projections, population_size);
+            return;
+        }
+
+        auto working_projections = incoming_projections;
+        working_projections.erase(
+            std::remove_if(working_projections.begin(), working_projections.end(), is_locked),
+            working_projections.end());
+        synapses_.update(working_projections, population_size);
+    }
+
+    /**
+     * @brief Synapses of trained projections grouped by postsynaptic neurons.
+     */
+    PostsynapticSynapses<SynapseType> synapses_;
+
+    /**
+     * @brief Neurons that received dopamine at the current step.
+     */
+    NeuronIndexSet dopamine_neurons_;
+
+    /**
+     * @brief Neurons with free synaptic resource that can exceed the renormalization threshold.
+     */
+    NeuronIndexSet resource_neurons_;
+};
 
 
 /**
@@ -184,164 +383,337 @@ neuron_traits::ISIPeriodType update_isi(
 
 
 /**
- * @brief Apply STDP to all presynaptic connections of a single population.
+ * @brief Apply STDP to synapses of a spiked neuron.
  * @tparam NeuronType type of neuron that is compatible with STDP.
- * @param msg spikes emited by population.
- * @param working_projections all projections (those that are not connected, locked or are of a wrong type are
- * skipped).
+ * @tparam SynapseType projection synapse type.
+ * @param neuron_index index of the spiked neuron.
+ * @param synapses synapses of working projections grouped by postsynaptic neurons.
  * @param population population.
  * @param step current network step.
- * @note all projections are supposed to be of the same type.
+ * @return `true` if free synaptic resource of the neuron is above the renormalization threshold.
  */
-template <class NeuronType>
-void process_spiking_neurons(
-    const core::messaging::SpikeMessage &msg,
-    std::vector<StdpProjection<synapse_traits::DeltaSynapse> *> &working_projections,
+template <class NeuronType, class SynapseType>
+bool process_spiking_neuron(
+    size_t neuron_index, const PostsynapticSynapses<SynapseType> &synapses,
     knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step)
 {
-    using SynapseType = synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, synapse_traits::DeltaSynapse>;
-    // It's very important that during this function no projection invalidates iterators.
-    // Loop over neurons.
-    for (const auto &spiked_neuron_index : msg.neuron_indexes_)
+    bool is_resource_changed = false;
+    const auto synapse_params = synapses.find(neuron_index);
+    auto &neuron = population[neuron_index];
+    // Calculate neuron ISI status.
+    update_isi<neuron_traits::BLIFATNeuron>(neuron, step);
+    if (neuron_traits::ISIPeriodType::period_started == neuron.isi_status_)
     {
-        auto synapse_params = get_all_connected_synapses<SynapseType>(working_projections, spiked_neuron_index);
-        auto &neuron = population[spiked_neuron_index];
-        // Calculate neuron ISI status.
-        update_isi<neuron_traits::BLIFATNeuron>(neuron, step);
-        if (neuron_traits::ISIPeriodType::period_started == neuron.isi_status_)
+        neuron.stability_ -= neuron.stability_change_at_isi_;
+    }
+
+    // This is a new spiking sequence, we can update synapses now.
+    if (neuron.isi_status_ != neuron_traits::ISIPeriodType::period_continued)
+    {
+        for (auto *synapse : synapse_params)
         {
-            neuron.stability_ -= neuron.stability_change_at_isi_;
+            synapse->rule_.had_hebbian_update_ = false;
         }
+    }
 
-        // This is a new spiking sequence, we can update synapses now.
-        if (neuron.isi_status_ != neuron_traits::ISIPeriodType::period_continued)
+    // Update synapse-only data.
+    if (neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)
+    {
+        for (auto *synapse : synapse_params)
         {
-            for (auto *synapse : synapse_params)
+            // Unconditional decreasing synaptic resource.
+            // TODO: NOT HERE. This shouldn't matter now as d_u_ is zero for our task, but the logic is wrong.
+            synapse->rule_.synaptic_resource_ -= synapse->rule_.d_u_;
+            neuron.free_synaptic_resource_ += synapse->rule_.d_u_;
+            // Hebbian plasticity.
+            // 1. Check if synapse ever got a spike in the current ISI period.
+
+            if (is_point_in_interval(
+                    neuron.first_isi_spike_ - neuron.isi_max_, step, synapse->rule_.last_spike_step_) &&
+                !synapse->rule_.had_hebbian_update_)
             {
-                synapse->rule_.had_hebbian_update_ = false;
+                // 2. If it did, then update synaptic resource value.
+                const float d_h = neuron.d_h_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
+                synapse->rule_.synaptic_resource_ += d_h;
+                neuron.free_synaptic_resource_ -= d_h;
             }
         }
+        is_resource_changed = is_resource_above_threshold<NeuronType>(neuron);
+    }
+    // Recalculating synapse weights. Sometimes it probably doesn't need to happen, check it later.
+    recalculate_synapse_weights(synapse_params);
+    return is_resource_changed;
+}
+
 
-        // Update synapse-only data.
-        if (neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)
+/**
+ * @brief Apply STDP to all presynaptic connections of a single population.
+ * @tparam NeuronType type of neuron that is compatible with STDP.
+ * @tparam SynapseType projection synapse type.
+ * @param msg spikes emited by population.
+ * @param synapses synapses of working projections grouped by postsynaptic neurons.
+ * @param population population.
+ * @param step current network step.
+ * @param resource_neurons set to which neurons with free resource above the threshold are added.
+ */
+template <class NeuronType, class SynapseType>
+void process_spiking_neurons(
+    const core::messaging::SpikeMessage &msg, const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step,
+    NeuronIndexSet &resource_neurons)
+{
+    // It's very important that during this function no projection invalidates synapse pointers.
+    // Loop over neurons.
+    for (const auto &spiked_neuron_index : msg.neuron_indexes_)
+    {
+        if (process_spiking_neuron<NeuronType>(spiked_neuron_index, synapses, population, step))
         {
-            for (auto *synapse : synapse_params)
-            {
-                // Unconditional decreasing synaptic resource.
-                // TODO: NOT HERE. This shouldn't matter now as d_u_ is zero for our task, but the logic is wrong.
-                synapse->rule_.synaptic_resource_ -= synapse->rule_.d_u_;
-                neuron.free_synaptic_resource_ += synapse->rule_.d_u_;
-                // Hebbian plasticity.
-                // 1. Check if synapse ever got a spike in the current ISI period.
-
-                if (is_point_in_interval(
-                        neuron.first_isi_spike_ - neuron.isi_max_, step, synapse->rule_.last_spike_step_) &&
-                    !synapse->rule_.had_hebbian_update_)
-                {
-                    // 2. If it did, then update synaptic resource value.
-                    const float d_h = neuron.d_h_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
-                    synapse->rule_.synaptic_resource_ += d_h;
-                    neuron.free_synaptic_resource_ -= d_h;
-                }
-            }
+            resource_neurons.insert(spiked_neuron_index);
         }
-        // Recalculating synapse weights. Sometimes it probably doesn't need to happen, check it later.
-        recalculate_synapse_weights<knp::synapse_traits::DeltaSynapse>(synapse_params);
     }
 }
 
 
+/**
+ * @brief Apply STDP to synapses of a part of spiked neurons.
+ * @tparam NeuronType type of neuron that is compatible with STDP.
+ * @tparam SynapseType projection synapse type.
+ * @param neuron_indexes indexes of spiked neurons without repetitions.
+ * @param synapses synapses of working projections grouped by postsynaptic neurons.
+ * @param population population.
+ * @param step current network step.
+ * @param resource_neurons output container of neurons with free resource above the threshold. The container is
+ * cleared before processing.
+ * @param part_start index of the first neuron to process in `neuron_indexes`.
+ * @param part_size number of neurons to process.
+ * @note The method is used for parallelization. A neuron changes only its own synapses, so different parts can be
+ * processed concurrently if each part has its own output container.
+ */
+template <class NeuronType, class SynapseType>
+void process_spiking_neurons_part(
+    const core::messaging::SpikeData &neuron_indexes, const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step,
+    std::vector<size_t> &resource_neurons, size_t part_start, size_t part_size)
+{
+    const size_t part_end = std::min(part_start + part_size, neuron_indexes.size());
+    resource_neurons.clear();
+    for (size_t index = part_start; index < part_end; ++index)
+    {
+        if (process_spiking_neuron<NeuronType>(neuron_indexes[index], synapses, population, step))
+        {
+            resource_neurons.push_back(neuron_indexes[index]);
+        }
+    }
+}
+
+
+/**
+ * @brief Distribute free synaptic resource of a neuron among all its synapses if the resource exceeds the threshold.
+ * @tparam NeuronType type of base neuron.
+ * @tparam SynapseType projection synapse type.
+ * @param neuron_index neuron index.
+ * @param synapses synapses of STDP projections grouped by postsynaptic neurons.
+ * @param population reference to population.
+ * @param step current step.
+ * @return `false` if the neuron is still in ISI period and must be checked later, `true` otherwise.
+ */
+template <class NeuronType, class SynapseType>
+bool renormalize_neuron_resource(
+    size_t neuron_index, const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step)
+{
+    auto &neuron = population[neuron_index];
+    if (step - neuron.last_step_ <= neuron.isi_max_ && neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)
+    {
+        // Neuron is still in ISI period, skip it.
+        return false;
+    }
+
+    if (abs(neuron.free_synaptic_resource_) < neuron.synaptic_resource_threshold_)
+    {
+        return true;
+    }
+
+    const auto synapse_params = synapses.find(neuron_index);
+
+    // Divide free resource between all synapses.
+    auto add_resource_value =
+        neuron.free_synaptic_resource_ / (synapse_params.size() + neuron.resource_drain_coefficient_);
+
+    for (auto *synapse : synapse_params)
+    {
+        synapse->rule_.synaptic_resource_ += add_resource_value;
+    }
+
+    neuron.free_synaptic_resource_ = 0.0F;
+    recalculate_synapse_weights(synapse_params);
+    return true;
+}
+
+
 /**
  * @brief If a neuron resource is greater than `1` or `-1` it should be distributed among all synapses.
  * @tparam NeuronType type of base neuron (BLIFAT for SynapticResourceSTDPBlifat).
- * @param working_projections list of STDP projections (`DeltaSynapse` only is supported now).
+ * @tparam SynapseType projection synapse type.
+ * @param synapses synapses of STDP projections grouped by postsynaptic neurons.
  * @param population reference to population.
  * @param step current step.
+ * @param resource_neurons neurons to check. Neurons that don't need renormalization any more are removed from the set.
  */
-template <class NeuronType>
+template <class NeuronType, class SynapseType>
 void renormalize_resource(
-    std::vector<StdpProjection<synapse_traits::DeltaSynapse> *> &working_projections,
-    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step)
+    const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step,
+    NeuronIndexSet &resource_neurons)
 {
-    using SynapseType =
-        knp::synapse_traits::STDP<knp::synapse_traits::STDPSynapticResourceRule, synapse_traits::DeltaSynapse>;
-    for (size_t neuron_index = 0; neuron_index < population.size(); ++neuron_index)
+    resource_neurons.erase_if([&synapses, &population, step](size_t neuron_index)
+                              { return renormalize_neuron_resource(neuron_index, synapses, population, step); });
+}
+
+
+/**
+ * @brief Renormalize synaptic resource of a part of neurons.
+ * @tparam NeuronType type of base neuron.
+ * @tparam SynapseType projection synapse type.
+ * @param neuron_indexes indexes of neurons to check without repetitions.
+ * @param synapses synapses of STDP projections grouped by postsynaptic neurons.
+ * @param population reference to population.
+ * @param step current step.
+ * @param kept_neurons output container of neurons that must be checked later. The container is cleared before
+ * processing.
+ * @param part_start index of the first neuron to process in `neuron_indexes`.
+ * @param part_size number of neurons to process.
+ * @note The method is used for parallelization. A neuron changes only its own synapses, so different parts can be
+ * processed concurrently if each part has its own output container.
+ */
+template <class NeuronType, class SynapseType>
+void renormalize_resource_part(
+    const std::vector<size_t> &neuron_indexes, const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step,
+    std::vector<size_t> &kept_neurons, size_t part_start, size_t part_size)
+{
+    const size_t part_end = std::min(part_start + part_size, neuron_indexes.size());
+    kept_neurons.clear();
+    for (size_t index = part_start; index < part_end; ++index)
     {
-        auto &neuron = population[neuron_index];
-        if (step - neuron.last_step_ <= neuron.isi_max_ &&
-            neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)
+        if (!renormalize_neuron_resource(neuron_indexes[index], synapses, population, step))
         {
-            // Neuron is still in ISI period, skip it.
-            continue;
+            kept_neurons.push_back(neuron_indexes[index]);
         }
+    }
+}
+
+
+/**
+ * @brief Change synaptic resource and stability of a neuron that received dopamine.
+ * @tparam NeuronType type of base neuron.
+ * @tparam SynapseType projection synapse type.
+ * @param neuron_index neuron index.
+ * @param synapses synapses of STDP projections grouped by postsynaptic neurons.
+ * @param population reference to population.
+ * @param step current step.
+ * @return `true` if free synaptic resource of the neuron is above the renormalization threshold after the change.
+ */
+template <class NeuronType, class SynapseType>
+bool do_neuron_dopamine_plasticity(
+    size_t neuron_index, const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step)
+{
+    auto &neuron = population[neuron_index];
+    // Dopamine processing. Dopamine punishment if forced does nothing.
+    if (!(neuron.dopamine_value_ > 0.0 ||
+          (neuron.dopamine_value_ < 0.0 && neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced)))
+    {
+        return false;
+    }
 
-        if (abs(neuron.free_synaptic_resource_) < neuron.synaptic_resource_threshold_)
+    const auto synapse_params = synapses.find(neuron_index);
+    // Change synapse values for both `D > 0` and `D < 0`.
+    for (auto *synapse : synapse_params)
+    {
+        if (step - synapse->rule_.last_spike_step_ < synapse->rule_.dopamine_plasticity_period_)
         {
-            continue;
+            // Change synapse resource.
+            float d_r = neuron.dopamine_value_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
+            synapse->rule_.synaptic_resource_ += d_r;
+            neuron.free_synaptic_resource_ -= d_r;
         }
+    }
+    // Stability changes.
+    if (neuron.is_being_forced_ || neuron.dopamine_value_ < 0)
+    {
+        // A dopamine reward when forced or a dopamine punishment reduce stability by `r * D`.
+        neuron.stability_ -= neuron.dopamine_value_ * neuron.stability_change_parameter_;
+        neuron.stability_ = std::max(neuron.stability_, 0.0F);
+    }
+    else
+    {
+        // A dopamine reward when non-forced changes stability by `D max(2 - |t(TSS) - ISImax| / ISImax, -1)`.
+        const double dopamine_constant = 2.0;
+        const double difference = step - neuron.first_isi_spike_ - neuron.isi_max_;
+        neuron.stability_ += neuron.stability_change_parameter_ * neuron.dopamine_value_ *
+                             std::max(dopamine_constant - abs(difference) / neuron.isi_max_, -1.0);
+    }
+    recalculate_synapse_weights(synapse_params);
+    return is_resource_above_threshold<NeuronType>(neuron);
+}
 
-        auto synapse_params = get_all_connected_synapses<SynapseType>(working_projections, neuron_index);
-
-        // Divide free resource between all synapses.
-        auto add_resource_value =
-            neuron.free_synaptic_resource_ / (synapse_params.size() + neuron.resource_drain_coefficient_);
 
-        for (auto *synapse : synapse_params)
+/**
+ * @brief Change synaptic resource and stability of neurons that received dopamine.
+ * @tparam NeuronType type of base neuron.
+ * @tparam SynapseType projection synapse type.
+ * @param synapses synapses of STDP projections grouped by postsynaptic neurons.
+ * @param population reference to population.
+ * @param step current step.
+ * @param dopamine_neurons neurons that received dopamine at the current step. The set is cleared.
+ * @param resource_neurons set to which neurons with free resource above the threshold are added.
+ */
+template <class NeuronType, class SynapseType>
+void do_dopamine_plasticity(
+    const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step,
+    NeuronIndexSet &dopamine_neurons, NeuronIndexSet &resource_neurons)
+{
+    for (const auto neuron_index : dopamine_neurons.get_indexes())
+    {
+        if (do_neuron_dopamine_plasticity(neuron_index, synapses, population, step))
         {
-            synapse->rule_.synaptic_resource_ += add_resource_value;
+            resource_neurons.insert(neuron_index);
         }
-
-        neuron.free_synaptic_resource_ = 0.0F;
-        recalculate_synapse_weights(synapse_params);
     }
+    dopamine_neurons.clear();
 }
 
 
-template <class NeuronType>
-void do_dopamine_plasticity(
-    std::vector<StdpProjection<synapse_traits::DeltaSynapse> *> &working_projections,
-    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step)
+/**
+ * @brief Change synaptic resource and stability of a part of neurons that received dopamine.
+ * @tparam NeuronType type of base neuron.
+ * @tparam SynapseType projection synapse type.
+ * @param neuron_indexes indexes of neurons that received dopamine without repetitions.
+ * @param synapses synapses of STDP projections grouped by postsynaptic neurons.
+ * @param population reference to population.
+ * @param step current step.
+ * @param resource_neurons output container of neurons with free resource above the threshold. The container is
+ * cleared before processing.
+ * @param part_start index of the first neuron to process in `neuron_indexes`.
+ * @param part_size number of neurons to process.
+ * @note The method is used for parallelization. A neuron changes only its own synapses, so different parts can be
+ * processed concurrently if each part has its own output container.
+ */
+template <class NeuronType, class SynapseType>
+void do_dopamine_plasticity_part(
+    const std::vector<size_t> &neuron_indexes, const PostsynapticSynapses<SynapseType> &synapses,
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population, uint64_t step,
+    std::vector<size_t> &resource_neurons, size_t part_start, size_t part_size)
 {
-    using SynapseType =
-        knp::synapse_traits::STDP<knp::synapse_traits::STDPSynapticResourceRule, synapse_traits::DeltaSynapse>;
-    using SynapseParamType = knp::synapse_traits::synapse_parameters<SynapseType>;
-    for (size_t neuron_index = 0; neuron_index < population.size(); ++neuron_index)
+    const size_t part_end = std::min(part_start + part_size, neuron_indexes.size());
+    resource_neurons.clear();
+    for (size_t index = part_start; index < part_end; ++index)
     {
-        auto &neuron = population[neuron_index];
-        // Dopamine processing. Dopamine punishment if forced does nothing.
-        if (neuron.dopamine_value_ > 0.0 ||
-            (neuron.dopamine_value_ < 0.0 && neuron.isi_status_ != neuron_traits::ISIPeriodType::is_forced))
+        if (do_neuron_dopamine_plasticity(neuron_indexes[index], synapses, population, step))
         {
-            std::vector<SynapseParamType *> synapse_params =
-                get_all_connected_synapses<SynapseType>(working_projections, neuron_index);
-            // Change synapse values for both `D > 0` and `D < 0`.
-            for (auto *synapse : synapse_params)
-            {
-                if (step - synapse->rule_.last_spike_step_ < synapse->rule_.dopamine_plasticity_period_)
-                {
-                    // Change synapse resource.
-                    float d_r =
-                        neuron.dopamine_value_ * std::min(static_cast<float>(std::pow(2, -neuron.stability_)), 1.F);
-                    synapse->rule_.synaptic_resource_ += d_r;
-                    neuron.free_synaptic_resource_ -= d_r;
-                }
-            }
-            // Stability changes.
-            if (neuron.is_being_forced_ || neuron.dopamine_value_ < 0)
-            {
-                // A dopamine reward when forced or a dopamine punishment reduce stability by `r * D`.
-                neuron.stability_ -= neuron.dopamine_value_ * neuron.stability_change_parameter_;
-                neuron.stability_ = std::max(neuron.stability_, 0.0F);
-            }
-            else
-            {
-                // A dopamine reward when non-forced changes stability by `D max(2 - |t(TSS) - ISImax| / ISImax, -1)`.
-                const double dopamine_constant = 2.0;
-                const double difference = step - neuron.first_isi_spike_ - neuron.isi_max_;
-                neuron.stability_ += neuron.stability_change_parameter_ * neuron.dopamine_value_ *
-                                     std::max(dopamine_constant - abs(difference) / neuron.isi_max_, -1.0);
-            }
-            recalculate_synapse_weights(synapse_params);
+            resource_neurons.push_back(neuron_indexes[index]);
         }
     }
 }
@@ -352,8 +724,7 @@ struct WeightUpdateSTDP<synapse_traits::STDP<synapse_traits::STDPSynapticResourc
 {
     using Synapse = synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, DeltaLikeSynapse>;
     static void init_projection(
-        const knp::core::Projection<Synapse> &projection, const std::vector<core::messaging::SpikeMessage> &messages,
-        uint64_t step)
+        const knp::core::Projection<Synapse> &projection, const SharedSpikeMessages &messages, uint64_t step)
     {
     }
 
@@ -366,25 +737,50 @@ struct WeightUpdateSTDP<synapse_traits::STDP<synapse_traits::STDPSynapticResourc
 };
 
 
+/**
+ * @brief Apply resource STDP to synapses of a population.
+ * @tparam NeuronType base neuron type.
+ * @tparam SynapseType base synapse type.
+ * @param population population.
+ * @param state learning state of the population with updated synapses and neurons that received dopamine.
+ * @param message spikes emitted by the population.
+ * @param step current step.
+ */
 template <class NeuronType, class SynapseType>
 void do_STDP_resource_plasticity(
     knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population,
-    std::vector<knp::core::Projection<synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, SynapseType>> *>
-        working_projections,
+    ResourceSTDPState<synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, SynapseType>> &state,
     const std::optional<core::messaging::SpikeMessage> &message, uint64_t step)
 {
-    // Call learning functions on all found projections:
     // 1. If neurons generated spikes, process these neurons.
     if (message.has_value())
     {
         knp::backends::cpu::process_spiking_neurons<neuron_traits::BLIFATNeuron>(
-            message.value(), working_projections, population, step);
+            message.value(), state.synapses_, population, step, state.resource_neurons_);
     }
 
     // 2. Do dopamine plasticity.
-    knp::backends::cpu::do_dopamine_plasticity(working_projections, population, step);
+    knp::backends::cpu::do_dopamine_plasticity(
+        state.synapses_, population, step, state.dopamine_neurons_, state.resource_neurons_);
 
     // 3. Renormalize resources if needed.
-    knp::backends::cpu::renormalize_resource(working_projections, population, step);
+    knp::backends::cpu::renormalize_resource(state.synapses_, population, step, state.resource_neurons_);
+    state.synapses_.mark_synapses_modified();
+}
+
+
+template <class NeuronType, class SynapseType>
+void do_STDP_resource_plasticity(
+    knp::core::Population<knp::neuron_traits::SynapticResourceSTDPNeuron<NeuronType>> &population,
+    std::vector<knp::core::Projection<synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, SynapseType>> *>
+        &working_projections,
+    const std::optional<core::messaging::SpikeMessage> &message, uint64_t step)
+{
+    // Call learning functions on all found projections. Without a kept state all neurons are checked.
+    ResourceSTDPState<synapse_traits::STDP<synapse_traits::STDPSynapticResourceRule, SynapseType>> state;
+    state.synapses_.update(working_projections, population.size());
+    state.dopamine_neurons_.reset(population.size(), true);
+    state.resource_neurons_.reset(population.size(), true);
+    do_STDP_resource_plasticity(population, state, message, step);
 }
 }  // namespace knp::backends::cpu
@@ -21,9 +21,13 @@
 
 #include <knp/backends/cpu-library/blifat_population.h>
 #include <knp/backends/cpu-library/delta_synapse_projection.h>
+#include <knp/backends/cpu-library/impl/parts.h>
 #include <knp/backends/cpu-library/init.h>
 #include <knp/backends/cpu-multi-threaded/backend.h>
-#include <knp/backends/thread_pool/thread_pool.h>
+#include <knp/backends/thread_pool/persistent_worker_pool.h>
+#include <knp/backends/thread_pool/task_graph.h>
+#include <knp/backends/thread_pool/thread_affinity.h>
+#include <knp/backends/thread_pool/work_stealing_thread_pool.h>
 #include <knp/devices/cpu.h>
 #include <knp/meta/assert_helpers.h>
 #include <knp/meta/stringify.h>
@@ -31,8 +35,14 @@
 
 #include <spdlog/spdlog.h>
 
+#include <algorithm>
+#include <chrono>
 #include <functional>
 #include <optional>
+#include <stdexcept>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <boost/mp11.hpp>
@@ -40,19 +50,186 @@
 
 namespace knp::backends::multi_threaded_cpu
 {
+namespace
+{
+// Parts of a neuron list as `{index of the first neuron, number of neurons}`.
+using NeuronParts = std::vector<std::pair<size_t, size_t>>;
+
+
+// Split a neuron list into parts, each part contains neurons with about `part_synapses` synapses.
+template <class NeuronList, class Synapses>
+void add_neuron_parts(
+    const NeuronList &neurons, const Synapses &synapses, size_t part_synapses, NeuronParts &parts)
+{
+    size_t part_start = 0;
+    size_t synapse_count = 0;
+    for (size_t index = 0; index < neurons.size(); ++index)
+    {
+        synapse_count += synapses.find(neurons[index]).size();
+        if (synapse_count < part_synapses && index + 1 < neurons.size()) continue;
+
+        parts.emplace_back(part_start, index + 1 - part_start);
+        part_start = index + 1;
+        synapse_count = 0;
+    }
+}
+
+
+// Move memory of population neurons with indexes in `[part_start, part_start + part_size)` to the current NUMA node.
+template <class NeuronType>
+void place_population_part(knp::core::Population<NeuronType> &population, size_t part_start, size_t part_size)
+{
+    const size_t part_end = std::min(part_start + part_size, population.size());
+    auto place_part = [part_start, part_end](const auto &values)
+    {
+        cpu_executors::move_to_current_node(
+            values.data() + part_start, (part_end - part_start) * sizeof(*values.data()));
+    };
+
+    if constexpr (knp::neuron_traits::has_neuron_columns_v<NeuronType>)
+    {
+        population.get_neuron_columns().for_each_neuron_column(place_part);
+    }
+    else
+    {
+        place_part(population.get_neurons_parameters());
+    }
+}
+
+
+// Move memory of projection synapses with indexes in `[part_start, part_start + part_size)` to the current NUMA node.
+// Synapse columns are placed for projections that are calculated by columns, synapses themselves are placed for STDP
+// projections. The same range of the presynaptic index is also placed. The index and the columns must be up to date.
+template <class SynapseType>
+void place_projection_part(const knp::core::Projection<SynapseType> &projection, size_t part_start, size_t part_size)
+{
+    const size_t part_end = std::min(part_start + part_size, projection.size());
+    auto place_part = [part_start, part_end](const auto &values)
+    {
+        cpu_executors::move_to_current_node(
+            values.data() + part_start, (part_end - part_start) * sizeof(*values.data()));
+    };
+
+    if constexpr (cpu::is_stdp_synapse_v<SynapseType>)
+    {
+        cpu_executors::move_to_current_node(&projection[part_start], (part_end - part_start) * sizeof(projection[0]));
+    }
+    else
+    {
+        projection.get_synapse_columns().for_each_column(place_part);
+    }
+    cpu_executors::move_to_current_node(
+        &projection.presynaptic_synapses()[part_start], (part_end - part_start) * sizeof(size_t));
+}
+
+
+// Call a function and store its execution time if `time` is not `nullptr`.
+template <class Function>
+void call_timed(const Function &function, std::chrono::nanoseconds *time)
+{
+    if (!time)
+    {
+        function();
+        return;
+    }
+    const auto start = std::chrono::steady_clock::now();
+    function();
+    *time = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+}
+
+
+std::unique_ptr<cpu_executors::TaskPool> make_task_pool(
+    size_t thread_count, ExecutionMode execution_mode, AffinityPolicy affinity_policy)
+{
+    const bool pin_threads = AffinityPolicy::pinned == affinity_policy;
+    switch (execution_mode)
+    {
+        case ExecutionMode::work_stealing:
+        case ExecutionMode::task_graph:
+            return std::make_unique<cpu_executors::WorkStealingThreadPool>(thread_count, pin_threads);
+        case ExecutionMode::persistent_workers:
+            return std::make_unique<cpu_executors::PersistentWorkerPool>(thread_count, pin_threads);
+    }
+    throw std::logic_error("Unknown execution mode.");
+}
+
+
+const char *get_execution_mode_name(ExecutionMode execution_mode)
+{
+    switch (execution_mode)
+    {
+        case ExecutionMode::work_stealing:
+            return "work stealing";
+        case ExecutionMode::persistent_workers:
+            return "persistent workers";
+        case ExecutionMode::task_graph:
+            return "task graph";
+    }
+    return "unknown";
+}
+}  // namespace
+
+
+// Data of a population used by tasks during a step.
+struct MultiThreadedCPUBackend::PopulationStep
+{
+    // Part size is fixed during a step.
+    size_t part_size_ = 1;
+    std::vector<std::chrono::nanoseconds> part_times_;
+    bool part_size_changed_ = false;
+    knp::backends::cpu::SharedImpactMessages impact_messages_;
+    // Impact message parts, used if there are many impacts.
+    std::vector<knp::backends::cpu::ImpactBuckets> impact_parts_;
+    // Output buffers of population parts and neuron parts. Each part is calculated by a single task.
+    std::vector<knp::core::messaging::SpikeData> spike_buffers_;
+    std::vector<std::vector<size_t>> neuron_buffers_;
+    size_t neuron_buffer_count_ = 0;
+    knp::backends::cpu::ResourceSTDPState<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *learning_state_ =
+        nullptr;
+    // Spike message sent to the message bus and its spikes, which share ownership of the message.
+    knp::core::messaging::SharedMessageVariant message_;
+    std::shared_ptr<knp::core::messaging::SpikeMessage> spikes_;
+};
+
+
+// Data of a projection used by tasks during a step.
+struct MultiThreadedCPUBackend::ProjectionStep
+{
+    cpu::SharedSpikeMessages messages_;
+    std::vector<std::pair<knp::core::messaging::SpikeIndex, size_t>> spikes_;
+    // Parts as `{index of the first spiking neuron, number of spiking neurons, number of synapses}`.
+    std::vector<std::tuple<size_t, size_t, size_t>> parts_;
+    std::vector<knp::backends::cpu::DelayedImpacts> impact_buffers_;
+    std::vector<std::chrono::nanoseconds> part_times_;
+};
+
+
 MultiThreadedCPUBackend::MultiThreadedCPUBackend(
-    size_t thread_count, size_t population_part_size, size_t projection_part_size)
-    : population_part_size_(population_part_size),
-      projection_part_size_(projection_part_size),
-      calc_pool_(std::make_unique<cpu_executors::ThreadPool>(
-          thread_count ? thread_count : std::thread::hardware_concurrency()))
+    size_t thread_count, size_t population_part_size, size_t projection_part_size, ExecutionMode execution_mode,
+    AffinityPolicy affinity_policy)
+    : population_part_size_(
+          auto_part_size == population_part_size ? default_population_part_size : population_part_size),
+      projection_part_size_(
+          auto_part_size == projection_part_size ? default_projection_part_size : projection_part_size),
+      tune_population_parts_(auto_part_size == population_part_size),
+      tune_projection_parts_(auto_part_size == projection_part_size),
+      calc_pool_(make_task_pool(
+          thread_count ? thread_count : std::thread::hardware_concurrency(), execution_mode, affinity_policy)),
+      // Threads process the same parts on every step only in the persistent workers mode.
+      run_by_levels_(ExecutionMode::task_graph != execution_mode),
+      place_memory_(
+          ExecutionMode::persistent_workers == execution_mode && AffinityPolicy::pinned == affinity_policy)
 {
     SPDLOG_INFO(
-        "Multi-threaded CPU backend instance created, thread count = {}.",
-        thread_count ? thread_count : std::thread::hardware_concurrency());
+        "Multi-threaded CPU backend instance created, thread count = {}, execution mode = {}.",
+        thread_count ? thread_count : std::thread::hardware_concurrency(),
+        get_execution_mode_name(execution_mode));
 }
 
 
+MultiThreadedCPUBackend::~MultiThreadedCPUBackend() = default;
+
+
 std::shared_ptr<MultiThreadedCPUBackend> MultiThreadedCPUBackend::create()
 {
     SPDLOG_DEBUG("Creating multi-threaded CPU backend instance...");
@@ -74,172 +251,707 @@ std::vector<std::string> MultiThreadedCPUBackend::get_supported_synapses() const
 }
 
 
-void MultiThreadedCPUBackend::calculate_populations_pre_impact()
+void MultiThreadedCPUBackend::prepare_step()
 {
-    for (auto &population : populations_)
+    if (part_size_tuners_outdated_) reset_part_size_tuners();
+    // Subscriptions can be changed between steps, senders are found again only if they were changed.
+    const size_t subscriptions_revision = get_message_endpoint().get_subscriptions_revision();
+    if (step_graphs_outdated_ || subscriptions_revision != subscriptions_revision_)
     {
-        auto pop_size = std::visit([](auto &pop) { return pop.size(); }, population);
-        for (size_t neuron_index = 0; neuron_index < pop_size; neuron_index += population_part_size_)
+        subscriptions_revision_ = subscriptions_revision;
+        auto projection_senders = find_projection_senders();
+        if (step_graphs_outdated_ || projection_senders != projection_senders_)
         {
-            std::visit(
-                [this, neuron_index](auto &pop)
-                {
-                    // Check if population is supported by backend. We don't need to repeat it.
-                    using T = std::decay_t<decltype(pop)>;
-                    if constexpr (
-                        boost::mp11::mp_find<SupportedPopulations, T>{} == boost::mp11::mp_size<SupportedPopulations>{})
-                    {
-                        static_assert(
-                            knp::meta::always_false_v<T>,
-                            "Population is not supported by the multi-threaded CPU backend.");
-                    }
-
-                    // Start threads.
-                    calc_pool_->post(
-                        knp::backends::cpu::calculate_neurons_state_part<typename T::PopulationNeuronType>,
-                        std::ref(pop), neuron_index, population_part_size_);
-                },
-                population);
+            projection_senders_ = std::move(projection_senders);
+            build_step_graphs();
         }
     }
-    // Wait for all threads to finish their work.
-    calc_pool_->join();
+    if (place_memory_ && memory_placement_outdated_) place_network_memory();
+}
+
+
+void MultiThreadedCPUBackend::reset_part_size_tuners()
+{
+    const size_t thread_count = std::max<size_t>(calc_pool_->get_thread_count(), 1);
+    population_tuners_.assign(
+        populations_.size(), cpu::PartSizeTuner(population_part_size_, thread_count, tune_population_parts_));
+    projection_tuners_.assign(
+        projections_.size(), cpu::PartSizeTuner(projection_part_size_, thread_count, tune_projection_parts_));
+    part_size_tuners_outdated_ = false;
+    // Memory is placed according to part sizes.
+    memory_placement_outdated_ = true;
 }
 
 
-void MultiThreadedCPUBackend::calculate_populations_impact()
+void MultiThreadedCPUBackend::place_network_memory()
 {
-    for (auto &population : populations_)
+    // Population parts are posted in the same order as by the first level of the step graph, so each part is placed by
+    // the thread that calculates it.
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
     {
-        auto uid = std::visit([](auto &population) { return population.get_uid(); }, population);
-        auto messages = get_message_endpoint().unload_messages<knp::core::messaging::SynapticImpactMessage>(uid);
+        auto &population = populations_[pop_index];
+        std::visit([](auto &pop) { knp::backends::cpu::prepare_neuron_columns(pop); }, population);
         std::visit(
-            [this, &messages](auto &pop)
+            [this, part_size = population_tuners_[pop_index].get_part_size()](auto &pop)
             {
                 using T = std::decay_t<decltype(pop)>;
-                calc_pool_->post(
-                    knp::backends::cpu::process_inputs<typename T::PopulationNeuronType>, std::ref(pop),
-                    std::move(messages));
+                for (size_t neuron_index = 0; neuron_index < pop.size(); neuron_index += part_size)
+                {
+                    calc_pool_->post(
+                        place_population_part<typename T::PopulationNeuronType>, std::ref(pop), neuron_index,
+                        part_size);
+                }
             },
             population);
     }
+
+    // Projection parts depend on spikes, so synapses are spread over all threads.
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
+    {
+        std::visit(
+            [this, part_size = projection_tuners_[proj_index].get_part_size()](const auto &proj)
+            {
+                using T = std::decay_t<decltype(proj)>;
+                // Index and synapse columns are built before the parallel part, so the tasks only read them.
+                proj.reindex();
+                if constexpr (!cpu::is_stdp_synapse_v<typename T::ProjectionSynapseType>)
+                {
+                    (void)proj.get_synapse_columns();
+                }
+                for (size_t synapse_index = 0; synapse_index < proj.size(); synapse_index += part_size)
+                {
+                    calc_pool_->post(
+                        place_projection_part<typename T::ProjectionSynapseType>, std::cref(proj), synapse_index,
+                        part_size);
+                }
+            },
+            projections_[proj_index].arg_);
+    }
     calc_pool_->join();
+    memory_placement_outdated_ = false;
 }
 
 
-std::vector<knp::core::messaging::SpikeMessage> MultiThreadedCPUBackend::calculate_populations_post_impact()
+std::vector<std::optional<std::vector<size_t>>> MultiThreadedCPUBackend::find_projection_senders() const
+{
+    std::unordered_map<knp::core::UID, size_t, knp::core::uid_hash> population_indexes;
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        population_indexes[std::visit([](const auto &pop) { return pop.get_uid(); }, populations_[pop_index])] =
+            pop_index;
+    }
+
+    constexpr size_t spike_message_index = knp::core::MessageEndpoint::get_type_index<
+        knp::core::messaging::MessageVariant, knp::core::messaging::SpikeMessage>;
+    const auto &subscriptions = get_message_endpoint().get_endpoint_subscriptions();
+    std::vector<std::optional<std::vector<size_t>>> result(projections_.size(), std::vector<size_t>{});
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
+    {
+        auto uid = std::visit([](const auto &proj) { return proj.get_uid(); }, projections_[proj_index].arg_);
+        auto subscription = subscriptions.find(std::make_pair(spike_message_index, uid));
+        if (subscription == subscriptions.end()) continue;
+
+        auto &senders = result[proj_index];
+        for (const auto &sender_uid :
+             std::get<knp::core::Subscription<knp::core::messaging::SpikeMessage>>(subscription->second).get_senders())
+        {
+            auto sender = population_indexes.find(knp::core::UID(sender_uid));
+            if (sender == population_indexes.end())
+            {
+                senders.reset();
+                break;
+            }
+            senders->push_back(sender->second);
+        }
+        // Spikes are passed in the order they are sent.
+        if (senders) std::sort(senders->begin(), senders->end());
+    }
+    return result;
+}
+
+
+void MultiThreadedCPUBackend::build_step_graphs()
+{
+    using ResourcePopulation = knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+    using ResourceProjection = knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>;
+    using BaseNeuron = knp::neuron_traits::BLIFATNeuron;
+    using ResourceSynapse = knp::synapse_traits::SynapticResourceSTDPDeltaSynapse;
+
+    internal_graph_.clear();
+    external_graph_.clear();
+    population_steps_.resize(populations_.size());
+    projection_steps_.resize(projections_.size());
+
+    // Nodes before impacts are added first, so in the persistent workers mode their parts are calculated by the same
+    // threads that placed them in memory.
+    std::vector<size_t> pre_impact_nodes;
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        pre_impact_nodes.push_back(internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks) { start_pre_impact(tasks, pop_index); },
+            [this, pop_index] { finish_pre_impact(pop_index); }));
+    }
+
+    // Nodes that calculate spikes of populations and nodes that finish training of resource STDP populations.
+    std::vector<size_t> spike_nodes;
+    std::unordered_map<knp::core::UID, size_t, knp::core::uid_hash> learning_nodes;
+    for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
+    {
+        const size_t grouping_node = internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks) { start_impact_grouping(tasks, pop_index); });
+        const size_t impact_node = internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks) { start_impact(tasks, pop_index); },
+            [this, pop_index] { finish_impact(pop_index); });
+        internal_graph_.add_dependency(impact_node, pre_impact_nodes[pop_index]);
+        internal_graph_.add_dependency(impact_node, grouping_node);
+        const size_t post_impact_node = internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks) { start_post_impact(tasks, pop_index); },
+            [this, pop_index] { finish_post_impact(pop_index); });
+        internal_graph_.add_dependency(post_impact_node, impact_node);
+        spike_nodes.push_back(post_impact_node);
+
+        const auto *population = std::get_if<ResourcePopulation>(&populations_[pop_index]);
+        if (!population) continue;
+
+        // 1. Process spiking neurons.
+        const size_t spiking_node = internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks)
+            {
+                start_plasticity_stage(
+                    tasks, pop_index, population_steps_[pop_index].spikes_->neuron_indexes_,
+                    knp::backends::cpu::process_spiking_neurons_part<BaseNeuron, ResourceSynapse>);
+            },
+            [this, pop_index] { finish_plasticity_stage(pop_index, false); });
+        internal_graph_.add_dependency(spiking_node, post_impact_node);
+        // 2. Do dopamine plasticity.
+        const size_t dopamine_node = internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks)
+            {
+                start_plasticity_stage(
+                    tasks, pop_index, population_steps_[pop_index].learning_state_->dopamine_neurons_.get_indexes(),
+                    knp::backends::cpu::do_dopamine_plasticity_part<BaseNeuron, ResourceSynapse>);
+            },
+            [this, pop_index] { finish_plasticity_stage(pop_index, false); });
+        internal_graph_.add_dependency(dopamine_node, spiking_node);
+        // 3. Renormalize resources if needed.
+        const size_t renormalization_node = internal_graph_.add_node(
+            [this, pop_index](NodeTasks &tasks)
+            {
+                auto &learning_state = *population_steps_[pop_index].learning_state_;
+                learning_state.dopamine_neurons_.clear();
+                start_plasticity_stage(
+                    tasks, pop_index, learning_state.resource_neurons_.get_indexes(),
+                    knp::backends::cpu::renormalize_resource_part<BaseNeuron, ResourceSynapse>);
+            },
+            [this, pop_index] { finish_plasticity_stage(pop_index, true); });
+        internal_graph_.add_dependency(renormalization_node, dopamine_node);
+        learning_nodes[population->get_uid()] = renormalization_node;
+    }
+
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
+    {
+        if (!projection_senders_[proj_index])
+        {
+            add_projection_nodes(external_graph_, proj_index, {});
+            continue;
+        }
+
+        std::vector<size_t> dependencies;
+        for (const auto pop_index : *projection_senders_[proj_index]) dependencies.push_back(spike_nodes[pop_index]);
+        // Synapses trained by a resource STDP population are used after the training.
+        if (const auto *projection = std::get_if<ResourceProjection>(&projections_[proj_index].arg_))
+        {
+            auto learning_node = learning_nodes.find(projection->get_postsynaptic());
+            if (learning_node != learning_nodes.end()) dependencies.push_back(learning_node->second);
+        }
+        add_projection_nodes(internal_graph_, proj_index, dependencies);
+    }
+    step_graphs_outdated_ = false;
+}
+
+
+void MultiThreadedCPUBackend::add_projection_nodes(
+    cpu_executors::TaskGraph &graph, size_t proj_index, const std::vector<size_t> &dependencies)
+{
+    const bool is_internal = projection_senders_[proj_index].has_value();
+    const bool is_stdp = std::visit(
+        [](const auto &proj)
+        { return cpu::is_stdp_synapse_v<typename std::decay_t<decltype(proj)>::ProjectionSynapseType>; },
+        projections_[proj_index].arg_);
+
+    // STDP rules change synapses of the whole projection, so they are applied by a single task per projection.
+    std::optional<size_t> stdp_node;
+    if (is_stdp)
+    {
+        stdp_node = graph.add_node(
+            [this, proj_index, is_internal](NodeTasks &tasks)
+            {
+                if (is_internal) receive_population_spikes(proj_index);
+                start_projection_stdp(tasks, proj_index);
+            });
+    }
+    const size_t impacts_node = graph.add_node(
+        [this, proj_index, receive_spikes = is_internal && !is_stdp](NodeTasks &tasks)
+        {
+            if (receive_spikes) receive_population_spikes(proj_index);
+            start_projection_impacts(tasks, proj_index);
+        },
+        [this, proj_index] { finish_projection_impacts(proj_index); });
+
+    const size_t first_node = stdp_node ? *stdp_node : impacts_node;
+    for (const auto dependency : dependencies) graph.add_dependency(first_node, dependency);
+    if (!stdp_node) return;
+
+    graph.add_dependency(impacts_node, *stdp_node);
+    // Weights changed by STDP rules after the impacts were calculated are used starting from the next step.
+    const size_t weights_node =
+        graph.add_node([this, proj_index](NodeTasks &tasks) { start_projection_weights(tasks, proj_index); });
+    graph.add_dependency(weights_node, impacts_node);
+}
+
+
+void MultiThreadedCPUBackend::prepare_populations_step()
 {
-    std::vector<knp::core::messaging::SpikeMessage> spike_container(populations_.size());
     for (size_t pop_index = 0; pop_index < populations_.size(); ++pop_index)
     {
         auto &population = populations_[pop_index];
-        auto &message = spike_container[pop_index];
-        message.header_.send_time_ = get_step();
-        message.header_.sender_uid_ = std::visit([](auto &population) { return population.get_uid(); }, population);
+        auto &population_step = population_steps_[pop_index];
+        const size_t pop_size = std::visit([](auto &pop) { return pop.size(); }, population);
+        population_step.part_size_ = population_tuners_[pop_index].get_part_size();
+        population_step.part_size_changed_ = false;
+
+        // Learning states are found before the graph is run, as they are stored in a common container.
+        auto uid = std::visit([](auto &pop) { return pop.get_uid(); }, population);
+        population_step.learning_state_ = get_resource_stdp_state(population);
+        if (population_step.learning_state_)
+        {
+            population_step.learning_state_->update_synapses(get_incoming_resource_stdp_projections(uid), pop_size);
+        }
 
-        const size_t population_size = std::visit([](auto &population) { return population.size(); }, population);
-        for (size_t neuron_index = 0; neuron_index < population_size; neuron_index += population_part_size_)
+        auto &messages = population_step.impact_messages_ =
+            get_message_endpoint().unload_shared_messages<knp::core::messaging::SynapticImpactMessage>(uid);
+        size_t impact_count = 0;
+        for (const auto &message : messages) impact_count += message->impacts_.size();
+
+        // Populations with more impacts than a population part are processed by parts. Impacts are grouped by neuron
+        // ranges of the population part size, so that ranges of a single population are processed in parallel.
+        // The population tuner part size is used, as bucketing cost depends on the population, not on projections.
+        population_step.impact_parts_.clear();
+        const size_t part_size = population_step.part_size_;
+        if (impact_count <= part_size) continue;
+        const size_t range_count = (pop_size + part_size - 1) / part_size;
+        for (const auto &message : messages)
         {
-            std::visit(
-                [this, &message, neuron_index](auto &pop)
-                {
-                    using T = std::decay_t<decltype(pop)>;
+            const size_t message_size = message->impacts_.size();
+            for (size_t impact_index = 0; impact_index < message_size; impact_index += part_size)
+            {
+                population_step.impact_parts_.push_back(
+                    {message.get(), impact_index, std::min(impact_index + part_size, message_size),
+                     std::vector<std::vector<const knp::core::messaging::SynapticImpact *>>(range_count)});
+            }
+        }
+    }
+}
+
+
+void MultiThreadedCPUBackend::start_pre_impact(NodeTasks &tasks, size_t pop_index)
+{
+    auto &population_step = population_steps_[pop_index];
+    const bool is_measuring = population_tuners_[pop_index].is_measuring();
+    std::visit(
+        [&tasks, &population_step, is_measuring](auto &pop)
+        {
+            // Check if population is supported by backend. We don't need to repeat it.
+            using T = std::decay_t<decltype(pop)>;
+            if constexpr (
+                boost::mp11::mp_find<SupportedPopulations, T>{} == boost::mp11::mp_size<SupportedPopulations>{})
+            {
+                static_assert(
+                    knp::meta::always_false_v<T>, "Population is not supported by the multi-threaded CPU backend.");
+            }
+
+            // Neuron columns must be prepared before parts are calculated in parallel.
+            knp::backends::cpu::prepare_neuron_columns(pop);
+            const size_t part_size = population_step.part_size_;
+            const size_t part_count = (pop.size() + part_size - 1) / part_size;
+            // Execution times of parts are stored while the part size is tuned.
+            if (is_measuring) population_step.part_times_.resize(part_count);
+            for (size_t part_index = 0; part_index < part_count; ++part_index)
+            {
+                tasks.post(
+                    [&pop, neuron_index = part_index * part_size, part_size,
+                     part_time = is_measuring ? &population_step.part_times_[part_index] : nullptr]
+                    {
+                        call_timed(
+                            [&pop, neuron_index, part_size]
+                            {
+                                knp::backends::cpu::calculate_neurons_state_part<typename T::PopulationNeuronType>(
+                                    pop, neuron_index, part_size);
+                            },
+                            part_time);
+                    });
+            }
+        },
+        populations_[pop_index]);
+}
+
+
+void MultiThreadedCPUBackend::finish_pre_impact(size_t pop_index)
+{
+    auto &tuner = population_tuners_[pop_index];
+    if (!tuner.is_measuring()) return;
+
+    auto &population_step = population_steps_[pop_index];
+    const size_t pop_size = std::visit([](auto &pop) { return pop.size(); }, populations_[pop_index]);
+    const size_t part_count = (pop_size + population_step.part_size_ - 1) / population_step.part_size_;
+    std::chrono::nanoseconds pop_time{0};
+    for (size_t part_index = 0; part_index < part_count; ++part_index)
+    {
+        pop_time += population_step.part_times_[part_index];
+    }
+    tuner.add_measurement(pop_time, pop_size);
+    // Parts are assigned to threads by their order, so memory must be placed again if part sizes change.
+    population_step.part_size_changed_ = tuner.finish_step();
+}
+
+
+void MultiThreadedCPUBackend::start_impact_grouping(NodeTasks &tasks, size_t pop_index)
+{
+    auto &population_step = population_steps_[pop_index];
+    for (auto &message_part : population_step.impact_parts_)
+    {
+        tasks.post(knp::backends::cpu::fill_impact_buckets, std::ref(message_part), population_step.part_size_);
+    }
+}
+
+
+void MultiThreadedCPUBackend::start_impact(NodeTasks &tasks, size_t pop_index)
+{
+    auto &population_step = population_steps_[pop_index];
+    auto *learning_state = population_step.learning_state_;
+    population_step.neuron_buffer_count_ = 0;
+
+    // Populations with few impacts are processed by a single task.
+    if (population_step.impact_parts_.empty())
+    {
+        std::visit(
+            [&tasks, &population_step, learning_state](auto &pop)
+            {
+                using T = std::decay_t<decltype(pop)>;
+                tasks.post(
+                    knp::backends::cpu::process_inputs<typename T::PopulationNeuronType>, std::ref(pop),
+                    std::cref(population_step.impact_messages_),
+                    learning_state ? &learning_state->dopamine_neurons_ : nullptr);
+            },
+            populations_[pop_index]);
+        return;
+    }
+
+    // Neuron ranges of a resource STDP population collect neurons receiving dopamine in their own buffers, as the
+    // dopamine set can't be changed concurrently.
+    const size_t range_count = population_step.impact_parts_.front().buckets_.size();
+    if (learning_state)
+    {
+        if (population_step.neuron_buffers_.size() < range_count) population_step.neuron_buffers_.resize(range_count);
+        population_step.neuron_buffer_count_ = range_count;
+    }
+    std::visit(
+        [&tasks, &population_step, range_count, has_learning_state = learning_state != nullptr](auto &pop)
+        {
+            using T = std::decay_t<decltype(pop)>;
+            for (size_t range_index = 0; range_index < range_count; ++range_index)
+            {
+                tasks.post(
+                    knp::backends::cpu::process_inputs_part<typename T::PopulationNeuronType>, std::ref(pop),
+                    std::cref(population_step.impact_parts_), range_index,
+                    has_learning_state ? &population_step.neuron_buffers_[range_index] : nullptr);
+            }
+        },
+        populations_[pop_index]);
+}
+
+
+void MultiThreadedCPUBackend::finish_impact(size_t pop_index)
+{
+    auto &population_step = population_steps_[pop_index];
+    for (size_t buffer_index = 0; buffer_index < population_step.neuron_buffer_count_; ++buffer_index)
+    {
+        for (const auto neuron_index : population_step.neuron_buffers_[buffer_index])
+        {
+            population_step.learning_state_->dopamine_neurons_.insert(neuron_index);
+        }
+    }
+}
+
+
+void MultiThreadedCPUBackend::start_post_impact(NodeTasks &tasks, size_t pop_index)
+{
+    auto &population_step = population_steps_[pop_index];
+    std::visit(
+        [&tasks, &population_step](auto &pop)
+        {
+            using T = std::decay_t<decltype(pop)>;
+            const size_t part_size = population_step.part_size_;
+            const size_t part_count = (pop.size() + part_size - 1) / part_size;
+            // Each part has its own output buffer, so no locks are needed.
+            if (population_step.spike_buffers_.size() < part_count) population_step.spike_buffers_.resize(part_count);
+            for (size_t part_index = 0; part_index < part_count; ++part_index)
+            {
 #if defined(_MSC_VER)
 #    pragma warning(push)
 #    pragma warning(disable : 4267)
 #endif
-                    calc_pool_->post(
-                        knp::backends::cpu::calculate_neurons_post_input_state_part<typename T::PopulationNeuronType>,
-                        std::ref(pop), std::ref(message), neuron_index, population_part_size_, std::ref(ep_mutex_));
-                },
-                population);
+                tasks.post(
+                    knp::backends::cpu::calculate_neurons_post_input_state_part<typename T::PopulationNeuronType>,
+                    std::ref(pop), std::ref(population_step.spike_buffers_[part_index]), part_index * part_size,
+                    part_size);
 #if defined(_MSC_VER)
 #    pragma warning(pop)
 #endif
-        }
-    }
-    calc_pool_->join();
-    return spike_container;
+            }
+        },
+        populations_[pop_index]);
 }
 
 
-void MultiThreadedCPUBackend::calculate_populations()
+void MultiThreadedCPUBackend::finish_post_impact(size_t pop_index)
 {
-    SPDLOG_DEBUG("Calculating populations...");
-    calculate_populations_pre_impact();
+    auto &population = populations_[pop_index];
+    auto &population_step = population_steps_[pop_index];
+    const size_t pop_size = std::visit([](auto &pop) { return pop.size(); }, population);
+    const size_t part_count = (pop_size + population_step.part_size_ - 1) / population_step.part_size_;
+
+    // The message is allocated once, both internal projections and the message bus share it.
+    auto message = std::make_shared<knp::core::messaging::MessageVariant>(knp::core::messaging::SpikeMessage{});
+    auto &spikes = std::get<knp::core::messaging::SpikeMessage>(*message);
+    spikes.header_.send_time_ = get_step();
+    spikes.header_.sender_uid_ = std::visit([](auto &pop) { return pop.get_uid(); }, population);
+    // Parts are ordered by neuron indexes, so the merged spike indexes are sorted.
+    cpu::concatenate_parts(
+        population_step.spike_buffers_.begin(), population_step.spike_buffers_.begin() + part_count,
+        spikes.neuron_indexes_);
+    population_step.spikes_ = std::shared_ptr<knp::core::messaging::SpikeMessage>(message, &spikes);
+    population_step.message_ = std::move(message);
+}
+
 
-    calculate_populations_impact();
+template <class Neurons, class PartFunction>
+void MultiThreadedCPUBackend::start_plasticity_stage(
+    NodeTasks &tasks, size_t pop_index, const Neurons &neurons, PartFunction part_function)
+{
+    using ResourcePopulation = knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+
+    // A neuron changes only its own synapses, so parts of different neurons are processed in parallel. Each part has
+    // its own output buffer, results are merged in the part order.
+    auto &population_step = population_steps_[pop_index];
+    const auto &synapses = population_step.learning_state_->synapses_;
+    NeuronParts parts;
+    add_neuron_parts(neurons, synapses, projection_part_size_, parts);
+    if (population_step.neuron_buffers_.size() < parts.size()) population_step.neuron_buffers_.resize(parts.size());
+    population_step.neuron_buffer_count_ = parts.size();
+
+    auto &population = std::get<ResourcePopulation>(populations_[pop_index]);
+    for (size_t part_index = 0; part_index < parts.size(); ++part_index)
+    {
+        tasks.post(
+            part_function, std::cref(neurons), std::cref(synapses), std::ref(population), get_step(),
+            std::ref(population_step.neuron_buffers_[part_index]), parts[part_index].first,
+            parts[part_index].second);
+    }
+}
 
-    auto spike_messages = calculate_populations_post_impact();
 
-    // Sending non-empty messages.
-    for (const auto &message : spike_messages)
+void MultiThreadedCPUBackend::finish_plasticity_stage(size_t pop_index, bool clear_resource_neurons)
+{
+    // Neurons that still need renormalization are kept in the part order.
+    auto &population_step = population_steps_[pop_index];
+    auto &resource_neurons = population_step.learning_state_->resource_neurons_;
+    if (clear_resource_neurons) resource_neurons.clear();
+    for (size_t buffer_index = 0; buffer_index < population_step.neuron_buffer_count_; ++buffer_index)
     {
-        if (message.neuron_indexes_.empty())
+        for (const auto neuron_index : population_step.neuron_buffers_[buffer_index])
         {
-            continue;
+            resource_neurons.insert(neuron_index);
         }
-        get_message_endpoint().send_message(message);
     }
+    // Weights are changed through synapse pointers, so projections are notified after the last stage.
+    if (clear_resource_neurons) population_step.learning_state_->synapses_.mark_synapses_modified();
 }
 
-template <class ProjectionWrapper>
-void send_message(ProjectionWrapper &projection, core::MessageEndpoint &endpoint, uint64_t step)
+
+void MultiThreadedCPUBackend::receive_population_spikes(size_t proj_index)
 {
-    auto &msg_queue = projection.messages_;
-    auto msg_iter = msg_queue.find(step);
-    if (msg_iter != msg_queue.end())
+    // Only non-empty messages are sent, and they are sent in the population order.
+    auto &messages = projection_steps_[proj_index].messages_;
+    messages.clear();
+    for (const auto pop_index : *projection_senders_[proj_index])
     {
-        endpoint.send_message(std::move(msg_iter->second));
-        msg_queue.erase(msg_iter);
+        const auto &spikes = population_steps_[pop_index].spikes_;
+        if (!spikes->neuron_indexes_.empty()) messages.push_back(spikes);
     }
 }
 
 
-void MultiThreadedCPUBackend::calculate_projections()
+void MultiThreadedCPUBackend::start_projection_stdp(NodeTasks &tasks, size_t proj_index)
 {
-    SPDLOG_DEBUG("Calculating projections...");
-    std::vector<std::unordered_map<uint64_t, size_t>> converted_message_buffer;
-    converted_message_buffer.reserve(projections_.size());
+    auto &projection_step = projection_steps_[proj_index];
+    if (projection_step.messages_.empty()) return;
+    std::visit(
+        [this, &tasks, &projection_step](auto &proj)
+        {
+            using T = std::decay_t<decltype(proj)>;
+            if constexpr (cpu::is_stdp_synapse_v<typename T::ProjectionSynapseType>)
+            {
+                tasks.post(
+                    cpu::init_stdp_projection<T>, std::ref(proj), std::ref(projection_step.messages_), get_step());
+            }
+        },
+        projections_[proj_index].arg_);
+}
 
-    for (auto &projection : projections_)
+
+void MultiThreadedCPUBackend::start_projection_impacts(NodeTasks &tasks, size_t proj_index)
+{
+    auto &projection_step = projection_steps_[proj_index];
+    projection_step.parts_.clear();
+    if (projection_step.messages_.empty()) return;
+
+    // Looping over spiking neurons, each part contains about the projection part size of synapses.
+    const auto &spikes = projection_step.spikes_ = cpu::count_spikes(projection_step.messages_);
+    const size_t part_size = projection_tuners_[proj_index].get_part_size();
+    std::visit(
+        [&spikes, &parts = projection_step.parts_, part_size](auto &proj)
+        {
+            using T = std::decay_t<decltype(proj)>;
+            // Index and synapse columns are built before the parallel part, so the tasks only read them.
+            proj.reindex();
+            if constexpr (!cpu::is_stdp_synapse_v<typename T::ProjectionSynapseType>)
+            {
+                (void)proj.get_synapse_columns();
+            }
+
+            size_t part_start = 0;
+            size_t part_synapses = 0;
+            for (size_t spike_index = 0; spike_index < spikes.size(); ++spike_index)
+            {
+                part_synapses += proj.synapses_of_presynaptic(spikes[spike_index].first).size();
+                if (part_synapses < part_size && spike_index + 1 < spikes.size()) continue;
+
+                parts.emplace_back(part_start, spike_index + 1 - part_start, part_synapses);
+                part_start = spike_index + 1;
+                part_synapses = 0;
+            }
+        },
+        projections_[proj_index].arg_);
+
+    // Each part has its own output buffer, so no locks are needed.
+    const size_t part_count = projection_step.parts_.size();
+    const bool is_measuring = projection_tuners_[proj_index].is_measuring();
+    if (projection_step.impact_buffers_.size() < part_count) projection_step.impact_buffers_.resize(part_count);
+    if (is_measuring) projection_step.part_times_.resize(part_count);
+    std::visit(
+        [this, &tasks, &projection_step, is_measuring](const auto &proj)
+        {
+            using T = std::decay_t<decltype(proj)>;
+            for (size_t part_index = 0; part_index < projection_step.parts_.size(); ++part_index)
+            {
+                tasks.post(
+                    [&proj, &spikes = projection_step.spikes_, &impacts = projection_step.impact_buffers_[part_index],
+                     step = get_step(), spike_start = std::get<0>(projection_step.parts_[part_index]),
+                     spike_count = std::get<1>(projection_step.parts_[part_index]),
+                     part_time = is_measuring ? &projection_step.part_times_[part_index] : nullptr]
+                    {
+                        call_timed(
+                            [&proj, &spikes, &impacts, step, spike_start, spike_count]
+                            {
+                                knp::backends::cpu::calculate_projection_spikes_part<typename T::ProjectionSynapseType>(
+                                    proj, spikes, impacts, step, spike_start, spike_count);
+                            },
+                            part_time);
+                    });
+            }
+        },
+        projections_[proj_index].arg_);
+}
+
+
+void MultiThreadedCPUBackend::finish_projection_impacts(size_t proj_index)
+{
+    auto &projection_step = projection_steps_[proj_index];
+    auto &tuner = projection_tuners_[proj_index];
+    const bool is_measuring = tuner.is_measuring();
+    // Impacts are merged in the part order, so their order doesn't depend on thread scheduling.
+    for (size_t part_index = 0; part_index < projection_step.parts_.size(); ++part_index)
     {
-        auto uid = std::visit([](auto &proj) { return proj.get_uid(); }, projection.arg_);
-        auto msg_buf = get_message_endpoint().unload_messages<knp::core::messaging::SpikeMessage>(uid);
-        // We might want to add some preliminary function before, even if delta projection doesn't require it.
-        if (msg_buf.empty())
+        projections_[proj_index].messages_.push(get_step(), projection_step.impact_buffers_[part_index]);
+        if (is_measuring)
         {
-            continue;
+            tuner.add_measurement(
+                projection_step.part_times_[part_index], std::get<2>(projection_step.parts_[part_index]));
         }
+    }
+    tuner.finish_step();
+}
 
-        // Looping over synapses.
-        converted_message_buffer.emplace_back(cpu::convert_spikes(msg_buf[0]));
-        const auto proj_size = std::visit([](const auto &proj) { return proj.size(); }, projection.arg_);
-        for (size_t synapse_index = 0; synapse_index < proj_size; synapse_index += projection_part_size_)
+
+void MultiThreadedCPUBackend::start_projection_weights(NodeTasks &tasks, size_t proj_index)
+{
+    if (projection_steps_[proj_index].messages_.empty()) return;
+    std::visit(
+        [&tasks](auto &proj)
         {
-            std::visit(
-                [this, synapse_index, &converted_message_buffer, &projection](auto &proj)
-                {
-                    using T = std::decay_t<decltype(proj)>;
-                    calc_pool_->post(
-                        knp::backends::cpu::calculate_projection_part<typename T::ProjectionSynapseType>,
-                        std::ref(proj), std::ref(converted_message_buffer.back()), std::ref(projection.messages_),
-                        get_step(), synapse_index, projection_part_size_, std::ref(ep_mutex_));
-                },
-                projection.arg_);
+            using SynapseType = typename std::decay_t<decltype(proj)>::ProjectionSynapseType;
+            if constexpr (cpu::is_stdp_synapse_v<SynapseType>)
+            {
+                tasks.post(cpu::WeightUpdateSTDP<SynapseType>::modify_weights, std::ref(proj));
+            }
+        },
+        projections_[proj_index].arg_);
+}
+
+
+void MultiThreadedCPUBackend::calculate_populations()
+{
+    SPDLOG_DEBUG("Calculating populations...");
+    prepare_step();
+    prepare_populations_step();
+    internal_graph_.run(*calc_pool_, run_by_levels_);
+
+    // Sending non-empty messages. Messages are sent after all populations are calculated, so their order doesn't
+    // depend on thread scheduling.
+    for (const auto &population_step : population_steps_)
+    {
+        if (population_step.part_size_changed_) memory_placement_outdated_ = true;
+        if (population_step.spikes_->neuron_indexes_.empty())
+        {
+            continue;
         }
+        get_message_endpoint().send_message(population_step.message_);
     }
-    calc_pool_->join();
+}
+
+
+void MultiThreadedCPUBackend::calculate_projections()
+{
+    SPDLOG_DEBUG("Calculating projections...");
+    if (step_graphs_outdated_) prepare_step();
+    for (size_t proj_index = 0; proj_index < projections_.size(); ++proj_index)
+    {
+        auto uid = std::visit([](auto &proj) { return proj.get_uid(); }, projections_[proj_index].arg_);
+        auto messages = get_message_endpoint().unload_shared_messages<knp::core::messaging::SpikeMessage>(uid);
+        // Projections that receive spikes only from backend populations were calculated together with the
+        // populations, so routed copies of the spikes are dropped.
+        if (!projection_senders_[proj_index]) projection_steps_[proj_index].messages_ = std::move(messages);
+    }
+    external_graph_.run(*calc_pool_, run_by_levels_);
+
     // Sending messages. It might be possible to parallelize this as well if we use more than one endpoint.
     for (auto &projection : projections_)
     {
-        auto &msg_queue = projection.messages_;
-        auto msg_iter = msg_queue.find(get_step());
-        if (msg_iter != msg_queue.end())
-        {
-            get_message_endpoint().send_message(std::move(msg_iter->second));
-            msg_queue.erase(msg_iter);
-        }
+        std::visit(
+            [this, &projection](const auto &proj)
+            { cpu::send_step_impacts(proj, projection.messages_, get_message_endpoint(), get_step()); },
+            projection.arg_);
     }
 }
 
@@ -282,6 +994,10 @@ void MultiThreadedCPUBackend::load_populations(const std::vector<PopulationVaria
     {
         populations_.push_back(population);
     }
+    // Learning states refer to the previous neuron parameters.
+    resource_stdp_states_.clear();
+    part_size_tuners_outdated_ = true;
+    step_graphs_outdated_ = true;
     SPDLOG_DEBUG("All populations loaded.");
 }
 
@@ -294,8 +1010,12 @@ void MultiThreadedCPUBackend::load_projections(const std::vector<ProjectionVaria
 
     for (const auto &projection : projections)
     {
-        projections_.push_back(ProjectionWrapper{projection});
+        projections_.push_back(ProjectionWrapper{
+            projection, std::visit([](const auto &proj) { return cpu::create_message_queue(proj); }, projection)});
     }
+    incoming_projections_outdated_ = true;
+    part_size_tuners_outdated_ = true;
+    step_graphs_outdated_ = true;
 
     SPDLOG_DEBUG("All projections loaded.");
 }
@@ -305,6 +1025,9 @@ void MultiThreadedCPUBackend::load_all_projections(const std::vector<knp::core::
 {
     SPDLOG_DEBUG("Loading projections [{}]...", projections.size());
     knp::meta::load_from_container<SupportedProjections>(projections, projections_);
+    incoming_projections_outdated_ = true;
+    part_size_tuners_outdated_ = true;
+    step_graphs_outdated_ = true;
     SPDLOG_DEBUG("All projections loaded.");
 }
 
@@ -313,6 +1036,9 @@ void MultiThreadedCPUBackend::load_all_populations(const std::vector<knp::core::
 {
     SPDLOG_DEBUG("Loading populations [{}]...", populations.size());
     knp::meta::load_from_container<SupportedPopulations>(populations, populations_);
+    resource_stdp_states_.clear();
+    part_size_tuners_outdated_ = true;
+    step_graphs_outdated_ = true;
     SPDLOG_DEBUG("All populations loaded.");
 }
 
@@ -339,12 +1065,54 @@ void MultiThreadedCPUBackend::_init()
 {
     SPDLOG_DEBUG("Initializing multi-threaded CPU backend...");
 
+    // Synapses could be changed through references kept since loading, so synapse columns are rebuilt.
+    for (auto &projection : projections_)
+    {
+        std::visit([](auto &proj) { proj.mark_synapses_modified(); }, projection.arg_);
+    }
     knp::backends::cpu::init(projections_, get_message_endpoint());
+    incoming_resource_stdp_projections_ = knp::backends::cpu::group_projections_by_postsynaptic<
+        synapse_traits::SynapticResourceSTDPDeltaSynapse>(projections_);
+    resource_stdp_states_.clear();
+    incoming_projections_outdated_ = false;
+    step_graphs_outdated_ = true;
 
     SPDLOG_DEBUG("Initialization finished.");
 }
 
 
+std::vector<knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *> &
+MultiThreadedCPUBackend::get_incoming_resource_stdp_projections(const knp::core::UID &post_uid)
+{
+    if (incoming_projections_outdated_)
+    {
+        incoming_resource_stdp_projections_ = knp::backends::cpu::group_projections_by_postsynaptic<
+            synapse_traits::SynapticResourceSTDPDeltaSynapse>(projections_);
+        // Projections could be reloaded to the same addresses, so synapse pointers can't be checked.
+        resource_stdp_states_.clear();
+        incoming_projections_outdated_ = false;
+    }
+
+    // Operator `[]` adds an empty list for populations without incoming projections, so the search is done once.
+    return incoming_resource_stdp_projections_[post_uid];
+}
+
+
+knp::backends::cpu::ResourceSTDPState<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *
+MultiThreadedCPUBackend::get_resource_stdp_state(PopulationVariants &population)
+{
+    auto *resource_population =
+        std::get_if<knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>>(&population);
+    if (!resource_population) return nullptr;
+
+    // Projections are grouped before the state is found, as grouping resets learning states.
+    (void)get_incoming_resource_stdp_projections(resource_population->get_uid());
+    auto &state = resource_stdp_states_[resource_population->get_uid()];
+    state.prepare(resource_population->size());
+    return &state;
+}
+
+
 MultiThreadedCPUBackend::PopulationIterator MultiThreadedCPUBackend::begin_populations()
 {
     return populations_.begin();
@@ -21,7 +21,11 @@
 
 #pragma once
 
-#include <knp/backends/thread_pool/thread_pool.h>
+#include <knp/backends/cpu-library/impl/delay_queue.h>
+#include <knp/backends/cpu-library/impl/part_size_tuner.h>
+#include <knp/backends/cpu-library/impl/synaptic_resource_stdp_impl.h>
+#include <knp/backends/thread_pool/task_graph.h>
+#include <knp/backends/thread_pool/task_pool.h>
 #include <knp/core/backend.h>
 #include <knp/core/impexp.h>
 #include <knp/core/population.h>
@@ -31,6 +35,7 @@
 #include <knp/synapse-traits/all_traits.h>
 
 #include <memory>
+#include <optional>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -49,9 +54,9 @@
 namespace knp::backends::cpu_executors
 {
 /**
- * @brief The ThreadPool class is an internal thread pool class used for task scheduling.
+ * @brief The TaskPool class is an internal thread pool interface used for task scheduling.
  */
-class ThreadPool;
+class TaskPool;
 }  // namespace knp::backends::cpu_executors
 
 /**
@@ -60,15 +65,65 @@ class ThreadPool;
 namespace knp::backends::multi_threaded_cpu
 {
 /**
- * @brief Default size of a population part that is processed in a single thread.
+ * @brief Part size value that enables automatic tuning of part sizes.
+ * @see knp::backends::cpu::PartSizeTuner.
+ */
+const size_t auto_part_size = 0;
+
+/**
+ * @brief Size of a population part that is processed in a single thread, used until part sizes are tuned.
  */
 const size_t default_population_part_size = 1000;
 
 /**
- * @brief Default size of a projection part that is processed in a single thread.
+ * @brief Size of a projection part that is processed in a single thread, used until part sizes are tuned.
  */
 const size_t default_projection_part_size = 1000;
 
+/**
+ * @brief Ways of distributing backend tasks among threads.
+ */
+enum class ExecutionMode
+{
+    /**
+     * @brief Tasks are queued to threads and idle threads steal tasks from busy ones.
+     * @details Calculation is split into phases, each phase waits until the previous one is finished for all
+     * populations and projections.
+     */
+    work_stealing,
+    /**
+     * @brief Each thread executes the same population and projection parts on every step.
+     * @details Threads stay resident between calculation phases and are synchronized by a barrier that spins before
+     * blocking. The mode reduces synchronization latency for small networks if every thread has its own processor core.
+     */
+    persistent_workers,
+    /**
+     * @brief Tasks are queued to threads as in the `work_stealing` mode, but without phases common to the network.
+     * @details Each calculation stage of a population or a projection starts as soon as the stages it depends on are
+     * finished. For example, a projection is calculated right after its presynaptic population, so independent parts of
+     * a wide network are calculated concurrently and threads don't wait for the slowest population of each phase.
+     */
+    task_graph
+};
+
+/**
+ * @brief Policies of binding backend threads and network memory to processors.
+ */
+enum class AffinityPolicy
+{
+    /**
+     * @brief Threads are scheduled by the operating system, network memory is not moved.
+     */
+    none,
+    /**
+     * @brief Worker threads are pinned to different processors.
+     * @details In the `ExecutionMode::persistent_workers` mode, memory of each population part is also moved to the
+     * NUMA node of the thread that calculates the part, and synapses of projections are spread over the nodes of all
+     * threads. Memory is moved at the first step after the network is loaded.
+     */
+    pinned
+};
+
 /**
  * @brief The MultiThreadedCPUBackend class is a definition of an interface to the multi-threaded CPU backend.
  */
@@ -78,12 +133,16 @@ public:
     /**
      * @brief List of neuron types supported by the multi-threaded CPU backend.
      */
-    using SupportedNeurons = boost::mp11::mp_list<knp::neuron_traits::BLIFATNeuron>;
+    using SupportedNeurons = boost::mp11::mp_list<
+        knp::neuron_traits::BLIFATNeuron, knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron,
+        knp::neuron_traits::BLIFATFloatNeuron>;
 
     /**
      * @brief List of synapse types supported by the multi-threaded CPU backend.
      */
-    using SupportedSynapses = boost::mp11::mp_list<knp::synapse_traits::DeltaSynapse>;
+    using SupportedSynapses = boost::mp11::mp_list<
+        knp::synapse_traits::DeltaSynapse, knp::synapse_traits::AdditiveSTDPDeltaSynapse,
+        knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>;
 
     /**
      * @brief List of supported population types based on neuron types specified in `SupportedNeurons`.
@@ -120,7 +179,7 @@ private:
     {
         ProjectionVariants arg_;
         // cppcheck-suppress unusedStructMember
-        std::unordered_map<uint64_t, knp::core::messaging::SynapticImpactMessage> messages_;
+        knp::backends::cpu::MessageQueue messages_;
     };
 
 public:
@@ -164,18 +223,26 @@ public:
     /**
      * @brief Default constructor for multi-threaded CPU backend.
      * @param thread_count number of threads.
-     * @param population_part_size number of synapses that are calculated in a single thread.
-     * @param projection_part_size number of neurons that are calculated in a single thread.
+     * @param population_part_size number of neurons that are calculated in a single thread. If the value equals
+     * `auto_part_size`, part size of each population is tuned by measuring calculation time at the first steps after
+     * the network is loaded.
+     * @param projection_part_size number of synapses that are calculated in a single thread. If the value equals
+     * `auto_part_size`, part size of each projection is tuned by measuring calculation time at the first steps with
+     * spikes after the network is loaded.
+     * @param execution_mode way of distributing tasks among threads.
+     * @param affinity_policy policy of binding threads and network memory to processors.
      * @note If `thread_count` equals `0`, then the number of threads is calculated automatically.
      */
     explicit MultiThreadedCPUBackend(
-        size_t thread_count = 0, size_t population_part_size = default_population_part_size,
-        size_t projection_part_size = default_projection_part_size);
+        size_t thread_count = 0, size_t population_part_size = auto_part_size,
+        size_t projection_part_size = auto_part_size,
+        ExecutionMode execution_mode = ExecutionMode::work_stealing,
+        AffinityPolicy affinity_policy = AffinityPolicy::none);
     /**
      * @brief Destructor for multi-threaded CPU backend.
      * @note All threads are stopped and joined on destruction by an internal thread pool object.
      */
-    ~MultiThreadedCPUBackend() override = default;
+    ~MultiThreadedCPUBackend() override;
 
 public:
     /**
@@ -308,12 +375,14 @@ public:
     void _step() override;
 
     /**
-     * @brief Calculate all populations.
+     * @brief Calculate all populations and send their spikes.
+     * @details Projections that receive spikes only from the backend populations are calculated together with
+     * populations, as they don't need routed messages.
      */
     void calculate_populations();
 
     /**
-     * @brief Calculate all projections.
+     * @brief Calculate projections that receive spikes from other senders, then send impacts of all projections.
      */
     void calculate_projections();
 
@@ -346,21 +415,103 @@ protected:
     void _init() override;
 
 private:
-    // Calculating pre-message neuron state, one thread per population_part_size_ neurons or less.
-    void calculate_populations_pre_impact();
-    // Processing messages, one thread per population, probably very hard to go deeper unless atomic neuron params.
-    void calculate_populations_impact();
+    struct PopulationStep;
+    struct ProjectionStep;
+    using NodeTasks = cpu_executors::TaskGraph::NodeTasks;
+
+    // Updating part sizes, step graphs and memory placement before a step.
+    void prepare_step();
+    // Creating part size tuners for loaded populations and projections.
+    void reset_part_size_tuners();
+    // Moving memory of population parts to NUMA nodes of threads that calculate them.
+    void place_network_memory();
+    // Finding populations that send spikes to each projection. A projection has no value if it receives spikes from
+    // senders that are not backend populations.
+    std::vector<std::optional<std::vector<size_t>>> find_projection_senders() const;
+    // Building graphs of step calculation stages from the network topology.
+    void build_step_graphs();
+    void add_projection_nodes(
+        cpu_executors::TaskGraph &graph, size_t proj_index, const std::vector<size_t> &dependencies);
+    // Collecting part sizes, impact messages and learning states of populations before the step graph is run.
+    void prepare_populations_step();
+
+    // Population calculation stages. Start functions post tasks of a single population, one task per population part.
+    // Calculating pre-message neuron state.
+    void start_pre_impact(NodeTasks &tasks, size_t pop_index);
+    void finish_pre_impact(size_t pop_index);
+    // Grouping impacts by population parts if there are many impacts.
+    void start_impact_grouping(NodeTasks &tasks, size_t pop_index);
+    // Processing messages, one task per population or per population part if there are many impacts.
+    void start_impact(NodeTasks &tasks, size_t pop_index);
+    void finish_impact(size_t pop_index);
     // Calculating post input changes and outputs.
-    std::vector<knp::core::messaging::SpikeMessage> calculate_populations_post_impact();
+    void start_post_impact(NodeTasks &tasks, size_t pop_index);
+    void finish_post_impact(size_t pop_index);
+    // Training resource STDP populations, one task per part of neurons with about projection_part_size_ synapses.
+    template <class Neurons, class PartFunction>
+    void start_plasticity_stage(NodeTasks &tasks, size_t pop_index, const Neurons &neurons, PartFunction part_function);
+    void finish_plasticity_stage(size_t pop_index, bool clear_resource_neurons);
+
+    // Projection calculation stages.
+    // Passing spikes of the current step from presynaptic populations to a projection.
+    void receive_population_spikes(size_t proj_index);
+    // Applying STDP rules before impacts are calculated.
+    void start_projection_stdp(NodeTasks &tasks, size_t proj_index);
+    // Calculating impacts, one task per part of spiking neurons with about the projection part size of synapses.
+    void start_projection_impacts(NodeTasks &tasks, size_t proj_index);
+    void finish_projection_impacts(size_t proj_index);
+    // Changing weights by STDP rules.
+    void start_projection_weights(NodeTasks &tasks, size_t proj_index);
+
+    // Get learning state of a resource STDP population or nullptr if the population doesn't have one.
+    knp::backends::cpu::ResourceSTDPState<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *
+    get_resource_stdp_state(PopulationVariants &population);
+    // Get all resource STDP projections with the given postsynaptic population, including locked ones.
+    std::vector<knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *> &
+    get_incoming_resource_stdp_projections(const knp::core::UID &post_uid);
+
     // cppcheck-suppress unusedStructMember
     PopulationContainer populations_;
     ProjectionContainer projections_;
+    // Fixed part sizes, or initial part sizes if parts are tuned.
     // cppcheck-suppress unusedStructMember
     const size_t population_part_size_;
     // cppcheck-suppress unusedStructMember
     const size_t projection_part_size_;
-    std::unique_ptr<cpu_executors::ThreadPool> calc_pool_;
-    std::mutex ep_mutex_;
+    // cppcheck-suppress unusedStructMember
+    const bool tune_population_parts_;
+    // cppcheck-suppress unusedStructMember
+    const bool tune_projection_parts_;
+    std::unique_ptr<cpu_executors::TaskPool> calc_pool_;
+    // cppcheck-suppress unusedStructMember
+    const bool run_by_levels_;
+    // Part sizes of populations and projections, with the same indexes as in `populations_` and `projections_`.
+    std::vector<knp::backends::cpu::PartSizeTuner> population_tuners_;
+    std::vector<knp::backends::cpu::PartSizeTuner> projection_tuners_;
+    bool part_size_tuners_outdated_ = true;
+    // cppcheck-suppress unusedStructMember
+    const bool place_memory_;
+    bool memory_placement_outdated_ = true;
+    // The first graph calculates populations and projections that receive spikes only from them, the second one
+    // calculates the other projections after messages are routed.
+    cpu_executors::TaskGraph internal_graph_;
+    cpu_executors::TaskGraph external_graph_;
+    bool step_graphs_outdated_ = true;
+    std::vector<std::optional<std::vector<size_t>>> projection_senders_;
+    // Revision of backend subscriptions used to find `projection_senders_`.
+    size_t subscriptions_revision_ = 0;
+    // Data used by tasks during a step, with the same indexes as in `populations_` and `projections_`.
+    std::vector<PopulationStep> population_steps_;
+    std::vector<ProjectionStep> projection_steps_;
+    // Resource STDP projections grouped by postsynaptic populations.
+    knp::backends::cpu::IncomingProjections<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>
+        incoming_resource_stdp_projections_;
+    // Learning states of resource STDP populations.
+    std::unordered_map<
+        knp::core::UID, knp::backends::cpu::ResourceSTDPState<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>,
+        knp::core::uid_hash>
+        resource_stdp_states_;
+    bool incoming_projections_outdated_ = true;
 };
 
 }  // namespace knp::backends::multi_threaded_cpu
@@ -153,6 +153,8 @@ void SingleThreadedCPUBackend::load_populations(const std::vector<PopulationVari
     {
         populations_.push_back(population);
     }
+    // Learning states refer to the previous neuron parameters.
+    resource_stdp_states_.clear();
     SPDLOG_DEBUG("All populations loaded.");
 }
 
@@ -165,8 +167,10 @@ void SingleThreadedCPUBackend::load_projections(const std::vector<ProjectionVari
 
     for (const auto &projection : projections)
     {
-        projections_.push_back(ProjectionWrapper{projection});
+        projections_.push_back(ProjectionWrapper{
+            projection, std::visit([](const auto &proj) { return cpu::create_message_queue(proj); }, projection)});
     }
+    incoming_projections_outdated_ = true;
 
     SPDLOG_DEBUG("All projections loaded.");
 }
@@ -176,6 +180,7 @@ void SingleThreadedCPUBackend::load_all_projections(const std::vector<knp::core:
 {
     SPDLOG_DEBUG("Loading projections [{}]...", projections.size());
     knp::meta::load_from_container<SupportedProjections>(projections, projections_);
+    incoming_projections_outdated_ = true;
     SPDLOG_DEBUG("All projections loaded.");
 }
 
@@ -184,6 +189,7 @@ void SingleThreadedCPUBackend::load_all_populations(const std::vector<knp::core:
 {
     SPDLOG_DEBUG("Loading populations [{}]...", populations.size());
     knp::meta::load_from_container<SupportedPopulations>(populations, populations_);
+    resource_stdp_states_.clear();
     SPDLOG_DEBUG("All populations loaded.");
 }
 
@@ -210,16 +216,58 @@ void SingleThreadedCPUBackend::_init()
 {
     SPDLOG_DEBUG("Initializing single-threaded CPU backend...");
 
+    // Synapses could be changed through references kept since loading, so synapse columns are rebuilt.
+    for (auto &projection : projections_)
+    {
+        std::visit([](auto &proj) { proj.mark_synapses_modified(); }, projection.arg_);
+    }
     knp::backends::cpu::init(projections_, get_message_endpoint());
+    incoming_resource_stdp_projections_ = knp::backends::cpu::group_projections_by_postsynaptic<
+        synapse_traits::SynapticResourceSTDPDeltaSynapse>(projections_);
+    resource_stdp_states_.clear();
+    incoming_projections_outdated_ = false;
 
     SPDLOG_DEBUG("Initialization finished.");
 }
 
 
+std::vector<knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *> &
+SingleThreadedCPUBackend::get_incoming_resource_stdp_projections(const knp::core::UID &post_uid)
+{
+    if (incoming_projections_outdated_)
+    {
+        incoming_resource_stdp_projections_ = knp::backends::cpu::group_projections_by_postsynaptic<
+            synapse_traits::SynapticResourceSTDPDeltaSynapse>(projections_);
+        // Projections could be reloaded to the same addresses, so synapse pointers can't be checked.
+        resource_stdp_states_.clear();
+        incoming_projections_outdated_ = false;
+    }
+
+    // Operator `[]` adds an empty list for populations without incoming projections, so the search is done once.
+    return incoming_resource_stdp_projections_[post_uid];
+}
+
+
 std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate_population(
     core::Population<knp::neuron_traits::BLIFATNeuron> &population)
 {
     SPDLOG_TRACE("Calculate BLIFAT population {}.", std::string(population.get_uid()));
+    if (lazy_neuron_update_)
+    {
+        return knp::backends::cpu::calculate_lazy_blifat_population(population, get_message_endpoint(), get_step());
+    }
+    return knp::backends::cpu::calculate_blifat_population(population, get_message_endpoint(), get_step());
+}
+
+
+std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate_population(
+    core::Population<knp::neuron_traits::BLIFATFloatNeuron> &population)
+{
+    SPDLOG_TRACE("Calculate single-precision BLIFAT population {}.", std::string(population.get_uid()));
+    if (lazy_neuron_update_)
+    {
+        return knp::backends::cpu::calculate_lazy_blifat_population(population, get_message_endpoint(), get_step());
+    }
     return knp::backends::cpu::calculate_blifat_population(population, get_message_endpoint(), get_step());
 }
 
@@ -228,9 +276,12 @@ std::optional<core::messaging::SpikeMessage> SingleThreadedCPUBackend::calculate
     knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron> &population)
 {
     SPDLOG_TRACE("Calculate resource-based STDP-compatible BLIFAT population {}.", std::string(population.get_uid()));
+    // Projections are grouped before the state is found, as grouping resets learning states.
+    auto &incoming_projections = get_incoming_resource_stdp_projections(population.get_uid());
     return knp::backends::cpu::calculate_resource_stdp_population<
-        neuron_traits::BLIFATNeuron, synapse_traits::DeltaSynapse, ProjectionContainer>(
-        population, projections_, get_message_endpoint(), get_step());
+        neuron_traits::BLIFATNeuron, synapse_traits::DeltaSynapse>(
+        population, incoming_projections, resource_stdp_states_[population.get_uid()], get_message_endpoint(),
+        get_step());
 }
 
 
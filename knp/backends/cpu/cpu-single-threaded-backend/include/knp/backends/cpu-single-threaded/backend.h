@@ -21,6 +21,8 @@
 
 #pragma once
 
+#include <knp/backends/cpu-library/impl/delay_queue.h>
+#include <knp/backends/cpu-library/impl/synaptic_resource_stdp_impl.h>
 #include <knp/core/backend.h>
 #include <knp/core/impexp.h>
 #include <knp/core/population.h>
@@ -55,8 +57,9 @@ public:
     /**
      * @brief List of neuron types supported by the single-threaded CPU backend.
      */
-    using SupportedNeurons =
-        boost::mp11::mp_list<knp::neuron_traits::BLIFATNeuron, knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+    using SupportedNeurons = boost::mp11::mp_list<
+        knp::neuron_traits::BLIFATNeuron, knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron,
+        knp::neuron_traits::BLIFATFloatNeuron>;
 
     /**
      * @brief List of synapse types supported by the single-threaded CPU backend.
@@ -102,7 +105,7 @@ private:
     {
         ProjectionVariants arg_;
         // cppcheck-suppress unusedStructMember
-        std::unordered_map<uint64_t, knp::core::messaging::SynapticImpactMessage> messages_;
+        knp::backends::cpu::MessageQueue messages_;
     };
 
 public:
@@ -307,11 +310,26 @@ public:
      */
     [[nodiscard]] DataRanges get_network_data() const override;
 
+    /**
+     * @brief Enable or disable lazy update mode for populations of BLIFAT neurons.
+     * @details In lazy update mode, quiescent neurons that receive no impacts are not calculated at every step, their
+     * states are advanced analytically when needed. Step cost of a population with low activity then depends on the
+     * number of impacts instead of the population size. Results can differ from the default mode by rounding errors.
+     * @param enable `true` to enable lazy update mode.
+     */
+    void set_lazy_neuron_update(bool enable) { lazy_neuron_update_ = enable; }
+
+    /**
+     * @brief Check if lazy update mode is enabled for populations of BLIFAT neurons.
+     * @return `true` if lazy update mode is enabled.
+     */
+    [[nodiscard]] bool is_lazy_neuron_update_enabled() const { return lazy_neuron_update_; }
+
 protected:
     /**
      * @brief Map used for message construction. It maps a message to its future output step.
      */
-    using SynapticMessageQueue = std::unordered_map<uint64_t, core::messaging::SynapticImpactMessage>;
+    using SynapticMessageQueue = knp::backends::cpu::MessageQueue;
 
     /**
      * @copydoc knp::core::Backend::_init()
@@ -327,6 +345,15 @@ protected:
     std::optional<core::messaging::SpikeMessage> calculate_population(
         knp::core::Population<knp::neuron_traits::BLIFATNeuron> &population);
 
+    /**
+     * @brief Calculate population of single-precision BLIFAT neurons.
+     * @note Population will be changed during calculation.
+     * @param population population to calculate.
+     * @return copy of a spike message if population is emitting one.
+     */
+    std::optional<core::messaging::SpikeMessage> calculate_population(
+        knp::core::Population<knp::neuron_traits::BLIFATFloatNeuron> &population);
+
     /**
      * @brief Calculate population of `SynapticResourceSTDPNeuron` neurons.
      * @note Population will be changed during calculation.
@@ -363,9 +390,30 @@ protected:
         SynapticMessageQueue &message_queue);
 
 private:
+    /**
+     * @brief Get resource STDP projections with the given postsynaptic population.
+     * @details The projections are grouped by postsynaptic populations once after projections are loaded.
+     * @param post_uid postsynaptic population UID.
+     * @return projections including locked ones.
+     */
+    std::vector<knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *> &
+    get_incoming_resource_stdp_projections(const knp::core::UID &post_uid);
+
     // cppcheck-suppress unusedStructMember
     PopulationContainer populations_;
     ProjectionContainer projections_;
+    // Resource STDP projections grouped by postsynaptic populations. Pointers refer to `projections_` elements.
+    std::unordered_map<
+        knp::core::UID, std::vector<knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse> *>,
+        knp::core::uid_hash>
+        incoming_resource_stdp_projections_;
+    // Learning states of resource STDP populations.
+    std::unordered_map<
+        knp::core::UID, knp::backends::cpu::ResourceSTDPState<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>,
+        knp::core::uid_hash>
+        resource_stdp_states_;
+    bool incoming_projections_outdated_ = true;
+    bool lazy_neuron_update_ = false;
 };
 
 }  // namespace knp::backends::single_threaded_cpu
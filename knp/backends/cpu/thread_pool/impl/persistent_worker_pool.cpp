@@ -0,0 +1,129 @@
+/**
+ * @file persistent_worker_pool.cpp
+ * @brief Persistent worker pool implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/persistent_worker_pool.h>
+#include <knp/backends/thread_pool/thread_affinity.h>
+
+#include <spdlog/spdlog.h>
+
+#include <utility>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+PersistentWorkerPool::PersistentWorkerPool(size_t num_threads, bool pin_threads, size_t spin_count)
+    : barrier_(num_threads + 1, spin_count)
+{
+    try
+    {
+        workers_.reserve(num_threads);
+        for (size_t worker_index = 0; worker_index < num_threads; ++worker_index)
+        {
+            workers_.emplace_back(&PersistentWorkerPool::work, this, worker_index + 1, pin_threads);
+        }
+    }
+    catch (...)
+    {
+        // Arrive for this thread and for the threads that were not created, so that the created ones stop.
+        stopping_ = true;
+        for (size_t participant_index = workers_.size(); participant_index <= num_threads; ++participant_index)
+            barrier_.arrive();
+        for (auto &worker : workers_) worker.join();
+        throw;
+    }
+}
+
+
+PersistentWorkerPool::~PersistentWorkerPool()
+{
+    try
+    {
+        join();
+    }
+    catch (...)
+    {
+    }
+    stop();
+}
+
+
+void PersistentWorkerPool::join()
+{
+    if (tasks_.empty()) return;
+
+    // Open the phase, execute own tasks and wait for workers.
+    barrier_.arrive_and_wait();
+    run_tasks(0);
+    barrier_.arrive_and_wait();
+    tasks_.clear();
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock(exception_mutex_);
+        std::swap(exception, exception_);
+    }
+    if (exception) std::rethrow_exception(exception);
+}
+
+
+void PersistentWorkerPool::run_tasks(size_t participant_index)
+{
+    const size_t participant_count = workers_.size() + 1;
+    for (size_t task_index = participant_index; task_index < tasks_.size(); task_index += participant_count)
+    {
+        try
+        {
+            tasks_[task_index]();
+        }
+        catch (...)
+        {
+            std::lock_guard lock(exception_mutex_);
+            if (!exception_) exception_ = std::current_exception();
+        }
+    }
+}
+
+
+void PersistentWorkerPool::work(size_t participant_index, bool pin_thread)
+{
+    if (pin_thread && !pin_worker_thread(participant_index - 1))
+    {
+        SPDLOG_WARN("Worker thread #{} was not pinned to a processor.", participant_index - 1);
+    }
+    while (true)
+    {
+        barrier_.arrive_and_wait();
+        if (stopping_) return;
+        run_tasks(participant_index);
+        barrier_.arrive_and_wait();
+    }
+}
+
+
+void PersistentWorkerPool::stop()
+{
+    stopping_ = true;
+    barrier_.arrive_and_wait();
+    for (auto &worker : workers_) worker.join();
+}
+}  // namespace knp::backends::cpu_executors
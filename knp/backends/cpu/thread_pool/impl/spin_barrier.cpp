@@ -0,0 +1,62 @@
+/**
+ * @file spin_barrier.cpp
+ * @brief Spin barrier implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/spin_barrier.h>
+
+#include <thread>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+void SpinBarrier::arrive()
+{
+    if (arrived_count_.fetch_add(1) + 1 != participant_count_) return;
+
+    arrived_count_.store(0);
+    generation_.fetch_add(1);
+    if (sleeping_count_.load() > 0)
+    {
+        std::lock_guard lock(mutex_);
+        condition_.notify_all();
+    }
+}
+
+
+void SpinBarrier::arrive_and_wait()
+{
+    // The generation can't change until this thread arrives.
+    const size_t generation = generation_.load();
+    arrive();
+
+    for (size_t spin = 0; spin < spin_count_; ++spin)
+    {
+        if (generation_.load() != generation) return;
+        std::this_thread::yield();
+    }
+
+    std::unique_lock lock(mutex_);
+    sleeping_count_.fetch_add(1);
+    condition_.wait(lock, [this, generation] { return generation_.load() != generation; });
+    sleeping_count_.fetch_sub(1);
+}
+}  // namespace knp::backends::cpu_executors
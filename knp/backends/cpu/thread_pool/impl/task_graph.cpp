@@ -0,0 +1,180 @@
+/**
+ * @file task_graph.cpp
+ * @brief Task graph implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/task_graph.h>
+
+#include <algorithm>
+#include <stdexcept>
+#include <utility>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+size_t TaskGraph::add_node(StartFunction start, FinishFunction finish)
+{
+    auto &node = nodes_.emplace_back();
+    node.start_ = std::move(start);
+    node.finish_ = std::move(finish);
+    levels_outdated_ = true;
+    return nodes_.size() - 1;
+}
+
+
+void TaskGraph::add_dependency(size_t node_index, size_t dependency_index)
+{
+    if (node_index >= nodes_.size() || dependency_index >= nodes_.size())
+    {
+        throw std::out_of_range("Task graph node index is out of range.");
+    }
+    nodes_[dependency_index].dependents_.push_back(node_index);
+    ++nodes_[node_index].dependency_count_;
+    levels_outdated_ = true;
+}
+
+
+void TaskGraph::clear()
+{
+    nodes_.clear();
+    levels_.clear();
+    levels_outdated_ = false;
+}
+
+
+void TaskGraph::run(TaskPool &pool, bool by_levels)
+{
+    if (levels_outdated_) update_levels();
+
+    by_levels_ = by_levels;
+    pool_ = &pool;
+    try
+    {
+        if (by_levels)
+            run_by_levels();
+        else
+            run_by_readiness();
+    }
+    catch (...)
+    {
+        pool_ = nullptr;
+        throw;
+    }
+    pool_ = nullptr;
+}
+
+
+void TaskGraph::update_levels()
+{
+    // Nodes are ordered topologically, a node level is the length of the longest path to it.
+    std::vector<size_t> node_levels(nodes_.size(), 0);
+    std::vector<size_t> remaining_dependencies(nodes_.size());
+    std::vector<size_t> ready_nodes;
+    for (size_t node_index = 0; node_index < nodes_.size(); ++node_index)
+    {
+        remaining_dependencies[node_index] = nodes_[node_index].dependency_count_;
+        if (!remaining_dependencies[node_index]) ready_nodes.push_back(node_index);
+    }
+
+    size_t ordered_count = 0;
+    size_t level_count = 0;
+    while (!ready_nodes.empty())
+    {
+        const size_t node_index = ready_nodes.back();
+        ready_nodes.pop_back();
+        ++ordered_count;
+        level_count = std::max(level_count, node_levels[node_index] + 1);
+        for (const auto dependent_index : nodes_[node_index].dependents_)
+        {
+            node_levels[dependent_index] = std::max(node_levels[dependent_index], node_levels[node_index] + 1);
+            if (!--remaining_dependencies[dependent_index]) ready_nodes.push_back(dependent_index);
+        }
+    }
+    if (ordered_count != nodes_.size()) throw std::logic_error("Task graph dependencies form a cycle.");
+
+    // Nodes of a level keep the order they were added in.
+    levels_.assign(level_count, {});
+    for (size_t node_index = 0; node_index < nodes_.size(); ++node_index)
+    {
+        levels_[node_levels[node_index]].push_back(node_index);
+    }
+    levels_outdated_ = false;
+}
+
+
+void TaskGraph::run_by_levels()
+{
+    for (const auto &level : levels_)
+    {
+        for (const auto node_index : level)
+        {
+            NodeTasks tasks(*this, node_index);
+            if (nodes_[node_index].start_) nodes_[node_index].start_(tasks);
+        }
+        pool_->join();
+        for (const auto node_index : level)
+        {
+            if (nodes_[node_index].finish_) nodes_[node_index].finish_();
+        }
+    }
+}
+
+
+void TaskGraph::run_by_readiness()
+{
+    for (auto &node : nodes_) node.remaining_dependencies_.store(node.dependency_count_);
+    for (size_t node_index = 0; node_index < nodes_.size(); ++node_index)
+    {
+        if (!nodes_[node_index].dependency_count_) pool_->post([this, node_index] { start_node(node_index); });
+    }
+    pool_->join();
+}
+
+
+void TaskGraph::start_node(size_t node_index)
+{
+    auto &node = nodes_[node_index];
+    // The start function holds one task, so the node is not finished while tasks are being posted.
+    node.remaining_tasks_.store(1);
+    NodeTasks tasks(*this, node_index);
+    if (node.start_) node.start_(tasks);
+    finish_task(node_index);
+}
+
+
+void TaskGraph::finish_task(size_t node_index)
+{
+    // Nodes run by levels are finished by the thread that runs the graph.
+    if (by_levels_) return;
+
+    auto &node = nodes_[node_index];
+    if (1 != node.remaining_tasks_.fetch_sub(1)) return;
+
+    if (node.finish_) node.finish_();
+    for (const auto dependent_index : node.dependents_)
+    {
+        if (1 == nodes_[dependent_index].remaining_dependencies_.fetch_sub(1))
+        {
+            pool_->post([this, dependent_index] { start_node(dependent_index); });
+        }
+    }
+}
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,136 @@
+/**
+ * @file thread_affinity.cpp
+ * @brief Thread and memory affinity functions implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/thread_affinity.h>
+
+#include <cstdint>
+#include <vector>
+
+#if defined(__linux__)
+#    include <sched.h>
+#    include <sys/syscall.h>
+#    include <unistd.h>
+#endif
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+#if defined(__linux__)
+
+namespace
+{
+// `MPOL_MF_MOVE` flag from `numaif.h`, defined here to avoid dependency on `libnuma`.
+constexpr int move_pages_flag = 1 << 1;
+
+
+
+// Get processors available to the calling thread.
+bool get_available_processors(cpu_set_t &available_processors)
+{
+    CPU_ZERO(&available_processors);
+    return 0 == sched_getaffinity(0, sizeof(available_processors), &available_processors);
+}
+}  // namespace
+
+
+bool pin_current_thread(size_t processor_number)
+{
+    cpu_set_t available_processors;
+    if (!get_available_processors(available_processors)) return false;
+
+    const auto processor_count = static_cast<size_t>(CPU_COUNT(&available_processors));
+    if (!processor_count) return false;
+
+    size_t skip_count = processor_number % processor_count;
+    for (int processor = 0; processor < CPU_SETSIZE; ++processor)
+    {
+        if (!CPU_ISSET(processor, &available_processors)) continue;
+        if (skip_count-- > 0) continue;
+
+        cpu_set_t processors;
+        CPU_ZERO(&processors);
+        CPU_SET(processor, &processors);
+        return 0 == sched_setaffinity(0, sizeof(processors), &processors);
+    }
+    return false;
+}
+
+
+bool pin_worker_thread(size_t worker_index)
+{
+    cpu_set_t available_processors;
+    if (!get_available_processors(available_processors)) return false;
+
+    const auto processor_count = static_cast<size_t>(CPU_COUNT(&available_processors));
+    return pin_current_thread(get_worker_processor_number(worker_index, processor_count));
+}
+
+
+void move_to_current_node(const void *data, size_t size)
+{
+    unsigned processor = 0;
+    unsigned node = 0;
+    if (syscall(SYS_getcpu, &processor, &node, nullptr) != 0) return;
+
+    const auto page_size = static_cast<uintptr_t>(sysconf(_SC_PAGESIZE));
+    const auto address = reinterpret_cast<uintptr_t>(data);
+    const uintptr_t range_start = (address + page_size - 1) / page_size * page_size;
+    const uintptr_t range_end = (address + size) / page_size * page_size;
+    if (range_start >= range_end) return;
+
+    std::vector<void *> pages;
+    for (uintptr_t page = range_start; page < range_end; page += page_size)
+    {
+        pages.push_back(reinterpret_cast<void *>(page));
+    }
+    const std::vector<int> nodes(pages.size(), static_cast<int>(node));
+    std::vector<int> statuses(pages.size());
+    // Errors are ignored: memory placement only affects performance.
+    (void)syscall(SYS_move_pages, 0, pages.size(), pages.data(), nodes.data(), statuses.data(), move_pages_flag);
+}
+
+#else
+
+bool pin_current_thread(size_t)
+{
+    return false;
+}
+
+
+bool pin_worker_thread(size_t)
+{
+    return false;
+}
+
+
+void move_to_current_node(const void *, size_t) {}
+
+#endif
+
+
+size_t get_worker_processor_number(size_t worker_index, size_t processor_count)
+{
+    if (processor_count < 2) return 0;
+    return 1 + worker_index % (processor_count - 1);
+}
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,267 @@
+/**
+ * @file work_stealing_thread_pool.cpp
+ * @brief Work-stealing thread pool implementation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#include <knp/backends/thread_pool/thread_affinity.h>
+#include <knp/backends/thread_pool/work_stealing_thread_pool.h>
+
+#include <spdlog/spdlog.h>
+
+#include <algorithm>
+#include <utility>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+namespace
+{
+// Number of attempts to find a task before a thread goes to sleep.
+constexpr size_t spin_count = 64;
+
+// Initial number of task slots in each queue, must be a power of two.
+constexpr size_t initial_queue_capacity = 256;
+
+// Pool and queue index of the current worker thread.
+thread_local const WorkStealingThreadPool *current_pool = nullptr;
+thread_local size_t current_queue_index = 0;
+}  // namespace
+
+
+WorkStealingThreadPool::TaskQueue::TaskQueue() : tasks_(initial_queue_capacity) {}
+
+
+void WorkStealingThreadPool::TaskQueue::push_back(InlineTask &&task)
+{
+    if (size_ == tasks_.size())
+    {
+        // Tasks are moved to the beginning of the new buffer in the queue order.
+        std::vector<InlineTask> tasks(tasks_.size() * 2);
+        for (size_t index = 0; index < size_; ++index)
+        {
+            tasks[index] = std::move(tasks_[(head_ + index) & (tasks_.size() - 1)]);
+        }
+        tasks_.swap(tasks);
+        head_ = 0;
+    }
+    tasks_[(head_ + size_) & (tasks_.size() - 1)] = std::move(task);
+    ++size_;
+}
+
+
+void WorkStealingThreadPool::TaskQueue::pop_front(InlineTask &task)
+{
+    task = std::move(tasks_[head_]);
+    head_ = (head_ + 1) & (tasks_.size() - 1);
+    --size_;
+}
+
+
+void WorkStealingThreadPool::TaskQueue::pop_back(InlineTask &task)
+{
+    --size_;
+    task = std::move(tasks_[(head_ + size_) & (tasks_.size() - 1)]);
+}
+
+
+WorkStealingThreadPool::WorkStealingThreadPool(size_t num_threads, bool pin_threads)
+    : queue_count_(std::max<size_t>(num_threads, 1)), queues_(std::make_unique<TaskQueue[]>(queue_count_))
+{
+    try
+    {
+        workers_.reserve(num_threads);
+        for (size_t worker_index = 0; worker_index < num_threads; ++worker_index)
+        {
+            workers_.emplace_back(&WorkStealingThreadPool::work, this, worker_index, pin_threads);
+        }
+    }
+    catch (...)
+    {
+        stop();
+        throw;
+    }
+}
+
+
+WorkStealingThreadPool::~WorkStealingThreadPool()
+{
+    stop();
+    // Without workers the remaining tasks are executed by the destructor.
+    while (run_next(0, false))
+    {
+    }
+}
+
+
+void WorkStealingThreadPool::join()
+{
+    while (pending_count_.load() > 0)
+    {
+        if (run_next(0, false)) continue;
+
+        // The remaining tasks are being executed by workers.
+        bool finished = false;
+        for (size_t spin = 0; spin < spin_count && !finished; ++spin)
+        {
+            std::this_thread::yield();
+            finished = 0 == pending_count_.load() || run_next(0, false);
+        }
+        if (finished) continue;
+
+        std::unique_lock lock(mutex_);
+        join_waiting_.store(true);
+        join_condition_.wait(lock, [this] { return 0 == pending_count_.load(); });
+        join_waiting_.store(false);
+    }
+
+    std::exception_ptr exception;
+    {
+        std::lock_guard lock(exception_mutex_);
+        std::swap(exception, exception_);
+    }
+    if (exception) std::rethrow_exception(exception);
+}
+
+
+void WorkStealingThreadPool::push(InlineTask &&task)
+{
+    const size_t queue_index = this == current_pool
+                                   ? current_queue_index
+                                   : next_queue_.fetch_add(1, std::memory_order_relaxed) % queue_count_;
+    auto &queue = queues_[queue_index];
+
+    pending_count_.fetch_add(1);
+    try
+    {
+        std::lock_guard lock(queue.mutex_);
+        queue.push_back(std::move(task));
+        queued_count_.fetch_add(1);
+    }
+    catch (...)
+    {
+        pending_count_.fetch_sub(1);
+        throw;
+    }
+
+    if (sleeping_count_.load() > 0)
+    {
+        std::lock_guard lock(mutex_);
+        work_condition_.notify_one();
+    }
+}
+
+
+bool WorkStealingThreadPool::pop(size_t queue_index, bool from_back, InlineTask &task)
+{
+    for (size_t offset = 0; offset < queue_count_; ++offset)
+    {
+        if (0 == queued_count_.load(std::memory_order_relaxed)) return false;
+
+        auto &queue = queues_[(queue_index + offset) % queue_count_];
+        std::lock_guard lock(queue.mutex_);
+        if (queue.empty()) continue;
+
+        // Tasks are stolen from the front of other queues.
+        if (from_back && 0 == offset)
+        {
+            queue.pop_back(task);
+        }
+        else
+        {
+            queue.pop_front(task);
+        }
+        queued_count_.fetch_sub(1);
+        return true;
+    }
+    return false;
+}
+
+
+bool WorkStealingThreadPool::run_next(size_t queue_index, bool from_back)
+{
+    InlineTask task;
+    if (!pop(queue_index, from_back, task)) return false;
+    run(task);
+    return true;
+}
+
+
+void WorkStealingThreadPool::run(InlineTask &task)
+{
+    try
+    {
+        task();
+    }
+    catch (...)
+    {
+        std::lock_guard lock(exception_mutex_);
+        if (!exception_) exception_ = std::current_exception();
+    }
+    task.reset();
+
+    if (1 == pending_count_.fetch_sub(1) && join_waiting_.load())
+    {
+        std::lock_guard lock(mutex_);
+        join_condition_.notify_all();
+    }
+}
+
+
+void WorkStealingThreadPool::work(size_t worker_index, bool pin_thread)
+{
+    if (pin_thread && !pin_worker_thread(worker_index))
+    {
+        SPDLOG_WARN("Worker thread #{} was not pinned to a processor.", worker_index);
+    }
+    current_pool = this;
+    current_queue_index = worker_index;
+
+    while (true)
+    {
+        if (run_next(worker_index, true)) continue;
+
+        bool found = false;
+        for (size_t spin = 0; spin < spin_count && !found; ++spin)
+        {
+            std::this_thread::yield();
+            found = run_next(worker_index, true);
+        }
+        if (found) continue;
+
+        std::unique_lock lock(mutex_);
+        sleeping_count_.fetch_add(1);
+        work_condition_.wait(lock, [this] { return stopping_ || queued_count_.load() > 0; });
+        sleeping_count_.fetch_sub(1);
+        if (stopping_ && 0 == queued_count_.load()) return;
+    }
+}
+
+
+void WorkStealingThreadPool::stop()
+{
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+        work_condition_.notify_all();
+    }
+    for (auto &worker : workers_) worker.join();
+}
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,172 @@
+/**
+ * @file inline_task.h
+ * @brief Move-only task wrapper that stores small functions without heap allocation.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief The InlineTask class is a move-only wrapper of a function without arguments.
+ * @details Functions that fit into `inline_size` bytes are stored inside the task object, larger functions are
+ * allocated on heap.
+ */
+class InlineTask
+{
+public:
+    /**
+     * @brief Size of buffer used to store functions inside the task.
+     */
+    static constexpr size_t inline_size = 112;
+
+    /**
+     * @brief Check if function of the given type is stored inside the task.
+     * @tparam Func function type.
+     */
+    template <class Func>
+    static constexpr bool is_stored_inline = sizeof(Func) <= inline_size &&
+                                             alignof(Func) <= alignof(std::max_align_t) &&
+                                             std::is_nothrow_move_constructible_v<Func>;
+
+    /**
+     * @brief Create an empty task.
+     */
+    InlineTask() = default;
+
+    /**
+     * @brief Create a task from function.
+     * @tparam Func function type.
+     * @param func function to call when the task is executed.
+     */
+    template <class Func, class = std::enable_if_t<!std::is_same_v<std::decay_t<Func>, InlineTask>>>
+    explicit InlineTask(Func &&func)
+    {
+        using Function = std::decay_t<Func>;
+        if constexpr (is_stored_inline<Function>)
+        {
+            new (&storage_) Function(std::forward<Func>(func));
+            invoke_ = [](void *storage) { (*static_cast<Function *>(storage))(); };
+            manage_ = [](Operation operation, void *storage, void *target) noexcept
+            {
+                auto *function = static_cast<Function *>(storage);
+                if (Operation::MOVE == operation) new (target) Function(std::move(*function));
+                function->~Function();
+            };
+        }
+        else
+        {
+            // The buffer stores a pointer to the function.
+            new (&storage_) Function *(new Function(std::forward<Func>(func)));
+            invoke_ = [](void *storage) { (**static_cast<Function **>(storage))(); };
+            manage_ = [](Operation operation, void *storage, void *target) noexcept
+            {
+                auto *function = *static_cast<Function **>(storage);
+                if (Operation::MOVE == operation)
+                    new (target) Function *(function);
+                else
+                    delete function;
+            };
+        }
+    }
+
+    /**
+     * @brief Move constructor.
+     * @param other task to move from. The task becomes empty.
+     */
+    InlineTask(InlineTask &&other) noexcept { take(other); }
+
+    /**
+     * @brief Move assignment operator.
+     * @param other task to move from. The task becomes empty.
+     * @return reference to this task.
+     */
+    InlineTask &operator=(InlineTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            reset();
+            take(other);
+        }
+        return *this;
+    }
+
+    InlineTask(const InlineTask &) = delete;
+    InlineTask &operator=(const InlineTask &) = delete;
+
+    /**
+     * @brief Destructor.
+     */
+    ~InlineTask() { reset(); }
+
+    /**
+     * @brief Call the stored function.
+     * @pre The task is not empty.
+     */
+    void operator()() { invoke_(&storage_); }
+
+    /**
+     * @brief Check if the task stores a function.
+     * @return `true` if the task is not empty.
+     */
+    explicit operator bool() const noexcept { return invoke_ != nullptr; }
+
+    /**
+     * @brief Destroy the stored function.
+     */
+    void reset() noexcept
+    {
+        if (!manage_) return;
+        manage_(Operation::DESTROY, &storage_, nullptr);
+        invoke_ = nullptr;
+        manage_ = nullptr;
+    }
+
+private:
+    enum class Operation
+    {
+        MOVE,
+        DESTROY
+    };
+
+    void take(InlineTask &other) noexcept
+    {
+        if (!other.manage_) return;
+        other.manage_(Operation::MOVE, &other.storage_, &storage_);
+        invoke_ = other.invoke_;
+        manage_ = other.manage_;
+        other.invoke_ = nullptr;
+        other.manage_ = nullptr;
+    }
+
+    alignas(std::max_align_t) unsigned char storage_[inline_size];
+    void (*invoke_)(void *storage) = nullptr;
+    // Moves function to target and destroys it in storage, or only destroys it.
+    void (*manage_)(Operation operation, void *storage, void *target) noexcept = nullptr;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,96 @@
+/**
+ * @file persistent_worker_pool.h
+ * @brief Fork-join thread pool that assigns tasks to threads by task index.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "spin_barrier.h"
+#include "task_pool.h"
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief The PersistentWorkerPool class is a definition of fork-join thread pool where each task has a fixed owner.
+ * @details Posted tasks are collected into a phase. `join()` opens the phase, and the thread that calls `join()`
+ * together with worker threads executes the phase tasks: a task with index `i` is executed by participant
+ * `i % (thread count + 1)`, where the calling thread is participant `0`. Participants meet at a spin barrier after the
+ * phase. If tasks are posted in the same order in every phase, each thread always processes the same data.
+ * Worker threads wait for the next phase at the same barrier, so dispatching a phase costs one barrier.
+ * @note Tasks must be posted and joined by the same thread. Tasks must not post tasks or call `join()`.
+ */
+class PersistentWorkerPool : public TaskPool
+{
+public:
+    /**
+     * @brief Create thread pool.
+     * @param num_threads number of worker threads in the pool. If the number is `0`, all tasks are executed by the
+     * thread that calls `join()`.
+     * @param pin_threads if `true`, worker threads are pinned to processors returned by
+     * `get_worker_processor_number()`. The thread that calls `join()` is not pinned, processor `0` is left for it.
+     * @param spin_count number of checks before a thread waiting at the barrier blocks.
+     */
+    explicit PersistentWorkerPool(
+        size_t num_threads = std::thread::hardware_concurrency(), bool pin_threads = false,
+        size_t spin_count = default_barrier_spin_count);
+
+    /**
+     * @brief Blocking destructor.
+     * @note The destructor executes the tasks that were posted but not joined, then joins worker threads.
+     */
+    ~PersistentWorkerPool() override;
+
+    PersistentWorkerPool(const PersistentWorkerPool &) = delete;
+    PersistentWorkerPool &operator=(const PersistentWorkerPool &) = delete;
+
+    void join() override;
+
+    [[nodiscard]] size_t get_thread_count() const override { return workers_.size(); }
+
+protected:
+    void push(InlineTask &&task) override { tasks_.push_back(std::move(task)); }
+
+private:
+    void run_tasks(size_t participant_index);
+
+    void work(size_t participant_index, bool pin_thread);
+
+    // Stop and join worker threads.
+    void stop();
+
+private:
+    std::vector<InlineTask> tasks_;
+    std::vector<std::thread> workers_;
+    SpinBarrier barrier_;
+    // Written before the barrier is opened, so workers read it without locking.
+    bool stopping_ = false;
+    std::mutex exception_mutex_;
+    std::exception_ptr exception_;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,82 @@
+/**
+ * @file spin_barrier.h
+ * @brief Reusable thread barrier that spins before blocking.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief Default number of checks that a thread waiting at a barrier makes before it blocks.
+ */
+constexpr size_t default_barrier_spin_count = 1024;
+
+/**
+ * @brief The SpinBarrier class is a definition of a reusable barrier for a fixed number of threads.
+ * @details A waiting thread checks the barrier state several times and yields between the checks. If the barrier is
+ * still closed, the thread blocks until the last thread arrives. Short waits don't involve the operating system, and
+ * long waits don't consume processor time.
+ */
+class SpinBarrier
+{
+public:
+    /**
+     * @brief Create barrier.
+     * @param participant_count number of threads that must arrive at the barrier to open it.
+     * @param spin_count number of checks before a waiting thread blocks.
+     */
+    explicit SpinBarrier(size_t participant_count, size_t spin_count = default_barrier_spin_count)
+        : participant_count_(participant_count), spin_count_(spin_count)
+    {
+    }
+
+    /**
+     * @brief Arrive at the barrier and wait until all participants arrive.
+     * @details After all participants arrive, the barrier can be used again.
+     */
+    void arrive_and_wait();
+
+    /**
+     * @brief Arrive at the barrier without waiting for other participants.
+     */
+    void arrive();
+
+private:
+    // cppcheck-suppress unusedStructMember
+    const size_t participant_count_;
+    // cppcheck-suppress unusedStructMember
+    const size_t spin_count_;
+    std::atomic<size_t> arrived_count_{0};
+    // Number of times the barrier was opened.
+    std::atomic<size_t> generation_{0};
+    std::atomic<size_t> sleeping_count_{0};
+    std::mutex mutex_;
+    std::condition_variable condition_;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,174 @@
+/**
+ * @file task_graph.h
+ * @brief Graph of dependent task groups executed by a task pool.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <vector>
+
+#include "task_pool.h"
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief The TaskGraph class is a definition of a graph of nodes, each node is a group of tasks.
+ * @details A node is started after all nodes it depends on are finished. The start function of a node posts any number
+ * of node tasks, then the node is finished after all its tasks are finished and its finish function is called.
+ * A graph can be run in two ways:
+ * - by levels: nodes with the same length of the longest dependency path are started one by one by the thread that
+ * runs the graph, then the pool is joined and finish functions are called in the same order. Tasks are posted in the
+ * same order on every run and tasks never post other tasks, so any task pool can be used.
+ * - by readiness: a node is started by a pool task as soon as its last dependency is finished, so independent paths of
+ * the graph overlap. The pool must allow tasks to post other tasks.
+ */
+class TaskGraph
+{
+public:
+    /**
+     * @brief The NodeTasks class is a definition of an interface to post tasks of a started node.
+     */
+    class NodeTasks
+    {
+    public:
+        /**
+         * @brief Add node task to pool.
+         * @tparam Func function type.
+         * @tparam Args function arguments.
+         * @param func task to run in the pool.
+         * @param args function arguments (if required, use `std::ref`).
+         */
+        template <class Func, typename... Args>
+        void post(Func func, Args... args)
+        {
+            graph_.post_task(node_index_, std::bind(func, args...));
+        }
+
+        /**
+         * @brief Get index of the started node.
+         * @return node index.
+         */
+        [[nodiscard]] size_t get_node_index() const { return node_index_; }
+
+    private:
+        friend class TaskGraph;
+        NodeTasks(TaskGraph &graph, size_t node_index) : graph_(graph), node_index_(node_index) {}
+
+        TaskGraph &graph_;
+        size_t node_index_;
+    };
+
+    /**
+     * @brief Type of functions that start nodes.
+     */
+    using StartFunction = std::function<void(NodeTasks &)>;
+
+    /**
+     * @brief Type of functions that finish nodes.
+     */
+    using FinishFunction = std::function<void()>;
+
+public:
+    /**
+     * @brief Add node to graph.
+     * @param start function that posts node tasks.
+     * @param finish function called after all node tasks are finished.
+     * @return node index.
+     */
+    size_t add_node(StartFunction start, FinishFunction finish = {});
+
+    /**
+     * @brief Make a node start only after another node is finished.
+     * @param node_index index of the dependent node.
+     * @param dependency_index index of the node to wait for.
+     */
+    void add_dependency(size_t node_index, size_t dependency_index);
+
+    /**
+     * @brief Remove all nodes.
+     */
+    void clear();
+
+    /**
+     * @brief Get number of nodes.
+     * @return number of nodes.
+     */
+    [[nodiscard]] size_t size() const { return nodes_.size(); }
+
+    /**
+     * @brief Execute all nodes of the graph and wait until they are finished.
+     * @param pool pool that executes tasks.
+     * @param by_levels if `true`, the graph is executed by levels, otherwise nodes are started by readiness.
+     * @throw std::logic_error if dependencies form a cycle.
+     * @throw any exception thrown by a node function or a task. Nodes that depend on a failed node are not started.
+     */
+    void run(TaskPool &pool, bool by_levels);
+
+private:
+    struct Node
+    {
+        StartFunction start_;
+        FinishFunction finish_;
+        std::vector<size_t> dependents_;
+        size_t dependency_count_ = 0;
+        // Counters of the current run.
+        std::atomic<size_t> remaining_dependencies_{0};
+        std::atomic<size_t> remaining_tasks_{0};
+    };
+
+    template <class Task>
+    void post_task(size_t node_index, Task task)
+    {
+        if (!by_levels_) nodes_[node_index].remaining_tasks_.fetch_add(1);
+        pool_->post(
+            [this, node_index, task]() mutable
+            {
+                task();
+                finish_task(node_index);
+            });
+    }
+
+    void update_levels();
+
+    void run_by_levels();
+
+    void run_by_readiness();
+
+    void start_node(size_t node_index);
+
+    void finish_task(size_t node_index);
+
+private:
+    // Nodes are not moved when the graph grows.
+    std::deque<Node> nodes_;
+    // Node indexes grouped by levels.
+    std::vector<std::vector<size_t>> levels_;
+    bool levels_outdated_ = false;
+    // Run mode and pool of the current run.
+    bool by_levels_ = false;
+    TaskPool *pool_ = nullptr;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,82 @@
+/**
+ * @file task_pool.h
+ * @brief Interface of fork-join thread pools used by CPU backends.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <functional>
+
+#include "inline_task.h"
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief The TaskPool class is a definition of the interface to fork-join thread pools.
+ * @details Tasks are posted to the pool, then `join()` waits until all posted tasks are finished.
+ */
+class TaskPool
+{
+public:
+    /**
+     * @brief Destructor.
+     */
+    virtual ~TaskPool() = default;
+
+    /**
+     * @brief Add task to pool.
+     * @tparam Func function type.
+     * @tparam Args function arguments.
+     * @param func task to run in the pool.
+     * @param args function arguments (if required, use `std::ref`).
+     * @note Non-blocking method.
+     */
+    template <class Func, typename... Args>
+    void post(Func func, Args... args)
+    {
+        push(InlineTask(std::bind(func, args...)));
+    }
+
+    /**
+     * @brief Wait until all posted tasks are finished.
+     * @details The calling thread executes tasks while waiting.
+     * @note Blocking method that waits indefinitely if at least one task never stops.
+     * @throw any exception thrown by a task since the previous call of `join()`. If several tasks throw exceptions,
+     * only the first one is rethrown.
+     */
+    virtual void join() = 0;
+
+    /**
+     * @brief Get number of worker threads.
+     * @return number of worker threads.
+     */
+    [[nodiscard]] virtual size_t get_thread_count() const = 0;
+
+protected:
+    /**
+     * @brief Add task to pool.
+     * @param task task to add.
+     */
+    virtual void push(InlineTask &&task) = 0;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,69 @@
+/**
+ * @file thread_affinity.h
+ * @brief Functions that bind threads and memory to processors.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstddef>
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief Pin the calling thread to a single processor.
+ * @param processor_number number of the processor among processors available to the thread. The number is taken
+ * modulo the number of available processors.
+ * @return `true` if the thread was pinned.
+ * @note Threads are pinned only on Linux, on other systems the function returns `false`.
+ */
+bool pin_current_thread(size_t processor_number);
+
+/**
+ * @brief Get number of the processor for a worker thread.
+ * @details Workers are spread over processors starting from processor `1`, as processor `0` is left for the thread
+ * that waits for the workers. If there are more workers than other processors, workers share them. Processor `0` is
+ * used only if it is the only available processor.
+ * @param worker_index index of the worker thread.
+ * @param processor_count number of available processors.
+ * @return number of the processor among available processors.
+ */
+size_t get_worker_processor_number(size_t worker_index, size_t processor_count);
+
+/**
+ * @brief Pin the calling worker thread to the processor returned by `get_worker_processor_number()`.
+ * @param worker_index index of the worker thread.
+ * @return `true` if the thread was pinned.
+ * @note Threads are pinned only on Linux, on other systems the function returns `false`.
+ */
+bool pin_worker_thread(size_t worker_index);
+
+/**
+ * @brief Move memory pages to the NUMA node of the processor that runs the calling thread.
+ * @details Only pages that lie entirely within the memory range are moved, so that threads that move adjacent ranges
+ * don't move the same page. Pages that can't be moved are left in place.
+ * @param data start of the memory range.
+ * @param size size of the memory range in bytes.
+ * @note Pages are moved only on Linux, on other systems the function does nothing.
+ */
+void move_to_current_node(const void *data, size_t size);
+
+}  // namespace knp::backends::cpu_executors
@@ -0,0 +1,130 @@
+/**
+ * @file work_stealing_thread_pool.h
+ * @brief Fork-join thread pool with per-worker task queues and work stealing.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "task_pool.h"
+
+
+/**
+ * @brief Namespace for CPU backend executors.
+ */
+namespace knp::backends::cpu_executors
+{
+/**
+ * @brief The WorkStealingThreadPool class is a definition of fork-join thread pool with work stealing.
+ * @details Each worker thread has its own task queue. Tasks posted from outside the pool are distributed among the
+ * queues in turn, tasks posted by a worker are added to the queue of that worker. A worker takes tasks from the back
+ * of its own queue and steals tasks from the front of other queues when its own queue is empty. The thread that calls
+ * `join()` also executes queued tasks until all posted tasks are finished.
+ * @note Only one thread at a time can call `join()`. Tasks must not call `join()`.
+ */
+class WorkStealingThreadPool : public TaskPool
+{
+public:
+    /**
+     * @brief Create thread pool.
+     * @param num_threads number of worker threads in the pool. If the number is `0`, all tasks are executed by the
+     * thread that calls `join()`.
+     * @param pin_threads if `true`, worker threads are pinned to processors returned by
+     * `get_worker_processor_number()`. The thread that calls `join()` is not pinned, processor `0` is left for it.
+     */
+    explicit WorkStealingThreadPool(
+        size_t num_threads = std::thread::hardware_concurrency(), bool pin_threads = false);
+
+    /**
+     * @brief Blocking destructor.
+     * @note The destructor waits until all queued tasks are executed, then joins worker threads.
+     */
+    ~WorkStealingThreadPool() override;
+
+    WorkStealingThreadPool(const WorkStealingThreadPool &) = delete;
+    WorkStealingThreadPool &operator=(const WorkStealingThreadPool &) = delete;
+
+    void join() override;
+
+    [[nodiscard]] size_t get_thread_count() const override { return workers_.size(); }
+
+protected:
+    void push(InlineTask &&task) override;
+
+private:
+    // Task queue stored in a ring buffer. Slots are allocated once and reused, the buffer grows only when it is full.
+    struct alignas(64) TaskQueue
+    {
+        TaskQueue();
+
+        [[nodiscard]] bool empty() const { return 0 == size_; }
+
+        void push_back(InlineTask &&task);
+
+        void pop_front(InlineTask &task);
+
+        void pop_back(InlineTask &task);
+
+        std::mutex mutex_;
+        // Tasks are stored in slots from `head_` to `head_ + size_` modulo the capacity, which is a power of two.
+        std::vector<InlineTask> tasks_;
+        size_t head_ = 0;
+        size_t size_ = 0;
+    };
+
+    // Take a task from the queue with the given index, then steal from the other queues.
+    bool pop(size_t queue_index, bool from_back, InlineTask &task);
+
+    bool run_next(size_t queue_index, bool from_back);
+
+    void run(InlineTask &task);
+
+    void work(size_t worker_index, bool pin_thread);
+
+    // Stop and join worker threads.
+    void stop();
+
+private:
+    // cppcheck-suppress unusedStructMember
+    const size_t queue_count_;
+    std::unique_ptr<TaskQueue[]> queues_;
+    std::vector<std::thread> workers_;
+    std::atomic<size_t> next_queue_{0};
+    // Number of tasks in all queues.
+    std::atomic<size_t> queued_count_{0};
+    // Number of tasks that are posted, but not finished.
+    std::atomic<size_t> pending_count_{0};
+    std::atomic<size_t> sleeping_count_{0};
+    std::atomic<bool> join_waiting_{false};
+    // Mutex used by sleeping threads.
+    std::mutex mutex_;
+    std::condition_variable work_condition_;
+    std::condition_variable join_condition_;
+    bool stopping_ = false;
+    std::mutex exception_mutex_;
+    std::exception_ptr exception_;
+};
+
+}  // namespace knp::backends::cpu_executors
@@ -107,6 +107,8 @@ std::vector<core::AllPopulationsVariant> load_populations(const fs::path &pop_h5
             result.emplace_back(load_population<neuron_traits::BLIFATNeuron>(group, proj_name));
         else if (proj_type == get_neuron_type_id<neuron_traits::SynapticResourceSTDPBLIFATNeuron>())
             result.emplace_back(load_population<neuron_traits::SynapticResourceSTDPBLIFATNeuron>(group, proj_name));
+        else if (proj_type == get_neuron_type_id<neuron_traits::BLIFATFloatNeuron>())
+            result.emplace_back(load_population<neuron_traits::BLIFATFloatNeuron>(group, proj_name));
         // TODO: Add other supported types or better use a template.
     }
     return result;
@@ -46,6 +46,7 @@ void add_population_to_h5(HighFive::File &, const Population &);
 
 
 // Read parameter values for both projections and populations.
+// A parameter shared by all elements is stored as a scalar attribute instead of a dataset.
 template <class Attr>
 std::vector<Attr> read_parameter(
     const HighFive::Group &population_group, const std::string &param_name, size_t pop_size, const Attr &default_value)
@@ -53,6 +54,12 @@ std::vector<Attr> read_parameter(
     std::vector<Attr> result(pop_size);
     try
     {
+        if (!population_group.exist(param_name) && population_group.hasAttribute(param_name))
+        {
+            Attr value;
+            population_group.getAttribute(param_name).read(value);
+            return std::vector(pop_size, value);
+        }
         auto dataset = population_group.getDataSet(param_name);
         dataset.read(result);
     }
@@ -75,3 +82,20 @@ std::vector<Attr> read_parameter(
             pop.begin(), pop.end(), std::back_inserter(data), [](const auto &neuron) { return neuron.param; }); \
         group.createDataSet(#param, data);                                                                      \
     } while (false)
+
+
+// Save a static parameter: a single attribute if all neurons share its value, a dataset otherwise.
+#define PUT_STATIC_NEURON_PARAMETER(pop, param, group)                                                          \
+    do                                                                                                          \
+    {                                                                                                           \
+        std::vector<decltype(pop.begin()->param)> data;                                                         \
+        data.reserve(pop.size());                                                                               \
+        std::transform(                                                                                         \
+            pop.begin(), pop.end(), std::back_inserter(data), [](const auto &neuron) { return neuron.param; }); \
+        if (!data.empty() && std::all_of(data.begin(), data.end(), [&data](const auto &value) {                 \
+                return value == data.front();                                                                   \
+            }))                                                                                                 \
+            group.createAttribute(#param, data.front());                                                        \
+        else                                                                                                    \
+            group.createDataSet(#param, data);                                                                  \
+    } while (false)
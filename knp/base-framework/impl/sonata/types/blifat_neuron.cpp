@@ -44,30 +44,38 @@ std::string get_neuron_type_name<neuron_traits::BLIFATNeuron>()
 }
 
 
-void save_static(const core::Population<knp::neuron_traits::BLIFATNeuron> &population, HighFive::Group &group)
+template <>
+std::string get_neuron_type_name<neuron_traits::BLIFATFloatNeuron>()
+{
+    return "knp:BasicBlifatFloatNeuron";
+}
+
+
+template <class Real>
+void save_static(const core::Population<knp::neuron_traits::BLIFATNeuronT<Real>> &population, HighFive::Group &group)
 {
-    // TODO: Need to check if all parameters are the same. If not, save them into h5.
     // Static.
     PUT_NEURON_TO_DATASET(population, n_time_steps_since_last_firing_, group);
-    PUT_NEURON_TO_DATASET(population, activation_threshold_, group);
-    PUT_NEURON_TO_DATASET(population, threshold_decay_, group);
-    PUT_NEURON_TO_DATASET(population, threshold_increment_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, activation_threshold_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, threshold_decay_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, threshold_increment_, group);
     PUT_NEURON_TO_DATASET(population, postsynaptic_trace_, group);
-    PUT_NEURON_TO_DATASET(population, postsynaptic_trace_decay_, group);
-    PUT_NEURON_TO_DATASET(population, postsynaptic_trace_increment_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, postsynaptic_trace_decay_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, postsynaptic_trace_increment_, group);
     PUT_NEURON_TO_DATASET(population, inhibitory_conductance_, group);
-    PUT_NEURON_TO_DATASET(population, inhibitory_conductance_decay_, group);
-    PUT_NEURON_TO_DATASET(population, potential_decay_, group);
-    PUT_NEURON_TO_DATASET(population, bursting_period_, group);
-    PUT_NEURON_TO_DATASET(population, reflexive_weight_, group);
-    PUT_NEURON_TO_DATASET(population, reversal_inhibitory_potential_, group);
-    PUT_NEURON_TO_DATASET(population, absolute_refractory_period_, group);
-    PUT_NEURON_TO_DATASET(population, potential_reset_value_, group);
-    PUT_NEURON_TO_DATASET(population, min_potential_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, inhibitory_conductance_decay_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, potential_decay_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, bursting_period_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, reflexive_weight_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, reversal_inhibitory_potential_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, absolute_refractory_period_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, potential_reset_value_, group);
+    PUT_STATIC_NEURON_PARAMETER(population, min_potential_, group);
 }
 
 
-void save_dynamic(const core::Population<knp::neuron_traits::BLIFATNeuron> &population, HighFive::Group &group)
+template <class Real>
+void save_dynamic(const core::Population<knp::neuron_traits::BLIFATNeuronT<Real>> &population, HighFive::Group &group)
 {
     PUT_NEURON_TO_DATASET(population, dynamic_threshold_, group);
     PUT_NEURON_TO_DATASET(population, potential_, group);
@@ -78,9 +86,8 @@ void save_dynamic(const core::Population<knp::neuron_traits::BLIFATNeuron> &popu
 }
 
 
-template <>
-void add_population_to_h5<core::Population<knp::neuron_traits::BLIFATNeuron>>(
-    HighFive::File &file_h5, const core::Population<knp::neuron_traits::BLIFATNeuron> &population)
+template <class Neuron>
+void add_blifat_population_to_h5(HighFive::File &file_h5, const core::Population<Neuron> &population)
 {
     SPDLOG_TRACE("Adding population {} to HDF5...", std::string(population.get_uid()));
 
@@ -93,7 +100,6 @@ void add_population_to_h5<core::Population<knp::neuron_traits::BLIFATNeuron>>(
     HighFive::Group population_group = file_h5.createGroup("nodes/" + std::string{population.get_uid()});
 
     std::vector<size_t> neuron_ids;
-    // std::vector<int> neuron_type_ids(population.size(), get_neuron_type_id<neuron_traits::BLIFATNeuron>());
     neuron_ids.reserve(population.size());
     for (size_t i = 0; i < population.size(); ++i) neuron_ids.push_back(i);
 
@@ -101,7 +107,7 @@ void add_population_to_h5<core::Population<knp::neuron_traits::BLIFATNeuron>>(
     population_group.createDataSet("node_group_index", neuron_ids);
     population_group.createDataSet("node_group_id", std::vector<size_t>(population.size(), 0));
     population_group.createDataSet(
-        "node_type_id", std::vector<size_t>(population.size(), get_neuron_type_id<neuron_traits::BLIFATNeuron>()));
+        "node_type_id", std::vector<size_t>(population.size(), get_neuron_type_id<Neuron>()));
     auto group0 = population_group.createGroup("0");
 
     save_static(population, group0);
@@ -113,46 +119,76 @@ void add_population_to_h5<core::Population<knp::neuron_traits::BLIFATNeuron>>(
 
 
 template <>
-core::Population<neuron_traits::BLIFATNeuron> load_population<neuron_traits::BLIFATNeuron>(
-    const HighFive::Group &nodes_group, const std::string &population_name)
+void add_population_to_h5<core::Population<knp::neuron_traits::BLIFATNeuron>>(
+    HighFive::File &file_h5, const core::Population<knp::neuron_traits::BLIFATNeuron> &population)
+{
+    add_blifat_population_to_h5(file_h5, population);
+}
+
+
+template <>
+void add_population_to_h5<core::Population<knp::neuron_traits::BLIFATFloatNeuron>>(
+    HighFive::File &file_h5, const core::Population<knp::neuron_traits::BLIFATFloatNeuron> &population)
+{
+    add_blifat_population_to_h5(file_h5, population);
+}
+
+
+template <class Neuron>
+core::Population<Neuron> load_blifat_population(const HighFive::Group &nodes_group, const std::string &population_name)
 {
     SPDLOG_DEBUG("Loading nodes...");
     auto group = nodes_group.getGroup(population_name).getGroup("0");
     const size_t group_size = nodes_group.getGroup(population_name).getDataSet("node_id").getDimensions().at(0);
 
     // TODO: Load default neuron from JSON file.
-    std::vector<neuron_traits::neuron_parameters<neuron_traits::BLIFATNeuron>> target(group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, n_time_steps_since_last_firing_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, activation_threshold_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, threshold_decay_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, threshold_increment_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, postsynaptic_trace_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, postsynaptic_trace_decay_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, postsynaptic_trace_increment_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, inhibitory_conductance_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, inhibitory_conductance_decay_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, potential_decay_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, bursting_period_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, reflexive_weight_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, reversal_inhibitory_potential_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, absolute_refractory_period_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, potential_reset_value_, group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, min_potential_, group, group_size);
+    std::vector<neuron_traits::neuron_parameters<Neuron>> target(group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, n_time_steps_since_last_firing_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, activation_threshold_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, threshold_decay_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, threshold_increment_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, postsynaptic_trace_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, postsynaptic_trace_decay_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, postsynaptic_trace_increment_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, inhibitory_conductance_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, inhibitory_conductance_decay_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, potential_decay_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, bursting_period_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, reflexive_weight_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, reversal_inhibitory_potential_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, absolute_refractory_period_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, potential_reset_value_, group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, min_potential_, group, group_size);
 
     // Dynamic.
     auto dyn_group = group.getGroup("dynamics_params");
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, dynamic_threshold_, dyn_group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, potential_, dyn_group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, pre_impact_potential_, dyn_group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, bursting_phase_, dyn_group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, total_blocking_period_, dyn_group, group_size);
-    LOAD_NEURONS_PARAMETER(target, neuron_traits::BLIFATNeuron, dopamine_value_, dyn_group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, dynamic_threshold_, dyn_group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, potential_, dyn_group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, pre_impact_potential_, dyn_group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, bursting_phase_, dyn_group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, total_blocking_period_, dyn_group, group_size);
+    LOAD_NEURONS_PARAMETER(target, Neuron, dopamine_value_, dyn_group, group_size);
 
     const knp::core::UID uid{boost::lexical_cast<boost::uuids::uuid>(population_name)};
-    core::Population<neuron_traits::BLIFATNeuron> out_population(
-        uid, [&target](size_t index) { return target[index]; }, group_size);
+    core::Population<Neuron> out_population(uid, [&target](size_t index) { return target[index]; }, group_size);
     return out_population;
 }
 
 
+template <>
+core::Population<neuron_traits::BLIFATNeuron> load_population<neuron_traits::BLIFATNeuron>(
+    const HighFive::Group &nodes_group, const std::string &population_name)
+{
+    return load_blifat_population<neuron_traits::BLIFATNeuron>(nodes_group, population_name);
+}
+
+
+template <>
+core::Population<neuron_traits::BLIFATFloatNeuron> load_population<neuron_traits::BLIFATFloatNeuron>(
+    const HighFive::Group &nodes_group, const std::string &population_name)
+{
+    return load_blifat_population<neuron_traits::BLIFATFloatNeuron>(nodes_group, population_name);
+}
+
+
 }  // namespace knp::framework::sonata
@@ -106,7 +106,7 @@ protected:
         }
 
         core::messaging::SpikeMessage message{{get_uid(), step}, spikes};
-        endpoint_.send_message(message);
+        endpoint_.send_message(std::move(message));
         return true;
     }
 
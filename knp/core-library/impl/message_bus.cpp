@@ -20,7 +20,6 @@
  */
 
 #include <knp/core/message_bus.h>
-#include <knp/meta/macro.h>
 
 #include <spdlog/spdlog.h>
 
@@ -72,18 +71,7 @@ size_t MessageBus::step()
 size_t MessageBus::route_messages()
 {
     SPDLOG_DEBUG("Message routing cycle started.");
-    size_t count = 0;
-    impl_->update();
-    size_t num_messages = step();
-
-    KNP_UNROLL_LOOP()
-    while (num_messages != 0)
-    {
-        count += num_messages;
-        num_messages = step();
-    }
-
-    return count;
+    return impl_->route_messages();
 }
 
 }  // namespace knp::core
@@ -22,6 +22,8 @@
 #include <message_bus_cpu_impl/message_bus_cpu_impl.h>
 #include <message_bus_cpu_impl/message_endpoint_cpu_impl.h>
 
+#include <algorithm>
+#include <iterator>
 #include <utility>
 
 
@@ -36,22 +38,17 @@ class MessageEndpointCPU : public MessageEndpoint
 public:
     explicit MessageEndpointCPU(std::shared_ptr<MessageEndpointCPUImpl> &&ptr) { impl_ = std::move(ptr); }
 
-    void add_received_messages(const std::vector<knp::core::messaging::MessageVariant> &incoming_messages)
+    void add_received_messages(std::vector<RoutedMessage> &&incoming_messages)
     {
-        dynamic_cast<MessageEndpointCPUImpl *>(impl_.get())->add_received_messages(incoming_messages);
+        dynamic_cast<MessageEndpointCPUImpl *>(impl_.get())->add_received_messages(std::move(incoming_messages));
     }
 
-    void add_received_message(knp::core::messaging::MessageVariant &&incoming)
+    void add_received_message(RoutedMessage incoming)
     {
-        dynamic_cast<MessageEndpointCPUImpl *>(impl_.get())->add_received_message(incoming);
+        dynamic_cast<MessageEndpointCPUImpl *>(impl_.get())->add_received_message(std::move(incoming));
     }
 
-    void add_received_message(const knp::core::messaging::MessageVariant &incoming)
-    {
-        dynamic_cast<MessageEndpointCPUImpl *>(impl_.get())->add_received_message(incoming);
-    }
-
-    std::vector<knp::core::messaging::MessageVariant> unload_sent_messages()
+    std::vector<knp::core::messaging::SharedMessageVariant> unload_sent_messages()
     {
         return dynamic_cast<MessageEndpointCPUImpl *>(impl_.get())->unload_sent_messages();
     }
@@ -61,61 +58,155 @@ public:
 void MessageBusCPUImpl::update()
 {
     std::lock_guard lock(mutex_);
+    collect_messages();
+}
+
+
+void MessageBusCPUImpl::collect_messages()
+{
     // This function is called before routing messages.
-    auto iter = endpoint_messages_.begin();
-    while (iter != endpoint_messages_.end())
+    // Clear up all pointers to expired endpoints.
+    const auto new_end = std::remove_if(
+        endpoints_.begin(), endpoints_.end(), [](const EndpointState &state) { return state.endpoint_.expired(); });
+    if (new_end != endpoints_.end())
     {
-        auto send_container_ptr = std::get<0>(*iter).lock();
-        // Clear up all pointers to expired endpoints.
-        if (!send_container_ptr)
+        endpoints_.erase(new_end, endpoints_.end());
+        is_routing_table_outdated_ = true;
+    }
+
+    broadcast_endpoints_.clear();
+    for (size_t index = 0; index < endpoints_.size(); ++index)
+    {
+        auto &state = endpoints_[index];
+        auto endpoint = state.endpoint_.lock();
+        if (!endpoint) continue;
+
+        // Read all sent messages to an internal buffer. Sender UID is converted to a handle once per message.
+        for (auto &message : endpoint->unload_sent_messages())
         {
-            endpoint_messages_.erase(iter++);
-            continue;
+            const auto sender_handle = uid_registry_->get_handle(std::visit(
+                [](const auto &msg) { return static_cast<::boost::uuids::uuid>(msg.header_.sender_uid_); }, *message));
+            messages_to_route_.push_back({std::move(message), sender_handle});
         }
 
-        // Read all sent messages to an internal buffer.
-        messages_to_route_.insert(
-            messages_to_route_.end(), std::make_move_iterator(send_container_ptr->begin()),
-            std::make_move_iterator(send_container_ptr->end()));
-        send_container_ptr->clear();
-        ++iter;
+        const size_t routing_keys_revision = endpoint->get_routing_keys_revision();
+        if (routing_keys_revision != state.routing_keys_revision_)
+        {
+            state.routing_keys_revision_ = routing_keys_revision;
+            is_routing_table_outdated_ = true;
+        }
+        state.receives_all_messages_ = endpoint->are_routing_keys_outdated();
+        if (state.receives_all_messages_) broadcast_endpoints_.push_back(index);
     }
+
+    if (is_routing_table_outdated_) update_routing_table();
+}
+
+
+void MessageBusCPUImpl::update_routing_table()
+{
+    routing_table_.clear();
+    for (size_t index = 0; index < endpoints_.size(); ++index)
+    {
+        auto endpoint = endpoints_[index].endpoint_.lock();
+        if (!endpoint) continue;
+        for (const auto key : endpoint->get_routing_keys())
+        {
+            if (key >= routing_table_.size()) routing_table_.resize(key + 1);
+            routing_table_[key].push_back(index);
+        }
+    }
+    is_routing_table_outdated_ = false;
+}
+
+
+void MessageBusCPUImpl::find_receivers(const RoutedMessage &message, std::vector<size_t> &receivers) const
+{
+    receivers.clear();
+    // Endpoints subscribed to the message sender. Nobody is subscribed to senders without handles.
+    if (message.sender_handle_ != invalid_uid_handle)
+    {
+        const RoutingKey key = get_routing_key(message.message_->index(), message.sender_handle_);
+        if (key < routing_table_.size())
+        {
+            for (const auto index : routing_table_[key])
+            {
+                if (!endpoints_[index].receives_all_messages_) receivers.push_back(index);
+            }
+        }
+    }
+    receivers.insert(receivers.end(), broadcast_endpoints_.begin(), broadcast_endpoints_.end());
 }
 
 
 size_t MessageBusCPUImpl::step()
 {
     const std::lock_guard lock(mutex_);
-    if (messages_to_route_.empty()) return 0;  // No more messages left for endpoints to receive.
-    // Sending a message to every endpoint.
-    auto message = std::move(messages_to_route_.back());
     size_t message_counter = 0;
-    for (auto endpoint_message_containers : endpoint_messages_)
+    std::vector<size_t> receivers;
+
+    // Messages nobody is subscribed to are dropped, so that the routing cycle is not stopped by them.
+    while (!messages_to_route_.empty() && 0 == message_counter)
     {
-        auto recv_ptr = std::get<1>(endpoint_message_containers).lock();
-        // Skip all endpoints deleted after previous update(). They will be deleted at the next update().
-        if (!recv_ptr) continue;
-        recv_ptr->emplace_back(message);
-        ++message_counter;
+        auto message = std::move(messages_to_route_.front());
+        // Remove message from container.
+        messages_to_route_.pop_front();
+
+        find_receivers(message, receivers);
+        for (const auto index : receivers)
+        {
+            auto endpoint = endpoints_[index].endpoint_.lock();
+            // Skip all endpoints deleted after previous update(). They will be deleted at the next update().
+            if (!endpoint) continue;
+            // All receivers share the same message.
+            endpoint->add_received_message(message);
+            ++message_counter;
+        }
     }
-    // Remove message from container.
-    messages_to_route_.pop_back();
+
     return message_counter;
 }
 
 
-core::MessageEndpoint MessageBusCPUImpl::create_endpoint()
+size_t MessageBusCPUImpl::route_messages()
 {
     const std::lock_guard lock(mutex_);
+    collect_messages();
+
+    // Group messages by receiving endpoints.
+    std::vector<std::vector<RoutedMessage>> inboxes(endpoints_.size());
+    std::vector<size_t> receivers;
+    for (const auto &message : messages_to_route_)
+    {
+        find_receivers(message, receivers);
+        for (const auto index : receivers) inboxes[index].push_back(message);
+    }
+    messages_to_route_.clear();
+
+    size_t message_counter = 0;
+    for (size_t index = 0; index < inboxes.size(); ++index)
+    {
+        if (inboxes[index].empty()) continue;
+        auto endpoint = endpoints_[index].endpoint_.lock();
+        // Skip all endpoints deleted after collecting messages. They will be deleted at the next update().
+        if (!endpoint) continue;
+        message_counter += inboxes[index].size();
+        endpoint->add_received_messages(std::move(inboxes[index]));
+    }
+
+    return message_counter;
+}
 
-    using VT = std::vector<messaging::MessageVariant>;
 
-    auto messages_to_send_v{std::make_shared<VT>()};
-    auto recv_messages_v{std::make_shared<VT>()};
+core::MessageEndpoint MessageBusCPUImpl::create_endpoint()
+{
+    const std::lock_guard lock(mutex_);
 
-    endpoint_messages_.emplace_back(messages_to_send_v, recv_messages_v);
+    auto endpoint_impl = std::make_shared<MessageEndpointCPUImpl>(uid_registry_);
+    // A new endpoint has no subscriptions, so it doesn't receive messages until it builds its routing keys.
+    endpoints_.push_back({endpoint_impl, 0, false});
 
-    auto endpoint = MessageEndpointCPU(std::make_shared<MessageEndpointCPUImpl>(messages_to_send_v, recv_messages_v));
+    auto endpoint = MessageEndpointCPU(std::move(endpoint_impl));
 
     return std::move(endpoint);
 }
@@ -23,11 +23,11 @@
 #include <knp/core/message_bus.h>
 
 #include <message_bus_impl.h>
+#include <message_endpoint_impl.h>
 
-#include <list>
+#include <deque>
 #include <memory>
 #include <mutex>
-#include <tuple>
 #include <vector>
 
 
@@ -37,21 +37,46 @@
 namespace knp::core::messaging::impl
 {
 class MessageEndpointCPU;
+class MessageEndpointCPUImpl;
 
 class MessageBusCPUImpl : public MessageBusImpl
 {
 public:
     void update() override;
     size_t step() override;
+    // Route all messages in one pass: every endpoint gets all its messages at once.
+    size_t route_messages() override;
     [[nodiscard]] core::MessageEndpoint create_endpoint() override;
 
 private:
+    // Read sent messages from endpoints and update routing table. Bus must be locked.
+    void collect_messages();
+    // Find indexes of endpoints that receive the message.
+    void find_receivers(const RoutedMessage &message, std::vector<size_t> &receivers) const;
+    // Rebuild routing table from routing keys of endpoints.
+    void update_routing_table();
+
+    struct EndpointState
+    {
+        std::weak_ptr<MessageEndpointCPUImpl> endpoint_;
+        // Revision of endpoint routing keys used in the routing table.
+        size_t routing_keys_revision_;
+        // Endpoint with outdated routing keys receives all messages.
+        bool receives_all_messages_;
+    };
+
+    // cppcheck-suppress unusedStructMember
+    // Messages are routed in the order they were sent.
+    std::deque<RoutedMessage> messages_to_route_;
     // cppcheck-suppress unusedStructMember
-    std::vector<knp::core::messaging::MessageVariant> messages_to_route_;
-    std::list<std::tuple<
-        std::weak_ptr<std::vector<messaging::MessageVariant>>, std::weak_ptr<std::vector<messaging::MessageVariant>>>>
-        // cppcheck-suppress unusedStructMember
-        endpoint_messages_;
+    std::vector<EndpointState> endpoints_;
+    // Indexes of endpoints in `endpoints_` that receive messages with the given routing key.
+    std::vector<std::vector<size_t>> routing_table_;
+    // Indexes of endpoints that receive all messages.
+    std::vector<size_t> broadcast_endpoints_;
+    bool is_routing_table_outdated_ = false;
+    // UID handles shared by all endpoints of the bus.
+    std::shared_ptr<UIDRegistry> uid_registry_ = std::make_shared<UIDRegistry>();
     std::mutex mutex_;
 };
 }  // namespace knp::core::messaging::impl
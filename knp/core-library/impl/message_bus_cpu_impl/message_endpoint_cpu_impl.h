@@ -20,10 +20,10 @@
  */
 #pragma once
 
+#include <message_bus_cpu_impl/mpsc_queue.h>
 #include <message_endpoint_impl.h>
 #include <spdlog/spdlog.h>
 
-#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <utility>
@@ -37,24 +37,26 @@ namespace knp::core::messaging::impl
 
 /**
  * @brief Endpoint implementation class for CPU message bus.
+ * @details Sent and received messages are stored in lock-free FIFO queues. Any thread can send messages, the bus is
+ * the only reader of sent messages, and the endpoint is the only reader of received messages.
  * @note It should never be used explicitly.
  */
 class MessageEndpointCPUImpl : public MessageEndpointImpl
 {
 public:
-    MessageEndpointCPUImpl(
-        std::shared_ptr<std::vector<messaging::MessageVariant>> messages_to_send,
-        std::shared_ptr<std::vector<messaging::MessageVariant>> received_messages)
-        : messages_to_send_(std::move(messages_to_send)), received_messages_(std::move(received_messages))
+    /**
+     * @brief Constructor.
+     * @param uid_registry UID registry of the message bus.
+     */
+    explicit MessageEndpointCPUImpl(std::shared_ptr<UIDRegistry> uid_registry)
+        : MessageEndpointImpl(std::move(uid_registry))
     {
     }
 
-    void send_message(const knp::core::messaging::MessageVariant &message) override
+    void send_message(knp::core::messaging::SharedMessageVariant message) override
     {
-        const std::lock_guard lock(mutex_);
-
-        messages_to_send_->push_back(message);
-        SPDLOG_TRACE("Message was sent, type index = {}.", message.index());
+        SPDLOG_TRACE("Message was sent, type index = {}.", message->index());
+        messages_to_send_.push(std::move(message));
     }
 
     ~MessageEndpointCPUImpl() override = default;
@@ -63,55 +65,90 @@ public:
      * @brief Read all the messages queued to be sent, then clear message container.
      * @return vector of messages to be sent to other endpoints.
      */
-    [[nodiscard]] std::vector<knp::core::messaging::MessageVariant> unload_sent_messages()
+    [[nodiscard]] std::vector<knp::core::messaging::SharedMessageVariant> unload_sent_messages()
     {
-        const std::lock_guard lock(mutex_);
-        auto result = std::move(*messages_to_send_);
-
-        messages_to_send_->clear();
+        std::vector<knp::core::messaging::SharedMessageVariant> result;
+        while (auto message = messages_to_send_.pop()) result.push_back(std::move(*message));
         return result;
     }
 
-    // TODO: Embarrassingly inefficient: all endpoints basically receive all messages by copying them. It needs to be
-    // optimized.
-    void add_received_messages(const std::vector<knp::core::messaging::MessageVariant> &incoming_messages)
+    /**
+     * @brief Add a batch of received messages at once.
+     * @param incoming_messages messages to add.
+     */
+    void add_received_messages(std::vector<RoutedMessage> &&incoming_messages)
     {
-        const std::lock_guard lock(mutex_);
-
-        received_messages_->insert(received_messages_->end(), incoming_messages.begin(), incoming_messages.end());
+        received_messages_.push(std::move(incoming_messages));
     }
 
-    void add_received_message(knp::core::messaging::MessageVariant &&incoming)
+    void add_received_message(RoutedMessage incoming) { received_messages_.push({std::move(incoming)}); }
+
+    void set_routing_keys(RoutingKeys &&keys, size_t revision) override
     {
         const std::lock_guard lock(mutex_);
 
-        received_messages_->emplace_back(incoming);
+        routing_keys_ = std::move(keys);
+        routing_keys_revision_ = revision;
     }
 
-    void add_received_message(const knp::core::messaging::MessageVariant &incoming)
+    /**
+     * @brief Get routing keys of messages that the endpoint receives.
+     * @return copy of routing keys.
+     */
+    [[nodiscard]] RoutingKeys get_routing_keys()
     {
         const std::lock_guard lock(mutex_);
+        return routing_keys_;
+    }
 
-        received_messages_->push_back(incoming);
+    /**
+     * @brief Get value of the subscription change counter used to build routing keys.
+     * @return routing keys revision.
+     */
+    [[nodiscard]] size_t get_routing_keys_revision()
+    {
+        const std::lock_guard lock(mutex_);
+        return routing_keys_revision_;
     }
 
-    std::optional<knp::core::messaging::MessageVariant> receive_message() override
+    /**
+     * @brief Check if subscriptions changed after routing keys were built.
+     * @details An endpoint with outdated routing keys must receive all messages until it updates the keys.
+     * @return `true` if routing keys are outdated.
+     */
+    [[nodiscard]] bool are_routing_keys_outdated()
     {
         const std::lock_guard lock(mutex_);
+        return routing_keys_revision_ != *get_subscription_change_counter();
+    }
 
-        if (received_messages_->empty())
+    RoutedMessage receive_message() override
+    {
+        // Messages are received in the order they were routed.
+        while (inbox_index_ == inbox_.size())
         {
-            return {};
+            auto batch = received_messages_.pop();
+            if (!batch.has_value())
+            {
+                return {};
+            }
+            inbox_ = std::move(*batch);
+            inbox_index_ = 0;
         }
 
-        auto result = std::move(received_messages_->back());
-        received_messages_->pop_back();
-        return result;
+        return std::move(inbox_[inbox_index_++]);
     }
 
 private:
-    std::shared_ptr<std::vector<messaging::MessageVariant>> messages_to_send_;
-    std::shared_ptr<std::vector<messaging::MessageVariant>> received_messages_;
+    MPSCQueue<messaging::SharedMessageVariant> messages_to_send_;
+    // Batches of received messages.
+    MPSCQueue<std::vector<RoutedMessage>> received_messages_;
+    // Batch of received messages that is being read by the endpoint.
+    std::vector<RoutedMessage> inbox_;
+    size_t inbox_index_ = 0;
+    RoutingKeys routing_keys_;
+    size_t routing_keys_revision_ = 0;
+    // Routing keys are changed by the endpoint and read by the bus.
     std::mutex mutex_;
 };
 
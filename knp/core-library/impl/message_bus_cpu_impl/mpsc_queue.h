@@ -0,0 +1,226 @@
+/**
+ * @file mpsc_queue.h
+ * @brief Lock-free queue with multiple producers and a single consumer.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <utility>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+
+/**
+ * @brief Lock-free FIFO queue with multiple producers and a single consumer.
+ * @details The queue is a linked list of nodes: a producer appends a node with one atomic exchange, the consumer
+ * removes nodes from the other end. Any thread can push values, but only one thread at a time can pop them.
+ * Removed nodes are kept in a bounded lock-free ring and reused by producers, so after the queue warms up, pushing a
+ * value doesn't allocate memory. A node is allocated only if the ring is empty, and deleted only if the ring is full.
+ * @note A value pushed by a thread becomes visible to the consumer after the push is completed, so the consumer can
+ * see the queue empty while a push is in progress.
+ * @tparam T value type.
+ */
+template <class T>
+class MPSCQueue
+{
+public:
+    /**
+     * @brief Default maximum number of free nodes kept for reuse.
+     */
+    static constexpr size_t default_free_node_count = 1024;
+
+    /**
+     * @brief Construct an empty queue.
+     * @param free_node_count maximum number of free nodes kept for reuse. The value is rounded up to a power of two.
+     */
+    explicit MPSCQueue(size_t free_node_count = default_free_node_count)
+        : head_(new Node), tail_(head_.load(std::memory_order_relaxed)), free_nodes_(free_node_count)
+    {
+    }
+
+    MPSCQueue(const MPSCQueue &) = delete;
+    MPSCQueue &operator=(const MPSCQueue &) = delete;
+
+    /**
+     * @brief Destroy the queue and all values in it.
+     */
+    ~MPSCQueue()
+    {
+        while (pop())
+        {
+        }
+        delete tail_;
+        while (auto *node = free_nodes_.pop()) delete node;
+    }
+
+    /**
+     * @brief Add a value to the end of the queue.
+     * @details The method can be called from any thread.
+     * @param value value to add.
+     */
+    void push(T value)
+    {
+        auto *node = free_nodes_.pop();
+        if (!node) node = new Node;
+        node->value_.emplace(std::move(value));
+        // After the exchange the node is the last one, then the previous node is linked to it.
+        Node *prev = head_.exchange(node, std::memory_order_acq_rel);
+        prev->next_.store(node, std::memory_order_release);
+    }
+
+    /**
+     * @brief Remove the first value from the queue.
+     * @details The method must be called only from the consumer thread.
+     * @return first value or nothing if the queue is empty.
+     */
+    std::optional<T> pop()
+    {
+        Node *next = tail_->next_.load(std::memory_order_acquire);
+        if (!next) return {};
+
+        // The first node doesn't contain a value, the next node becomes the first one.
+        T result = std::move(*next->value_);
+        next->value_.reset();
+        // Producers link nodes only to the last node, so the removed node is no longer used by them.
+        tail_->next_.store(nullptr, std::memory_order_relaxed);
+        if (!free_nodes_.push(tail_)) delete tail_;
+        tail_ = next;
+        return result;
+    }
+
+    /**
+     * @brief Check if the queue is empty.
+     * @details The method must be called only from the consumer thread.
+     * @return `true` if there are no values to pop.
+     */
+    [[nodiscard]] bool empty() const { return !tail_->next_.load(std::memory_order_acquire); }
+
+private:
+    struct Node
+    {
+        std::optional<T> value_;
+        std::atomic<Node *> next_ = nullptr;
+    };
+
+    // Bounded ring of free nodes. The consumer adds nodes, producers take them. Each cell has a sequence number that
+    // tells whether the cell is ready to be written or read on the current lap, so positions are never reused before
+    // the cell is released.
+    class FreeNodes
+    {
+    public:
+        explicit FreeNodes(size_t capacity) : capacity_(round_capacity(capacity)), cells_(new Cell[capacity_])
+        {
+            for (size_t index = 0; index < capacity_; ++index)
+            {
+                cells_[index].sequence_.store(index, std::memory_order_relaxed);
+            }
+        }
+
+        // Add a node, return `false` if the ring is full.
+        bool push(Node *node)
+        {
+            size_t position = push_position_.load(std::memory_order_relaxed);
+            Cell *cell = nullptr;
+            while (true)
+            {
+                cell = &cells_[position & (capacity_ - 1)];
+                const size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position);
+                if (diff == 0)
+                {
+                    if (push_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0)
+                {
+                    return false;
+                }
+                else
+                {
+                    position = push_position_.load(std::memory_order_relaxed);
+                }
+            }
+            cell->node_ = node;
+            cell->sequence_.store(position + 1, std::memory_order_release);
+            return true;
+        }
+
+        // Take a node, return `nullptr` if the ring is empty.
+        Node *pop()
+        {
+            size_t position = pop_position_.load(std::memory_order_relaxed);
+            Cell *cell = nullptr;
+            while (true)
+            {
+                cell = &cells_[position & (capacity_ - 1)];
+                const size_t sequence = cell->sequence_.load(std::memory_order_acquire);
+                const auto diff = static_cast<std::intptr_t>(sequence) - static_cast<std::intptr_t>(position + 1);
+                if (diff == 0)
+                {
+                    if (pop_position_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) break;
+                }
+                else if (diff < 0)
+                {
+                    return nullptr;
+                }
+                else
+                {
+                    position = pop_position_.load(std::memory_order_relaxed);
+                }
+            }
+            Node *node = cell->node_;
+            cell->sequence_.store(position + capacity_, std::memory_order_release);
+            return node;
+        }
+
+    private:
+        struct Cell
+        {
+            std::atomic<size_t> sequence_;
+            Node *node_ = nullptr;
+        };
+
+        static size_t round_capacity(size_t capacity)
+        {
+            size_t result = 1;
+            while (result < capacity) result *= 2;
+            return result;
+        }
+
+        const size_t capacity_;
+        std::unique_ptr<Cell[]> cells_;
+        std::atomic<size_t> push_position_ = 0;
+        std::atomic<size_t> pop_position_ = 0;
+    };
+
+    // Last node, producers append nodes after it.
+    std::atomic<Node *> head_;
+    // First node without value, the consumer reads values after it.
+    Node *tail_;
+    // Removed nodes that are reused by producers.
+    FreeNodes free_nodes_;
+};
+
+}  // namespace knp::core::messaging::impl
@@ -20,6 +20,7 @@
  */
 #pragma once
 #include <knp/core/message_endpoint.h>
+#include <knp/meta/macro.h>
 
 /**
  * @brief Namespace for implementations of message bus.
@@ -53,5 +54,27 @@ public:
      * @brief Update if needed. The function is to to be called once before message routing.
      */
     virtual void update() {}
+
+    /**
+     * @brief Route all messages sent to the bus.
+     * @details Default implementation calls `update()` once, then calls `step()` until no messages are routed.
+     * Implementations can override the method to route all messages in one pass.
+     * @return number of messages routed.
+     */
+    virtual size_t route_messages()
+    {
+        size_t count = 0;
+        update();
+        size_t num_messages = step();
+
+        KNP_UNROLL_LOOP()
+        while (num_messages != 0)
+        {
+            count += num_messages;
+            num_messages = step();
+        }
+
+        return count;
+    }
 };
 }  // namespace knp::core::messaging::impl
@@ -42,7 +42,7 @@ public:
     explicit MessageEndpointZMQImpl(zmq::socket_t &&sub_socket, zmq::socket_t &&pub_socket);
 
 public:
-    std::optional<messaging::MessageVariant> receive_message() override
+    RoutedMessage receive_message() override
     {
         auto message_var = receive_zmq_message();
         if (!message_var.has_value())
@@ -50,12 +50,13 @@ public:
             return {};
         }
 
-        auto message = knp::core::messaging::extract_from_envelope(message_var->data());
-        return message;
+        // UID handles are local to the process, so the endpoint finds the handle itself.
+        return {std::make_shared<messaging::MessageVariant>(
+            knp::core::messaging::extract_from_envelope(message_var->data()))};
     }
-    void send_message(const knp::core::messaging::MessageVariant &message) override
+    void send_message(knp::core::messaging::SharedMessageVariant message) override
     {
-        auto packed_msg = knp::core::messaging::pack_to_envelope(message);
+        auto packed_msg = knp::core::messaging::pack_to_envelope(*message);
         SPDLOG_TRACE("Packed message size: {}.", packed_msg.size());
         send_zmq_message(packed_msg.data(), packed_msg.size());
     }
@@ -24,6 +24,8 @@
 #include <message_endpoint_impl.h>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <iterator>
 #include <memory>
 
 // sleep_for.
@@ -60,7 +62,10 @@ std::pair<size_t, UID> MessageEndpoint::get_subscription_key(const MessageEndpoi
 
 
 MessageEndpoint::MessageEndpoint(MessageEndpoint &&endpoint) noexcept
-    : impl_(std::move(endpoint.impl_)), subscriptions_(std::move(endpoint.subscriptions_))
+    : impl_(std::move(endpoint.impl_)),
+      subscriptions_(std::move(endpoint.subscriptions_)),
+      routing_table_(std::move(endpoint.routing_table_)),
+      routing_table_revision_(endpoint.routing_table_revision_)
 {
 }
 
@@ -87,6 +92,9 @@ Subscription<MessageType> &MessageEndpoint::subscribe(const UID &receiver, const
     auto sub_variant = SubscriptionVariant{Subscription<MessageType>{receiver, senders}};
     auto insert_res = subscriptions_.emplace(std::make_pair(index, receiver), sub_variant);
     auto &sub = std::get<index>(insert_res.first->second);
+    // Changes of subscription senders make the routing table outdated.
+    sub.set_change_counter(impl_->get_subscription_change_counter());
+    notify_subscriptions_changed();
     return sub;
 }
 
@@ -100,6 +108,7 @@ bool MessageEndpoint::unsubscribe(const UID &receiver)
     if (iter != subscriptions_.end())
     {
         subscriptions_.erase(iter);
+        notify_subscriptions_changed();
         return true;
     }
     return false;
@@ -110,13 +119,63 @@ void MessageEndpoint::remove_receiver(const UID &receiver)
 {
     SPDLOG_DEBUG("Removing receiver {}...", std::string(receiver));
 
-    for (auto sub_iter = subscriptions_.begin(); sub_iter != subscriptions_.end(); ++sub_iter)
+    for (auto sub_iter = subscriptions_.begin(); sub_iter != subscriptions_.end();)
     {
         if (get_receiver_uid(sub_iter->second) == receiver)
         {
-            subscriptions_.erase(sub_iter);
+            sub_iter = subscriptions_.erase(sub_iter);
+            notify_subscriptions_changed();
         }
+        else
+        {
+            ++sub_iter;
+        }
+    }
+}
+
+
+void MessageEndpoint::notify_subscriptions_changed()
+{
+    ++*impl_->get_subscription_change_counter();
+}
+
+
+size_t MessageEndpoint::get_subscriptions_revision() const
+{
+    return *impl_->get_subscription_change_counter();
+}
+
+
+void MessageEndpoint::update_routing_table()
+{
+    const size_t revision = *impl_->get_subscription_change_counter();
+    if (revision == routing_table_revision_) return;
+
+    SPDLOG_TRACE("Updating routing table...");
+    routing_table_.clear();
+    messaging::impl::RoutingKeys keys;
+    auto &uid_registry = impl_->get_uid_registry();
+    for (auto &subscription_entry : subscriptions_)
+    {
+        auto &sub_variant = subscription_entry.second;
+        const size_t type_index = sub_variant.index();
+        std::visit(
+            [this, &keys, &uid_registry, &sub_variant, type_index](const auto &subscription)
+            {
+                for (const auto &sender : subscription.get_senders())
+                {
+                    // Senders get dense handles when they are subscribed to.
+                    const auto key = messaging::impl::get_routing_key(type_index, uid_registry.register_uid(sender));
+                    if (key >= routing_table_.size()) routing_table_.resize(key + 1);
+                    // A key is added once, because subscription senders are unique.
+                    if (routing_table_[key].empty()) keys.push_back(key);
+                    routing_table_[key].push_back(&sub_variant);
+                }
+            },
+            sub_variant);
     }
+    routing_table_revision_ = revision;
+    impl_->set_routing_keys(std::move(keys), revision);
 }
 
 
@@ -124,7 +183,23 @@ void MessageEndpoint::send_message(const knp::core::messaging::MessageVariant &m
 {
     SPDLOG_TRACE(
         "Sending message from {}, index = {}...", std::string(get_header(message).sender_uid_), message.index());
-    impl_->send_message(message);
+    impl_->send_message(std::make_shared<knp::core::messaging::MessageVariant>(message));
+}
+
+
+void MessageEndpoint::send_message(knp::core::messaging::MessageVariant &&message)
+{
+    SPDLOG_TRACE(
+        "Sending message from {}, index = {}...", std::string(get_header(message).sender_uid_), message.index());
+    impl_->send_message(std::make_shared<knp::core::messaging::MessageVariant>(std::move(message)));
+}
+
+
+void MessageEndpoint::send_message(knp::core::messaging::SharedMessageVariant message)
+{
+    SPDLOG_TRACE(
+        "Sending message from {}, index = {}...", std::string(get_header(*message).sender_uid_), message->index());
+    impl_->send_message(std::move(message));
 }
 
 
@@ -132,44 +207,43 @@ bool MessageEndpoint::receive_message()
 {
     SPDLOG_DEBUG("Receiving message...");
 
-    auto message_opt = impl_->receive_message();
-    if (!message_opt.has_value())
+    update_routing_table();
+    auto routed_message = impl_->receive_message();
+    const auto &message = routed_message.message_;
+    auto sender_handle = routed_message.sender_handle_;
+    if (!message)
     {
         SPDLOG_TRACE("No message received.");
         return false;
     }
-    auto &message = message_opt.value();
-    const UID &sender_uid = get_header(message).sender_uid_;
-    const size_t type_index = message.index();
+    const UID &sender_uid = get_header(*message).sender_uid_;
 
-    SPDLOG_TRACE("Subscription count = {}.", subscriptions_.size());
+    // Message bus implementations that don't track UID handles deliver messages without them.
+    if (messaging::impl::invalid_uid_handle == sender_handle)
+    {
+        sender_handle = impl_->get_uid_registry().get_handle(static_cast<boost::uuids::uuid>(sender_uid));
+    }
 
-    // Find a subscription.
-    for (auto &&[k, sub_variant] : subscriptions_)
+    // Find subscriptions.
+    const auto key = messaging::impl::get_routing_key(message->index(), sender_handle);
+    if (messaging::impl::invalid_uid_handle == sender_handle || key >= routing_table_.size())
     {
-        if (sub_variant.index() != type_index)
-        {
-            SPDLOG_TRACE(
-                "Subscription message type index does not match the message type index [{} != {}].",
-                sub_variant.index(), type_index);
-            continue;
-        }
+        SPDLOG_TRACE("No subscriptions for messages from {}.", std::string(sender_uid));
+        return true;
+    }
 
+    for (auto *sub_variant : routing_table_[key])
+    {
         std::visit(
-            [&sender_uid, &message](auto &&subscription)
+            [&message](auto &subscription)
             {
-                SPDLOG_TRACE("Sender UID: {}.", std::string(sender_uid));
-                if (subscription.has_sender(sender_uid))
-                {
-                    SPDLOG_TRACE("Subscription has sender with UID {}.", std::string(sender_uid));
-                    subscription.add_message(
-                        std::get<typename std::decay_t<decltype(subscription)>::MessageType>(message));
-                    SPDLOG_TRACE("Message was added to the subscription {}.", std::string(sender_uid));
-                }
+                using SubscriptionType = std::decay_t<decltype(subscription)>;
+                // Subscription shares ownership of the whole message, but points to the message of its type.
+                subscription.add_message(typename SubscriptionType::SharedMessageType(
+                    message, &std::get<typename SubscriptionType::MessageType>(*message)));
             },
-            sub_variant);
-
-        // sub_variant.swap(v);
+            *sub_variant);
+        SPDLOG_TRACE("Message was added to the subscription {}.", std::string(get_receiver_uid(*sub_variant)));
     }
 
     return true;
@@ -205,7 +279,44 @@ std::vector<MessageType> MessageEndpoint::unload_messages(const knp::core::UID &
     }
 
     Subscription<MessageType> &subscription = std::get<index>(iter->second);
-    auto result = std::move(subscription.get_messages());
+    std::vector<MessageType> result;
+    result.reserve(subscription.get_messages().size());
+    for (auto &message : subscription.get_messages())
+    {
+        // Messages that other receivers can read are copied, messages without other owners are moved.
+        if (1 == message.use_count())
+        {
+            // Synchronizes with releases of the message by other threads.
+            std::atomic_thread_fence(std::memory_order_acquire);
+            result.push_back(std::move(*message));
+        }
+        else
+        {
+            result.push_back(*message);
+        }
+    }
+    subscription.clear_messages();
+
+    return result;
+}
+
+
+template <class MessageType>
+std::vector<std::shared_ptr<const MessageType>> MessageEndpoint::unload_shared_messages(
+    const knp::core::UID &receiver_uid)
+{
+    constexpr size_t index = get_type_index<knp::core::messaging::MessageVariant, MessageType>;
+    auto iter = subscriptions_.find(std::make_pair(index, receiver_uid));
+
+    if (iter == subscriptions_.end())
+    {
+        return {};
+    }
+
+    Subscription<MessageType> &subscription = std::get<index>(iter->second);
+    auto &messages = subscription.get_messages();
+    std::vector<std::shared_ptr<const MessageType>> result(
+        std::make_move_iterator(messages.begin()), std::make_move_iterator(messages.end()));
     subscription.clear_messages();
 
     return result;
@@ -214,11 +325,14 @@ std::vector<MessageType> MessageEndpoint::unload_messages(const knp::core::UID &
 
 namespace cm = knp::core::messaging;
 
-#define INSTANCE_MESSAGES_FUNCTIONS(n, template_for_instance, message_type)                \
-    template Subscription<cm::message_type> &MessageEndpoint::subscribe<cm::message_type>( \
-        const UID &receiver, const std::vector<UID> &senders);                             \
-    template bool MessageEndpoint::unsubscribe<cm::message_type>(const UID &receiver);     \
-    template std::vector<cm::message_type> MessageEndpoint::unload_messages<cm::message_type>(const UID &receiver_uid);
+#define INSTANCE_MESSAGES_FUNCTIONS(n, template_for_instance, message_type)                    \
+    template Subscription<cm::message_type> &MessageEndpoint::subscribe<cm::message_type>(     \
+        const UID &receiver, const std::vector<UID> &senders);                                 \
+    template bool MessageEndpoint::unsubscribe<cm::message_type>(const UID &receiver);         \
+    template std::vector<cm::message_type> MessageEndpoint::unload_messages<cm::message_type>( \
+        const UID &receiver_uid);                                                              \
+    template std::vector<std::shared_ptr<const cm::message_type>>                              \
+    MessageEndpoint::unload_shared_messages<cm::message_type>(const UID &receiver_uid);
 
 BOOST_PP_SEQ_FOR_EACH(INSTANCE_MESSAGES_FUNCTIONS, "", BOOST_PP_VARIADIC_TO_SEQ(ALL_MESSAGES))
 
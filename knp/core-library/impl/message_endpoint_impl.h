@@ -23,8 +23,58 @@
 
 #include <knp/core/messaging/message_envelope.h>
 
+#include <uid_registry.h>
+
+#include <atomic>
+#include <memory>
+#include <utility>
+#include <variant>
+#include <vector>
+
 namespace knp::core::messaging::impl
 {
+/**
+ * @brief Routing key of a message: index built from message type index and sender UID handle.
+ * @details Routing keys are dense, so they can be used as indexes of routing tables.
+ */
+using RoutingKey = size_t;
+
+
+/**
+ * @brief Unique routing keys of messages that an endpoint receives.
+ */
+using RoutingKeys = std::vector<RoutingKey>;
+
+
+/**
+ * @brief Get routing key of a message.
+ * @param type_index message type index in `MessageVariant`.
+ * @param sender_handle handle of the sender UID.
+ * @return routing key.
+ */
+constexpr RoutingKey get_routing_key(size_t type_index, UIDHandle sender_handle)
+{
+    return static_cast<RoutingKey>(sender_handle) * std::variant_size_v<MessageVariant> + type_index;
+}
+
+
+/**
+ * @brief Message passed between endpoints together with the handle of its sender UID.
+ */
+struct RoutedMessage
+{
+    /**
+     * @brief Shared message.
+     */
+    SharedMessageVariant message_;
+    /**
+     * @brief Handle of the sender UID or `invalid_uid_handle` if the handle is unknown.
+     */
+    UIDHandle sender_handle_ = invalid_uid_handle;
+};
+
+
+
 /**
  * @brief Base class for all message endpoint implementations.
  */
@@ -33,15 +83,40 @@ class MessageEndpointImpl
 public:
     /**
      * @brief Receive a message from message bus.
-     * @return message if a message was received, nothing otherwise.
+     * @return routed message. Message is `nullptr` if no message was received.
      */
-    virtual std::optional<MessageVariant> receive_message() = 0;
+    virtual RoutedMessage receive_message() = 0;
 
     /**
      * @brief Send a message to a message bus.
-     * @param message message to send.
+     * @param message shared message to send.
      */
-    virtual void send_message(const MessageVariant &message) = 0;
+    virtual void send_message(SharedMessageVariant message) = 0;
+
+    /**
+     * @brief Set routing keys of messages that the endpoint receives.
+     * @details Message bus implementations can use routing keys to deliver messages only to endpoints that need them.
+     * Routing keys are up to date while the subscription change counter equals `revision`.
+     * @param keys routing keys built from endpoint subscriptions.
+     * @param revision value of the subscription change counter used to build the keys.
+     */
+    virtual void set_routing_keys(RoutingKeys &&keys, size_t revision) {}
+
+    /**
+     * @brief Get counter of endpoint subscription changes.
+     * @return shared change counter.
+     */
+    [[nodiscard]] const std::shared_ptr<std::atomic<size_t>> &get_subscription_change_counter() const
+    {
+        return subscription_change_counter_;
+    }
+
+    /**
+     * @brief Get registry of UID handles used by the endpoint.
+     * @details Endpoints of the same bus share the registry.
+     * @return UID registry.
+     */
+    [[nodiscard]] UIDRegistry &get_uid_registry() const { return *uid_registry_; }
 
     MessageEndpointImpl() = default;
     MessageEndpointImpl(const MessageEndpointImpl &) = default;
@@ -53,5 +128,20 @@ public:
      * @brief Default virtual destructor.
      */
     virtual ~MessageEndpointImpl() = default;
+
+protected:
+    /**
+     * @brief Constructor of an endpoint that uses a shared UID registry.
+     * @param uid_registry UID registry of the message bus.
+     */
+    explicit MessageEndpointImpl(std::shared_ptr<UIDRegistry> uid_registry) : uid_registry_(std::move(uid_registry))
+    {
+    }
+
+private:
+    // Incremented by the endpoint and its subscriptions every time the set of received messages can change.
+    std::shared_ptr<std::atomic<size_t>> subscription_change_counter_ = std::make_shared<std::atomic<size_t>>(0);
+    // Registry of UID handles shared by endpoints of the same bus.
+    std::shared_ptr<UIDRegistry> uid_registry_ = std::make_shared<UIDRegistry>();
 };
 }  // namespace knp::core::messaging::impl
@@ -23,42 +23,43 @@
 
 #include <spdlog/spdlog.h>
 
-
-// Index functions.
-template <class Index, class Connection>
-void insert_to_index(Index &val, const Connection &connection)
-{
-    val.insert(connection);
-}
-
-
-template <class Index, class Type>
-auto find_by_type(const Index &val, size_t neuron_index)
-{
-    return val.template get<Type>().equal_range(neuron_index);
-}
-
-
-template <class Index, class Type>
-std::vector<size_t> find_indexes_by_type(const Index &val, size_t neuron_index)
-{
-    auto range = find_by_type<Index, Type>(val, neuron_index);
-    std::vector<size_t> res;
-    std::transform(range.first, range.second, std::back_inserter(res), [](const auto &val) { return val.index_; });
-    return res;
-}
+#include <algorithm>
+#include <numeric>
 
 
+// Index functions.
 /**
- * @brief Remove a synapse with a given index.
- * @param index index of a synapse.
- * @return true if an element was found and erased.
+ * @brief Build a compressed sparse row index of synapses by neuron.
+ * @details Synapse indexes are sorted by neuron index using a stable counting sort, so indexes of synapses
+ * connected to the same neuron stay in ascending order.
+ * @tparam neuron_id_type position of the neuron index in the synapse tuple.
+ * @param synapses synapse container.
+ * @param offsets offsets of the neuron synapse ranges. Size of the array is the number of neurons plus one.
+ * @param indexes synapse indexes grouped by neuron.
  */
-template <class Index, class Projection>
-bool erase_synapse(Index &val, size_t index)
+template <size_t neuron_id_type, class SynapseContainer>
+void build_csr_index(const SynapseContainer &synapses, std::vector<size_t> &offsets, std::vector<size_t> &indexes)
 {
-    auto num_erased = val.template get<typename Projection::mi_synapse_index>().erase(index);
-    return num_erased > 0;
+    size_t neurons_count = 0;
+    for (const auto &synapse : synapses)
+    {
+        neurons_count = std::max(neurons_count, std::get<neuron_id_type>(synapse) + 1);
+    }
+
+    offsets.assign(neurons_count + 1, 0);
+    for (const auto &synapse : synapses)
+    {
+        ++offsets[std::get<neuron_id_type>(synapse) + 1];
+    }
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+
+    // Positions to place the next synapse index for each neuron.
+    std::vector<size_t> positions(offsets.begin(), offsets.end() - 1);
+    indexes.resize(synapses.size());
+    for (size_t i = 0; i < synapses.size(); ++i)
+    {
+        indexes[positions[std::get<neuron_id_type>(synapses[i])]++] = i;
+    }
 }
 
 
@@ -101,8 +102,6 @@ void remove_by_index(std::vector<T> &data, const IndexContainer &to_remove)
 
 namespace knp::core
 {
-using Connection = typename std::tuple<size_t, size_t, size_t>;
-
 
 template <typename SynapseType>
 Projection<SynapseType>::Projection(UID presynaptic_uid, UID postsynaptic_uid)  //!OCLINT(Parameters used)
@@ -169,22 +168,9 @@ template <typename SynapseType>
 std::vector<size_t> knp::core::Projection<SynapseType>::find_synapses(
     size_t neuron_id, Search search_criterion) const  //!OCLINT(Parameters used)
 {
-    reindex();
-    std::vector<size_t> res;
-    switch (search_criterion)
-    {
-        case Search::by_postsynaptic:
-            res = find_indexes_by_type<decltype(index_), core::Projection<SynapseType>::ByPostsynaptic>(
-                index_, neuron_id);
-            break;
-        case Search::by_presynaptic:
-            res =
-                find_indexes_by_type<decltype(index_), core::Projection<SynapseType>::ByPresynaptic>(index_, neuron_id);
-            break;
-        default:
-            return {};
-    }
-    return res;
+    const auto range = (Search::by_presynaptic == search_criterion) ? synapses_of_presynaptic(neuron_id)
+                                                                   : synapses_of_postsynaptic(neuron_id);
+    return std::vector<size_t>(range.begin(), range.end());
 }
 
 
@@ -194,6 +180,8 @@ size_t knp::core::Projection<SynapseType>::add_synapses(
 {
     const size_t starting_size = parameters_.size();
     is_index_updated_ = false;
+    is_columns_updated_ = false;
+    ++synapses_revision_;
     for (size_t i = 0; i < num_iterations; ++i)
     {
         if (auto data = generator(i))
@@ -209,7 +197,12 @@ template <typename SynapseType>
 void Projection<SynapseType>::clear()
 {
     parameters_.clear();
-    index_.clear();
+    presynaptic_index_.clear();
+    postsynaptic_index_.clear();
+    is_index_updated_ = true;
+    columns_ = SynapseColumns{};
+    ++synapses_revision_;
+    is_columns_updated_ = false;
 }
 
 
@@ -217,6 +210,8 @@ template <typename SynapseType>
 void knp::core::Projection<SynapseType>::remove_synapse(size_t index)  //!OCLINT
 {
     is_index_updated_ = false;
+    is_columns_updated_ = false;
+    ++synapses_revision_;
     parameters_.erase(parameters_.begin() + index);
 }
 
@@ -226,6 +221,8 @@ size_t knp::core::Projection<SynapseType>::remove_synapse_if(std::function<bool(
 {
     const size_t starting_size = parameters_.size();
     is_index_updated_ = false;
+    is_columns_updated_ = false;
+    ++synapses_revision_;
     parameters_.resize(std::remove_if(parameters_.begin(), parameters_.end(), predicate) - parameters_.begin());
     return starting_size - parameters_.size();
 }
@@ -235,16 +232,14 @@ template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_postsynaptic_neuron_synapses(size_t neuron_index)  //!OCLINT
 {
     const size_t starting_size = parameters_.size();
-    bool was_index_updated = is_index_updated_;
+    const auto synapses_range = synapses_of_postsynaptic(neuron_index);
+    // Index range is sorted and is invalidated by the removal, so it must be copied.
+    const std::vector<size_t> synapses_to_remove(synapses_range.begin(), synapses_range.end());
     // Basic exception safety.
     is_index_updated_ = false;
-    auto synapses_to_remove = find_synapses(neuron_index, Search::by_postsynaptic);
-    std::sort(synapses_to_remove.begin(), synapses_to_remove.end());
+    is_columns_updated_ = false;
+    ++synapses_revision_;
     remove_by_index(parameters_, synapses_to_remove);
-    if (was_index_updated)
-        for (auto &synapse : synapses_to_remove) index_.erase(synapse);
-
-    is_index_updated_ = was_index_updated;
     return starting_size - parameters_.size();
 }
 
@@ -252,9 +247,16 @@ size_t knp::core::Projection<SynapseType>::remove_postsynaptic_neuron_synapses(s
 template <typename SynapseType>
 size_t knp::core::Projection<SynapseType>::remove_presynaptic_neuron_synapses(size_t neuron_index)  //!OCLINT
 {
-    // TODO: We now have a way to find them quickly, make use of it instead of disconnect_if.
-    return remove_synapse_if([neuron_index](const Synapse &synapse)
-                             { return std::get<knp::core::source_neuron_id>(synapse) == neuron_index; });
+    const size_t starting_size = parameters_.size();
+    const auto synapses_range = synapses_of_presynaptic(neuron_index);
+    // Index range is sorted and is invalidated by the removal, so it must be copied.
+    const std::vector<size_t> synapses_to_remove(synapses_range.begin(), synapses_range.end());
+    // Basic exception safety.
+    is_index_updated_ = false;
+    is_columns_updated_ = false;
+    ++synapses_revision_;
+    remove_by_index(parameters_, synapses_to_remove);
+    return starting_size - parameters_.size();
 }
 
 
@@ -266,16 +268,39 @@ void knp::core::Projection<SynapseType>::reindex() const
         return;
     }
 
-    index_.clear();
+    build_csr_index<knp::core::source_neuron_id>(
+        parameters_, presynaptic_index_.offsets_, presynaptic_index_.synapses_);
+    build_csr_index<knp::core::target_neuron_id>(
+        parameters_, postsynaptic_index_.offsets_, postsynaptic_index_.synapses_);
+    is_index_updated_ = true;
+}
+
+
+template <typename SynapseType>
+const typename knp::core::Projection<SynapseType>::SynapseColumns &
+knp::core::Projection<SynapseType>::get_synapse_columns() const
+{
+    if (is_columns_updated_)
+    {
+        return columns_;
+    }
+
+    columns_.weights_.resize(parameters_.size());
+    columns_.delays_.resize(parameters_.size());
+    columns_.output_types_.resize(parameters_.size());
+    columns_.source_neuron_ids_.resize(parameters_.size());
+    columns_.target_neuron_ids_.resize(parameters_.size());
     for (size_t i = 0; i < parameters_.size(); ++i)
     {
-        auto &synapse = parameters_[i];
-        insert_to_index(
-            index_,
-            Connection{
-                std::get<knp::core::source_neuron_id>(synapse), std::get<knp::core::target_neuron_id>(synapse), i});
+        const auto &[synapse_params, id_from, id_to] = parameters_[i];
+        columns_.weights_[i] = synapse_params.weight_;
+        columns_.delays_[i] = synapse_params.delay_;
+        columns_.output_types_[i] = synapse_params.output_type_;
+        columns_.source_neuron_ids_[i] = static_cast<uint32_t>(id_from);
+        columns_.target_neuron_ids_[i] = static_cast<uint32_t>(id_to);
     }
-    is_index_updated_ = true;
+    is_columns_updated_ = true;
+    return columns_;
 }
 
 
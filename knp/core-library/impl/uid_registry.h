@@ -0,0 +1,97 @@
+/**
+ * @file uid_registry.h
+ * @brief Registry of dense UID handles.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#pragma once
+
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+#include <boost/functional/hash.hpp>
+#include <boost/uuid/uuid.hpp>
+
+
+/**
+ * @brief Namespace for implementations of message bus.
+ */
+namespace knp::core::messaging::impl
+{
+
+/**
+ * @brief Dense handle of a UID.
+ */
+using UIDHandle = uint32_t;
+
+
+/**
+ * @brief Handle of a UID that is not registered.
+ */
+constexpr UIDHandle invalid_uid_handle = std::numeric_limits<UIDHandle>::max();
+
+
+/**
+ * @brief The UIDRegistry class maps UIDs to dense handles.
+ * @details Handles are assigned in the order of registration starting from zero, so they can be used as indexes of
+ * arrays instead of hashing UIDs.
+ */
+class UIDRegistry
+{
+public:
+    /**
+     * @brief Register a UID.
+     * @param uid UID to register.
+     * @return handle of the UID. If the UID is already registered, its handle is returned.
+     */
+    UIDHandle register_uid(const ::boost::uuids::uuid &uid)
+    {
+        const std::unique_lock lock(mutex_);
+        return handles_.emplace(uid, static_cast<UIDHandle>(handles_.size())).first->second;
+    }
+
+    /**
+     * @brief Get handle of a UID.
+     * @param uid UID.
+     * @return handle of the UID or `invalid_uid_handle` if the UID is not registered.
+     */
+    [[nodiscard]] UIDHandle get_handle(const ::boost::uuids::uuid &uid) const
+    {
+        const std::shared_lock lock(mutex_);
+        const auto iter = handles_.find(uid);
+        return iter == handles_.end() ? invalid_uid_handle : iter->second;
+    }
+
+    /**
+     * @brief Get number of registered UIDs.
+     * @return number of UIDs.
+     */
+    [[nodiscard]] size_t size() const
+    {
+        const std::shared_lock lock(mutex_);
+        return handles_.size();
+    }
+
+private:
+    std::unordered_map<::boost::uuids::uuid, UIDHandle, boost::hash<::boost::uuids::uuid>> handles_;
+    mutable std::shared_mutex mutex_;
+};
+
+}  // namespace knp::core::messaging::impl
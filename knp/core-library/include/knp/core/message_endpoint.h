@@ -160,6 +160,21 @@ public:
      */
     void send_message(const knp::core::messaging::MessageVariant &message);
 
+    /**
+     * @brief Send a message to the message bus.
+     * @details The message is moved to shared storage, so it is not copied for receivers.
+     * @param message message to send.
+     */
+    void send_message(knp::core::messaging::MessageVariant &&message);
+
+    /**
+     * @brief Send a shared message to the message bus.
+     * @details The message is passed to receivers without copying. The sender must not change the message after
+     * sending it.
+     * @param message message to send.
+     */
+    void send_message(knp::core::messaging::SharedMessageVariant message);
+
     /**
      * @brief Receive a message from the message bus.
      * @return `true` if a message was received, `false` if no message was received.
@@ -176,6 +191,8 @@ public:
     /**
      * @brief Read messages of the specified type received via subscription.
      * @note After reading the messages, the method clears them from the subscription.
+     * @details Messages that are not shared with other receivers are moved, shared messages are copied. Use
+     * `unload_shared_messages()` to read messages without copying.
      * @tparam MessageType type of messages to read.
      * @param receiver_uid receiver UID.
      * @return vector of messages.
@@ -183,6 +200,17 @@ public:
     template <class MessageType>
     std::vector<MessageType> unload_messages(const knp::core::UID &receiver_uid);
 
+    /**
+     * @brief Read shared messages of the specified type received via subscription.
+     * @note After reading the messages, the method clears them from the subscription.
+     * @details Messages are not copied, a message sent to several receivers is shared by all of them.
+     * @tparam MessageType type of messages to read.
+     * @param receiver_uid receiver UID.
+     * @return vector of shared messages.
+     */
+    template <class MessageType>
+    std::vector<std::shared_ptr<const MessageType>> unload_shared_messages(const knp::core::UID &receiver_uid);
+
 public:
     /**
      * @brief Type of subscription container.
@@ -195,6 +223,13 @@ public:
      */
     const SubscriptionContainer &get_endpoint_subscriptions() const { return subscriptions_; }
 
+    /**
+     * @brief Get revision of endpoint subscriptions.
+     * @details Revision changes when a subscription is added or removed, or when subscription senders change.
+     * @return subscription revision.
+     */
+    [[nodiscard]] size_t get_subscriptions_revision() const;
+
 protected:
     /**
      * @brief Message endpoint implementation.
@@ -207,11 +242,36 @@ protected:
      */
     MessageEndpoint() = default;
 
+private:
+    /**
+     * @brief Update routing table if subscriptions changed since it was built.
+     * @details The method also passes routing keys to the endpoint implementation, so that the message bus delivers
+     * only messages the endpoint needs.
+     */
+    void update_routing_table();
+
+    /**
+     * @brief Notify that the set of messages received by the endpoint changed.
+     */
+    void notify_subscriptions_changed();
+
 private:
     /**
      * @brief Container that stores all the subscriptions for the current endpoint.
      */
     SubscriptionContainer subscriptions_;
+
+    /**
+     * @brief Subscriptions that receive messages with the given routing key.
+     * @details Routing key is built from message type index and dense handle of the sender UID, so the table is
+     * indexed by routing keys.
+     */
+    std::vector<std::vector<SubscriptionVariant *>> routing_table_;
+
+    /**
+     * @brief Value of the subscription change counter used to build the routing table.
+     */
+    size_t routing_table_revision_ = 0;
 };
 
 }  // namespace knp::core
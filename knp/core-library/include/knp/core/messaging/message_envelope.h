@@ -24,6 +24,7 @@
 #include <knp/core/uid.h>
 
 #include <iostream>
+#include <memory>
 #include <variant>
 #include <vector>
 
@@ -47,6 +48,14 @@ namespace knp::core::messaging
 using MessageVariant = boost::mp11::mp_rename<AllMessages, std::variant>;
 
 
+/**
+ * @brief Reference-counted message.
+ * @details Message bus and endpoints pass shared messages, so a message sent to several receivers is not copied.
+ * A message must not be changed while it is shared, only its last owner can move data out of it.
+ */
+using SharedMessageVariant = std::shared_ptr<MessageVariant>;
+
+
 /**
  * @brief Pack messages to envelope.
  * @param message message to pack.
@@ -27,9 +27,14 @@
 #include <knp/neuron-traits/all_traits.h>
 
 #include <functional>
+#include <tuple>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
+#include <boost/iterator/counting_iterator.hpp>
+#include <boost/iterator/transform_iterator.hpp>
+
 /**
  * @brief Core library namespace.
  */
@@ -57,6 +62,25 @@ public:
      * @brief Neuron parameters and their values for the specified neuron type.
      */
     using NeuronParameters = neuron_traits::neuron_parameters<NeuronType>;
+    /**
+     * @brief Neuron parameters stored as columns, if the neuron type supports it.
+     * @see neuron_traits::neuron_columns.
+     */
+    using NeuronColumns = std::conditional_t<
+        neuron_traits::has_neuron_columns_v<NeuronType>, neuron_traits::neuron_columns<NeuronType>, std::tuple<>>;
+    /**
+     * @brief Type returned by constant access to neuron parameters.
+     * @details Parameters of neuron types with columns are gathered from columns and returned by value.
+     */
+    using NeuronConstReference = std::conditional_t<
+        neuron_traits::has_neuron_columns_v<NeuronType>, NeuronParameters, const NeuronParameters &>;
+    /**
+     * @brief Type returned by non-constant access to neuron parameters.
+     * @details Parameters of neuron types with columns are accessed through a proxy object that refers to column
+     * values. The proxy has the same fields as `NeuronParameters`.
+     * @see neuron_traits::neuron_reference.
+     */
+    using NeuronReference = neuron_traits::neuron_reference_t<NeuronType>;
 
     /**
      * @brief Type of the neuron generator.
@@ -104,16 +128,54 @@ public:  // NOLINT
 public:  // NOLINT
     /**
      * @brief Get parameters of all neurons in the population.
+     * @details The method is not available for neuron types with columns, as they don't store a vector of
+     * parameters. Use `gather_neurons_parameters()` for them.
+     * @tparam T neuron type, used to disable the method for neuron types with columns.
+     * @return vector of neuron parameters.
+     */
+    template <typename T = NeuronType, typename = std::enable_if_t<!neuron_traits::has_neuron_columns_v<T>>>
+    [[nodiscard]] const std::vector<NeuronParameters> &get_neurons_parameters() const
+    {
+        return neurons_;
+    }
+
+    /**
+     * @brief Get a copy of parameters of all neurons in the population.
+     * @details Parameters of neuron types with columns are gathered from columns.
      * @return vector of neuron parameters.
      */
-    [[nodiscard]] const std::vector<NeuronParameters> &get_neurons_parameters() const { return neurons_; }
+    [[nodiscard]] std::vector<NeuronParameters> gather_neurons_parameters() const
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            std::vector<NeuronParameters> neurons;
+            neurons.reserve(columns_.size());
+            for (size_t index = 0; index < columns_.size(); ++index) neurons.push_back(columns_.get_neuron(index));
+            return neurons;
+        }
+        else
+        {
+            return neurons_;
+        }
+    }
 
     /**
      * @brief Get parameters of the specific neuron in the population.
+     * @details Parameters of neuron types with columns are returned by value.
      * @param index index of the population neuron.
      * @return specific neuron parameters.
      */
-    [[nodiscard]] const NeuronParameters &get_neuron_parameters(size_t index) const { return neurons_[index]; }
+    [[nodiscard]] NeuronConstReference get_neuron_parameters(size_t index) const
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return columns_.get_neuron(index);
+        }
+        else
+        {
+            return neurons_[index];
+        }
+    }
 
     /**
      * @brief Set parameters for the specific neuron in the population.
@@ -121,7 +183,17 @@ public:  // NOLINT
      * @param parameters vector of neuron parameters defined in NeuronParameters for the population.
      * @note Move method.
      */
-    void set_neuron_parameters(size_t index, NeuronParameters &&parameters) { neurons_[index] = std::move(parameters); }
+    void set_neuron_parameters(size_t index, NeuronParameters &&parameters)
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            columns_.set_neuron(index, parameters);
+        }
+        else
+        {
+            neurons_[index] = std::move(parameters);
+        }
+    }
 
     /**
      * @brief Set parameters for the specific neuron in the population.
@@ -129,7 +201,42 @@ public:  // NOLINT
      * @param parameters vector of neuron parameters defined in NeuronParameters for the population.
      * @note Copy method.
      */
-    void set_neurons_parameters(size_t index, const NeuronParameters &parameters) { neurons_[index] = parameters; }
+    void set_neurons_parameters(size_t index, const NeuronParameters &parameters)
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            columns_.set_neuron(index, parameters);
+        }
+        else
+        {
+            neurons_[index] = parameters;
+        }
+    }
+
+    /**
+     * @brief Get neuron parameters stored as columns.
+     * @details Populations of neuron types with columns always store neuron parameters in columns. Parameters that are
+     * the same for all neurons may be stored in columns once, see `neuron_traits::neuron_columns` specialization for
+     * the neuron type.
+     * @tparam T neuron type, used to disable the method for neuron types without columns.
+     * @return neuron parameter columns.
+     */
+    template <typename T = NeuronType, typename = std::enable_if_t<neuron_traits::has_neuron_columns_v<T>>>
+    [[nodiscard]] NeuronColumns &get_neuron_columns()
+    {
+        return columns_;
+    }
+
+    /**
+     * @brief Get neuron parameters stored as columns.
+     * @tparam T neuron type, used to disable the method for neuron types without columns.
+     * @return constant neuron parameter columns.
+     */
+    template <typename T = NeuronType, typename = std::enable_if_t<neuron_traits::has_neuron_columns_v<T>>>
+    [[nodiscard]] const NeuronColumns &get_neuron_columns() const
+    {
+        return columns_;
+    }
 
 public:  // NOLINT
     /**
@@ -150,6 +257,16 @@ public:  // NOLINT
      */
     void add_neurons(NeuronGenerator generator, size_t count)
     {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                auto neuron = generator(i);
+                if (neuron.has_value()) columns_.push_back(neuron.value());
+            }
+            return;
+        }
+
         neurons_.reserve(count);
         for (size_t i = 0; i < count; ++i)
         {
@@ -184,6 +301,12 @@ public:  // NOLINT
      */
     void remove_neuron(const size_t &neuron_index)
     {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            columns_.erase(neuron_index);
+            return;
+        }
+
         auto iter = neurons_.begin();
         std::advance(iter, neuron_index);
         neurons_.erase(iter);
@@ -192,49 +315,129 @@ public:  // NOLINT
 public:  // NOLINT
     /**
      * @brief Get parameter values of a neuron with the given index.
-     * @note Constant method.
+     * @note Constant method. Parameters of neuron types with columns are returned by value.
      * @param index neuron index.
      * @return neuron parameters.
      */
-    const auto &operator[](size_t index) const { return get_neuron_parameters(index); }
+    NeuronConstReference operator[](size_t index) const { return get_neuron_parameters(index); }
     /**
      * @brief Get parameter values of a neuron with the given index.
+     * @details Parameters of neuron types with columns are accessed through a proxy reference.
      * @param index neuron index.
-     * @return neuron parameters.
+     * @return reference to neuron parameters.
      */
-    auto &operator[](size_t index) { return neurons_[index]; }
+    NeuronReference operator[](size_t index)
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return columns_.get_reference(index);
+        }
+        else
+        {
+            return neurons_[index];
+        }
+    }
 
     /**
      * @brief Get an iterator pointing to the first element of the population.
+     * @details Iterators of populations of neuron types with columns return neuron parameters by value.
      * @return constant population iterator.
      */
-    auto begin() const { return neurons_.cbegin(); }
+    auto begin() const
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return ConstIterator(boost::counting_iterator<size_t>(0), NeuronGetter{this});
+        }
+        else
+        {
+            return neurons_.cbegin();
+        }
+    }
     /**
      * @brief Get an iterator pointing to the first element of the population.
+     * @details Iterators of populations of neuron types with columns return proxy references to neuron parameters.
      * @return population iterator.
      */
-    auto begin() { return neurons_.begin(); }
+    auto begin()
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return Iterator(boost::counting_iterator<size_t>(0), NeuronReferenceGetter{this});
+        }
+        else
+        {
+            return neurons_.begin();
+        }
+    }
     /**
      * @brief Get an iterator pointing to the last element of the population.
      * @return constant iterator.
      */
-    auto end() const { return neurons_.cend(); }
+    auto end() const
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return ConstIterator(boost::counting_iterator<size_t>(size()), NeuronGetter{this});
+        }
+        else
+        {
+            return neurons_.cend();
+        }
+    }
     /**
      * @brief Get an iterator pointing to the last element of the population.
      * @return iterator.
      */
-    auto end() { return neurons_.end(); }
+    auto end()
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return Iterator(boost::counting_iterator<size_t>(size()), NeuronReferenceGetter{this});
+        }
+        else
+        {
+            return neurons_.end();
+        }
+    }
 
 public:  // NOLINT
     /**
      * @brief Count number of neurons in the population.
      * @return number of neurons.
      */
-    [[nodiscard]] size_t size() const { return neurons_.size(); }
+    [[nodiscard]] size_t size() const
+    {
+        if constexpr (neuron_traits::has_neuron_columns_v<NeuronType>)
+        {
+            return columns_.size();
+        }
+        else
+        {
+            return neurons_.size();
+        }
+    }
+
+private:
+    // Getters of neuron parameters by index used by iterators of populations of neuron types with columns.
+    struct NeuronGetter
+    {
+        NeuronConstReference operator()(size_t index) const { return population_->get_neuron_parameters(index); }
+        const Population *population_ = nullptr;
+    };
+    struct NeuronReferenceGetter
+    {
+        NeuronReference operator()(size_t index) const { return (*population_)[index]; }
+        Population *population_ = nullptr;
+    };
+    using ConstIterator = boost::iterators::transform_iterator<NeuronGetter, boost::counting_iterator<size_t>>;
+    using Iterator = boost::iterators::transform_iterator<NeuronReferenceGetter, boost::counting_iterator<size_t>>;
 
 private:
     BaseData base_;
+    // Neuron parameters are stored in `columns_` for neuron types with columns and in `neurons_` otherwise.
     std::vector<NeuronParameters> neurons_;
+    NeuronColumns columns_;
 };
 
 
@@ -33,9 +33,7 @@
 #include <utility>
 #include <vector>
 
-#include <boost/multi_index/hashed_index.hpp>
-#include <boost/multi_index/member.hpp>
-#include <boost/multi_index_container.hpp>
+#include <boost/range/iterator_range.hpp>
 
 
 /**
@@ -96,6 +94,67 @@ public:
      */
     using SynapseGenerator = std::function<std::optional<Synapse>(size_t)>;
 
+    /**
+     * @brief Range of synapse indexes returned by the index lookup methods.
+     * @details The range refers to the projection internal index and is invalidated by any projection modification.
+     */
+    using SynapseIndexRange = boost::iterator_range<std::vector<size_t>::const_iterator>;
+
+    /**
+     * @brief Synapse data stored as a structure of arrays.
+     * @details Columns contain projection synapses in the same order as the projection itself, but each synapse
+     * field is stored in a separate contiguous array and neuron indexes are stored as 32-bit values. Use columns in
+     * computation loops that read only some synapse fields.
+     */
+    struct SynapseColumns
+    {
+        /**
+         * @brief Count number of synapses in the columns.
+         * @return number of synapses.
+         */
+        [[nodiscard]] size_t size() const { return weights_.size(); }
+
+        /**
+         * @brief Call a function for each column.
+         * @tparam Function type of a function that takes a column.
+         * @param function function to call.
+         */
+        template <class Function>
+        void for_each_column(Function function) const
+        {
+            function(weights_);
+            function(delays_);
+            function(output_types_);
+            function(source_neuron_ids_);
+            function(target_neuron_ids_);
+        }
+
+        /**
+         * @brief Synapse weights.
+         */
+        std::vector<decltype(SynapseParameters::weight_)> weights_;
+
+        /**
+         * @brief Synapse delays.
+         */
+        std::vector<decltype(SynapseParameters::delay_)> delays_;
+
+        /**
+         * @brief Synapse output types.
+         */
+        std::vector<decltype(SynapseParameters::output_type_)> output_types_;
+
+        /**
+         * @brief Indexes of presynaptic neurons.
+         */
+        std::vector<uint32_t> source_neuron_ids_;
+
+        /**
+         * @brief Indexes of postsynaptic neurons.
+         */
+        std::vector<uint32_t> target_neuron_ids_;
+    };
+
 public:
     /**
      * @brief Shared synapse parameters for the non-STDP variant of the projection.
@@ -211,10 +270,15 @@ public:
 public:
     /**
      * @brief Get parameter values of a synapse with the given index.
+     * @details Non-constant access marks synapse columns as outdated.
      * @param index synapse index.
      * @return synapse parameters and indexes.
      */
-    [[nodiscard]] Synapse &operator[](size_t index) { return parameters_[index]; }
+    [[nodiscard]] Synapse &operator[](size_t index)
+    {
+        mark_synapses_modified();
+        return parameters_[index];
+    }
 
     /**
      * @brief Get parameter values of a synapse with the given index.
@@ -232,9 +296,14 @@ public:
 
     /**
      * @brief Get an iterator pointing to the first element of the projection.
+     * @details Non-constant access marks synapse columns as outdated.
      * @return projection iterator.
      */
-    [[nodiscard]] auto begin() { return parameters_.begin(); }
+    [[nodiscard]] auto begin()
+    {
+        mark_synapses_modified();
+        return parameters_.begin();
+    }
 
     /**
      * @brief Get an iterator pointing to the last element of the projection.
@@ -244,9 +313,14 @@ public:
 
     /**
      * @brief Get an iterator pointing to the last element of the projection.
+     * @details Non-constant access marks synapse columns as outdated.
      * @return iterator.
      */
-    [[nodiscard]] auto end() { return parameters_.end(); }
+    [[nodiscard]] auto end()
+    {
+        mark_synapses_modified();
+        return parameters_.end();
+    }
 
 public:
     /**
@@ -290,6 +364,78 @@ public:
      */
     [[nodiscard]] std::vector<size_t> find_synapses(size_t neuron_index, Search search_method) const;
 
+    /**
+     * @brief Get indexes of synapses that originate from a presynaptic neuron with the given index.
+     * @details The method doesn't allocate memory if the projection index is up to date.
+     * @param neuron_index index of a presynaptic neuron.
+     * @return range of synapse indexes sorted in ascending order.
+     */
+    [[nodiscard]] SynapseIndexRange synapses_of_presynaptic(size_t neuron_index) const
+    {
+        if (!is_index_updated_) reindex();
+        return presynaptic_index_.find(neuron_index);
+    }
+
+    /**
+     * @brief Get indexes of all synapses sorted by presynaptic neuron index.
+     * @details Indexes of synapses that originate from the same neuron are adjacent and are stored in the same order
+     * as returned by `synapses_of_presynaptic()`. The method doesn't allocate memory if the projection index is up to
+     * date.
+     * @return range of synapse indexes.
+     */
+    [[nodiscard]] SynapseIndexRange presynaptic_synapses() const
+    {
+        if (!is_index_updated_) reindex();
+        return {presynaptic_index_.synapses_.cbegin(), presynaptic_index_.synapses_.cend()};
+    }
+
+    /**
+     * @brief Get indexes of synapses that lead to a postsynaptic neuron with the given index.
+     * @details The method doesn't allocate memory if the projection index is up to date.
+     * @param neuron_index index of a postsynaptic neuron.
+     * @return range of synapse indexes sorted in ascending order.
+     */
+    [[nodiscard]] SynapseIndexRange synapses_of_postsynaptic(size_t neuron_index) const
+    {
+        if (!is_index_updated_) reindex();
+        return postsynaptic_index_.find(neuron_index);
+    }
+
+    /**
+     * @brief Get synapses of the projection stored as a structure of arrays.
+     * @details Columns are a read cache, not a storage mode: synapses are always stored in the projection, and columns
+     * are an additional copy of them built on the first call. The cache is rebuilt if synapses were added or removed,
+     * or accessed through non-constant methods since the last call.
+     * @note Call this method before concurrent column access, as access to outdated columns rebuilds them.
+     * @return synapse columns.
+     */
+    [[nodiscard]] const SynapseColumns &get_synapse_columns() const;
+
+    /**
+     * @brief Notify the projection that synapse parameters were changed.
+     * @details Synapse columns are rebuilt by the next `get_synapse_columns()` call. Code that keeps references to
+     * synapses and changes them later must call this method after the change.
+     */
+    void mark_synapses_modified()
+    {
+        // The flag is written only if columns were built, so concurrent access to projections without columns is safe.
+        if (is_columns_updated_) is_columns_updated_ = false;
+    }
+
+    /**
+     * @brief Build the synapse index if the projection was modified since the last index update.
+     * @note Call this method before concurrent index lookups, as lookups rebuild an outdated index.
+     */
+    void reindex() const;
+
+    /**
+     * @brief Get revision of the projection synapse set.
+     * @details The revision changes each time synapses are added or removed, so code that stores pointers to synapses
+     * can check if the pointers are still valid.
+     * @return synapse set revision.
+     */
+    [[nodiscard]] size_t get_synapses_revision() const { return synapses_revision_; }
+
     /**
      * @brief Append connections to the existing projection.
      * @param generator synapse generation function.
@@ -361,7 +507,30 @@ public:
     const SharedSynapseParameters &get_shared_parameters() const { return shared_parameters_; }
 
 private:
-    void reindex() const;
+    /**
+     * @brief Synapse index in the compressed sparse row format.
+     * @details Indexes of synapses connected to the neuron `N` are stored in the `synapses_` array between
+     * `offsets_[N]` and `offsets_[N + 1]`.
+     */
+    struct SynapseIndex
+    {
+        [[nodiscard]] SynapseIndexRange find(size_t neuron_index) const
+        {
+            if (neuron_index + 1 >= offsets_.size()) return {synapses_.cend(), synapses_.cend()};
+            return {synapses_.cbegin() + offsets_[neuron_index], synapses_.cbegin() + offsets_[neuron_index + 1]};
+        }
+
+        void clear()
+        {
+            offsets_.clear();
+            synapses_.clear();
+        }
+
+        // cppcheck-suppress unusedStructMember
+        std::vector<size_t> offsets_;
+        // cppcheck-suppress unusedStructMember
+        std::vector<size_t> synapses_;
+    };
 
     BaseData base_;
 
@@ -384,34 +553,17 @@ private:
      * @brief Container of synapse parameters.
      */
     std::vector<Synapse> parameters_;
-    // So far the index is mutable so we can reindex a const object that has a non-updated index.
-    struct Connection
-    {
-        size_t from_;
-        size_t to_;
-        size_t index_;
-        bool operator==(const Connection &connection) const
-        {
-            return from_ == connection.from_ && to_ == connection.to_ && index_ == connection.index_;
-        }
-    };
 
-    typedef boost::multi_index::multi_index_container<
-        Connection,
-        boost::multi_index::indexed_by<
-            boost::multi_index::hashed_non_unique<
-                boost::multi_index::tag<struct mi_presynaptic>, BOOST_MULTI_INDEX_MEMBER(Connection, size_t, from_)>,
-            boost::multi_index::hashed_non_unique<
-                boost::multi_index::tag<struct mi_postsynaptic>, BOOST_MULTI_INDEX_MEMBER(Connection, size_t, to_)>,
-            boost::multi_index::hashed_unique<
-                boost::multi_index::tag<struct mi_synapse_index>,
-                BOOST_MULTI_INDEX_MEMBER(Connection, size_t, index_)>>>
-        Index;
-    using ByPresynaptic = mi_presynaptic;
-    using ByPostsynaptic = mi_postsynaptic;
-
-    mutable Index index_;
+    // So far the index is mutable so we can reindex a const object that has a non-updated index.
+    mutable SynapseIndex presynaptic_index_;
+    mutable SynapseIndex postsynaptic_index_;
     mutable bool is_index_updated_ = false;
+    // Incremented by methods that add or remove synapses.
+    size_t synapses_revision_ = 0;
+
+    // Columns are mutable for the same reason as the index.
+    mutable SynapseColumns columns_;
+    mutable bool is_columns_updated_ = false;
 
     SharedSynapseParameters shared_parameters_;
 };
@@ -23,8 +23,11 @@
 #include <knp/core/uid.h>
 
 #include <algorithm>
+#include <atomic>
+#include <memory>
 #include <string>
 #include <unordered_set>
+#include <utility>
 #include <vector>
 
 #include <boost/functional/hash.hpp>
@@ -45,10 +48,16 @@ public:
      * @brief Message type.
      */
     using MessageType = MessageT;
+    /**
+     * @brief Reference-counted message of the specified message type.
+     * @details The message can be shared by all subscriptions that receive it, so it must not be changed while other
+     * owners exist.
+     */
+    using SharedMessageType = std::shared_ptr<MessageType>;
     /**
      * @brief Internal container for messages of the specified message type.
      */
-    using MessageContainerType = std::vector<MessageType>;
+    using MessageContainerType = std::vector<SharedMessageType>;
 
     /**
      * @brief Internal container for UIDs.
@@ -82,7 +91,12 @@ public:
      * @param uid sender UID.
      * @return number of senders deleted from subscription.
      */
-    size_t remove_sender(const UID &uid) { return senders_.erase(static_cast<boost::uuids::uuid>(uid)); }
+    size_t remove_sender(const UID &uid)
+    {
+        const size_t result = senders_.erase(static_cast<boost::uuids::uuid>(uid));
+        if (result) notify_change();
+        return result;
+    }
 
     /**
      * @brief Add a sender with the given UID to the subscription.
@@ -90,7 +104,12 @@ public:
      * @param uid UID of the new sender.
      * @return number of senders added.
      */
-    size_t add_sender(const UID &uid) { return senders_.insert(static_cast<boost::uuids::uuid>(uid)).second; }
+    size_t add_sender(const UID &uid)
+    {
+        const size_t result = senders_.insert(static_cast<boost::uuids::uuid>(uid)).second;
+        if (result) notify_change();
+        return result;
+    }
 
     /**
      * @brief Add several senders to the subscription.
@@ -101,7 +120,9 @@ public:
     {
         size_t size_before = senders_.size();
         std::copy(senders.begin(), senders.end(), std::inserter(senders_, senders_.end()));
-        return senders_.size() - size_before;
+        const size_t result = senders_.size() - size_before;
+        if (result) notify_change();
+        return result;
     }
 
     /**
@@ -114,17 +135,32 @@ public:
         return senders_.find(static_cast<boost::uuids::uuid>(uid)) != senders_.end();
     }
 
+    /**
+     * @brief Set a counter that is incremented every time the list of senders changes.
+     * @details Message endpoints use the counter to detect that their routing tables are outdated.
+     * @param change_counter shared counter of changes.
+     */
+    void set_change_counter(std::shared_ptr<std::atomic<size_t>> change_counter)
+    {
+        change_counter_ = std::move(change_counter);
+    }
+
 public:
     /**
      * @brief Add a message to the subscription.
      * @param message message to add.
      */
-    void add_message(MessageType &&message) { messages_.push_back(message); }
+    void add_message(MessageType &&message) { messages_.push_back(std::make_shared<MessageType>(std::move(message))); }
     /**
      * @brief Add a message to the subscription.
      * @param message constant message to add.
      */
-    void add_message(const MessageType &message) { messages_.push_back(message); }
+    void add_message(const MessageType &message) { messages_.push_back(std::make_shared<MessageType>(message)); }
+    /**
+     * @brief Add a shared message to the subscription without copying it.
+     * @param message shared message to add.
+     */
+    void add_message(SharedMessageType message) { messages_.push_back(std::move(message)); }
 
     /**
      * @brief Get all messages.
@@ -142,6 +178,15 @@ public:
      */
     void clear_messages() { messages_.clear(); }
 
+private:
+    /**
+     * @brief Increment change counter if it is set.
+     */
+    void notify_change()
+    {
+        if (change_counter_) ++*change_counter_;
+    }
+
 private:
     /**
      * @brief Receiver UID.
@@ -156,6 +201,10 @@ private:
      * @brief Message storage.
      */
     MessageContainerType messages_;
+    /**
+     * @brief Counter of sender list changes shared with the message endpoint.
+     */
+    std::shared_ptr<std::atomic<size_t>> change_counter_;
 };
 
 }  // namespace knp::core
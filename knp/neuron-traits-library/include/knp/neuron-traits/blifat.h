@@ -21,9 +21,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
 #include <limits>
 #include <numeric>
 #include <utility>
+#include <vector>
 
 #include "type_traits.h"
 
@@ -33,17 +38,32 @@
 namespace knp::neuron_traits
 {
 
+/**
+ * @brief BLIFAT neuron with the given precision of real-valued parameters. Use as a template parameter only.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ */
+template <typename Real>
+struct BLIFATNeuronT;
+
 /**
  * @brief BLIFAT neuron. Use as a template parameter only.
  */
-struct BLIFATNeuron;
+using BLIFATNeuron = BLIFATNeuronT<double>;
+
+/**
+ * @brief BLIFAT neuron with single-precision real-valued parameters. Use as a template parameter only.
+ * @details The neuron halves memory used by populations and doubles SIMD width compared to `BLIFATNeuron`, which may
+ * be useful for inference if single precision is accurate enough.
+ */
+using BLIFATFloatNeuron = BLIFATNeuronT<float>;
 
 
 /**
  * @brief Structure for BLIFAT neuron default values.
+ * @tparam Real floating-point type of real-valued neuron parameters.
  */
-template <>
-struct default_values<BLIFATNeuron>
+template <typename Real>
+struct default_values<BLIFATNeuronT<Real>>
 {
     /**
      * @brief The parameter defines the default value of `n_time_steps_since_last_firing_` for a BLIFAT neuron.
@@ -54,78 +74,78 @@ struct default_values<BLIFATNeuron>
      * @brief The parameter defines a value to which membrane potential tends (for conductance-based inhibitory
      * synapses)
      */
-    constexpr static double reversal_inhibitory_potential_ = -0.3;
+    constexpr static Real reversal_inhibitory_potential_ = -0.3;
 
     /**
      * @brief The parameter defines a value to which membrane potential tends (for current-based inhibitory synapses).
      */
-    constexpr static double min_potential_ = -1.0e9;
+    constexpr static Real min_potential_ = -1.0e9;
 
     /**
      * @brief The parameter defines a threshold for membrane potential.
      */
-    constexpr static double activation_threshold_ = 1.0;
+    constexpr static Real activation_threshold_ = 1.0;
 
     /**
      * @brief The parameter defines a dynamic threshold for membrane potential after reaching which a neuron generates a
      * spike.
      */
 
-    constexpr static double dynamic_threshold_ = 0.;
+    constexpr static Real dynamic_threshold_ = 0.;
     /**
      * @brief The parameter defines a time constant during which the `dynamic_threshold_` parameter tends to its base
      * value if nothing happens.
      */
-    constexpr static double threshold_decay_ = 0.;
+    constexpr static Real threshold_decay_ = 0.;
 
     /**
      * @brief The parameter defines a value that increases the `dynamic_threshold_` value if a neuron generates a spike.
      */
-    constexpr static double threshold_increment_ = 0.;
+    constexpr static Real threshold_increment_ = 0.;
 
     /**
      * @brief The parameter defines a threshold after reaching which a neuron generates spikes.
      */
-    constexpr static double postsynaptic_trace_ = 0.;
+    constexpr static Real postsynaptic_trace_ = 0.;
 
     /**
      * @brief The parameter defines a time constant during which the `postsynaptic_trace_` parameter tends to zero if
      * nothing happens.
      * @details If `postsynaptic_trace_decay_` equals `0`, then `postsynaptic_trace_` also equals `0`.
      */
-    constexpr static double postsynaptic_trace_decay_ = 0.;
+    constexpr static Real postsynaptic_trace_decay_ = 0.;
 
     /**
      * @brief The parameter defines a value that increases the `postsynaptic_trace_` value if a neuron generates a
      * spike.
      */
-    constexpr static double postsynaptic_trace_increment_ = 0.;
+    constexpr static Real postsynaptic_trace_increment_ = 0.;
 
     /**
      * @brief The parameter defines speed with which a potential tends to the `reversal_inhibitory_potential` value.
      */
-    constexpr static double inhibitory_conductance_ = 0.;
+    constexpr static Real inhibitory_conductance_ = 0.;
 
     /**
      * @brief The parameter defines a time constant during which the `inhibitory_conductance_` value decreases.
      */
-    constexpr static double inhibitory_conductance_decay_ = 0.;
+    constexpr static Real inhibitory_conductance_decay_ = 0.;
 
     /**
      * @brief The parameter defines the current membrane potential.
      */
-    constexpr static double potential_ = 0;
+    constexpr static Real potential_ = 0;
 
     /**
      * @brief This parameter is used if there was a blocking signal.
      * @details If used, all potential changes due to synapses are ignored.
      */
-    constexpr static double pre_impact_potential_ = 0;
+    constexpr static Real pre_impact_potential_ = 0;
 
     /**
      * @brief The parameter defines a time constant during which the `potential_` value tends to zero.
      */
-    constexpr static double potential_decay_ = 0;
+    constexpr static Real potential_decay_ = 0;
 
     /**
      * @brief The parameter defines a counter for the `bursting_period_` value.
@@ -141,7 +161,7 @@ struct default_values<BLIFATNeuron>
     /**
      * @brief The parameter defines a value that increases the membrane potential after a neuron generates a spike.
      */
-    constexpr static double reflexive_weight_ = 0;
+    constexpr static Real reflexive_weight_ = 0;
 
     /**
      * @brief The parameter defines a minimum number of network steps before a neuron can generate the next spike.
@@ -151,7 +171,7 @@ struct default_values<BLIFATNeuron>
     /**
      * @brief The parameter defines a potential value after a neuron generates a spike.
      */
-    constexpr static double potential_reset_value_ = 0.;
+    constexpr static Real potential_reset_value_ = 0.;
 
     /**
      * @brief The parameter defines the default value for the number of network execution steps,
@@ -162,119 +182,827 @@ struct default_values<BLIFATNeuron>
     /**
      * @brief The parameter defines a dopamine value used to sum up all incoming dopamine synapse impacts.
      */
-    constexpr static double dopamine_value_ = 0.0;
+    constexpr static Real dopamine_value_ = 0.0;
 };
 
 
 /**
  * @brief Structure for BLIFAT neuron parameters.
+ * @tparam Real floating-point type of real-valued neuron parameters.
  */
-template <>
-struct neuron_parameters<BLIFATNeuron>
+template <typename Real>
+struct neuron_parameters<BLIFATNeuronT<Real>>
 {
     /**
      * @brief The parameter defines a number of network steps since the last spike.
      */
-    std::size_t n_time_steps_since_last_firing_ = default_values<BLIFATNeuron>::n_time_steps_since_last_firing_;
+    std::size_t n_time_steps_since_last_firing_ = default_values<BLIFATNeuronT<Real>>::n_time_steps_since_last_firing_;
 
     /**
      * @brief The parameter defines a threshold for membrane potential.
      */
-    double activation_threshold_ = default_values<BLIFATNeuron>::activation_threshold_;
+    Real activation_threshold_ = default_values<BLIFATNeuronT<Real>>::activation_threshold_;
     /**
      * @brief The parameter defines a dynamic threshold for membrane potential after reaching which a neuron generates a
      * spike.
      */
-    double dynamic_threshold_ = default_values<BLIFATNeuron>::dynamic_threshold_;
+    Real dynamic_threshold_ = default_values<BLIFATNeuronT<Real>>::dynamic_threshold_;
     /**
      * @brief The parameter defines a time constant during which the `dynamic_threshold_` parameter tends to its base
      * value if nothing happens.
      */
-    double threshold_decay_ = default_values<BLIFATNeuron>::threshold_decay_;
+    Real threshold_decay_ = default_values<BLIFATNeuronT<Real>>::threshold_decay_;
     /**
      * @brief The parameter defines a value that increases the `dynamic_threshold_` value if a neuron generates a spike.
      */
-    double threshold_increment_ = default_values<BLIFATNeuron>::threshold_increment_;
+    Real threshold_increment_ = default_values<BLIFATNeuronT<Real>>::threshold_increment_;
     /**
      * @brief The parameter defines a threshold after reaching which a neuron generates spikes.
      */
-    double postsynaptic_trace_ = default_values<BLIFATNeuron>::postsynaptic_trace_;
+    Real postsynaptic_trace_ = default_values<BLIFATNeuronT<Real>>::postsynaptic_trace_;
     /**
      * @brief The parameter defines a time constant during which the `postsynaptic_trace_` parameter tends to zero if
      * nothing happens.
      * @details If `postsynaptic_trace_decay_` equals `0`, then `postsynaptic_trace_` also equals `0`.
      */
-    double postsynaptic_trace_decay_ = default_values<BLIFATNeuron>::postsynaptic_trace_decay_;
+    Real postsynaptic_trace_decay_ = default_values<BLIFATNeuronT<Real>>::postsynaptic_trace_decay_;
     /**
      * @brief The parameter defines a value that increases the `postsynaptic_trace_` value if a neuron generates a
      * spike.
      */
-    double postsynaptic_trace_increment_ = default_values<BLIFATNeuron>::postsynaptic_trace_increment_;
+    Real postsynaptic_trace_increment_ = default_values<BLIFATNeuronT<Real>>::postsynaptic_trace_increment_;
     /**
      * @brief The parameter defines speed with which a potential tends to the `reversal_inhibitory_potential` value.
      */
-    double inhibitory_conductance_ = default_values<BLIFATNeuron>::inhibitory_conductance_;
+    Real inhibitory_conductance_ = default_values<BLIFATNeuronT<Real>>::inhibitory_conductance_;
 
     /**
      * @brief The parameter defines a time constant during which the `inhibitory_conductance_` value decreases.
      */
-    double inhibitory_conductance_decay_ = default_values<BLIFATNeuron>::inhibitory_conductance_decay_;
+    Real inhibitory_conductance_decay_ = default_values<BLIFATNeuronT<Real>>::inhibitory_conductance_decay_;
     /**
      * @brief The parameter defines the current membrane potential.
      */
-    double potential_ = default_values<BLIFATNeuron>::potential_;
+    Real potential_ = default_values<BLIFATNeuronT<Real>>::potential_;
     /**
      * @brief This parameter is used if there was a blocking signal.
      * @details If used, all potential changes due to synapses are ignored.
      */
-    double pre_impact_potential_ = default_values<BLIFATNeuron>::pre_impact_potential_;
+    Real pre_impact_potential_ = default_values<BLIFATNeuronT<Real>>::pre_impact_potential_;
     /**
      * @brief The parameter defines a time constant during which the `potential_` value tends to zero.
      */
-    double potential_decay_ = default_values<BLIFATNeuron>::potential_decay_;
+    Real potential_decay_ = default_values<BLIFATNeuronT<Real>>::potential_decay_;
 
     /**
      * @brief The parameter defines a counter for the `bursting_period_` value.
      */
-    unsigned bursting_phase_ = default_values<BLIFATNeuron>::bursting_phase_;
+    unsigned bursting_phase_ = default_values<BLIFATNeuronT<Real>>::bursting_phase_;
 
     /**
      * @brief The parameter defines a number of network steps after reaching which a neuron generates a spike.
      * @details Value of 0 means that no bursting occurs.
      */
-    unsigned bursting_period_ = default_values<BLIFATNeuron>::bursting_period_;
+    unsigned bursting_period_ = default_values<BLIFATNeuronT<Real>>::bursting_period_;
     /**
      * @brief The parameter defines a value that increases the membrane potential after a neuron generates a spike.
      */
-    double reflexive_weight_ = default_values<BLIFATNeuron>::reflexive_weight_;
+    Real reflexive_weight_ = default_values<BLIFATNeuronT<Real>>::reflexive_weight_;
 
     /**
      * @brief The parameter takes the default value of `reversal_inhibitory_potential` defined for a BLIFAT neuron.
      */
-    double reversal_inhibitory_potential_ = default_values<BLIFATNeuron>::reversal_inhibitory_potential_;
+    Real reversal_inhibitory_potential_ = default_values<BLIFATNeuronT<Real>>::reversal_inhibitory_potential_;
 
     /**
      * @brief The parameter defines a minimum number of network steps before a neuron can generate the next spike.
      */
-    unsigned absolute_refractory_period_ = default_values<BLIFATNeuron>::absolute_refractory_period_;
+    unsigned absolute_refractory_period_ = default_values<BLIFATNeuronT<Real>>::absolute_refractory_period_;
     /**
      * @brief The parameter defines a potential value after a neuron generates a spike.
      */
-    double potential_reset_value_ = default_values<BLIFATNeuron>::potential_reset_value_;
+    Real potential_reset_value_ = default_values<BLIFATNeuronT<Real>>::potential_reset_value_;
 
     /**
      * @brief The parameter takes the default value of `min_potential` defined for a BLIFAT neuron.
      */
-    double min_potential_ = default_values<BLIFATNeuron>::min_potential_;
+    Real min_potential_ = default_values<BLIFATNeuronT<Real>>::min_potential_;
     /**
      * @brief The parameter defines the number of network execution steps, during which the neuron activity is totally
      * blocked.
      */
-    int64_t total_blocking_period_ = default_values<BLIFATNeuron>::total_blocking_period_;
+    int64_t total_blocking_period_ = default_values<BLIFATNeuronT<Real>>::total_blocking_period_;
     /**
      * @brief The parameter defines a dopamine value used to sum up all incoming dopamine synapse impacts.
      */
-    double dopamine_value_ = default_values<BLIFATNeuron>::dopamine_value_;
+    Real dopamine_value_ = default_values<BLIFATNeuronT<Real>>::dopamine_value_;
+};
+
+
+/**
+ * @brief Structure for BLIFAT neuron parameters stored as columns.
+ * @tparam Real floating-point type of real-valued neuron parameters.
+ * @details Each parameter of `neuron_parameters<BLIFATNeuronT<Real>>` is stored in its own container, so that
+ * vectorized calculation routines only load parameters they use. Static parameters, which don't change during
+ * inference, are stored once if they are the same for all neurons.
+ *
+ * Columns also support lazy update mode. In this mode, only active neurons are calculated at every step. A neuron is
+ * deactivated when it becomes quiescent: it is not bursting, has no inhibitory conductance and can't reach its
+ * activation threshold without synaptic impacts. A quiescent neuron doesn't spike, so its state is a closed-form
+ * function of the number of passed steps. The state is advanced analytically when the neuron is activated by an impact
+ * or gathered by `get_neuron()`.
+ */
+template <typename Real>
+struct neuron_columns<BLIFATNeuronT<Real>>
+{
+    /**
+     * @brief Neuron parameters stored in a single column row.
+     */
+    using Parameters = neuron_parameters<BLIFATNeuronT<Real>>;
+
+    /**
+     * @brief Get number of neurons stored in columns.
+     * @return number of neurons.
+     */
+    [[nodiscard]] size_t size() const { return potential_.size(); }
+
+    /**
+     * @brief Check if static parameters are shared by all neurons.
+     * @details Each static parameter column contains a single value if static parameters are shared.
+     * @return `true` if static parameters are shared by all neurons.
+     */
+    [[nodiscard]] bool has_shared_static_parameters() const { return has_shared_static_parameters_; }
+
+    /**
+     * @brief Get index of neuron values in static parameter columns.
+     * @param index neuron index.
+     * @return index of neuron values in static parameter columns.
+     */
+    [[nodiscard]] size_t get_static_index(size_t index) const { return has_shared_static_parameters_ ? 0 : index; }
+
+    /**
+     * @brief Reference to a static parameter of a neuron.
+     * @details Static parameters may be shared by all neurons, so they are not referenced directly. Assigning a value
+     * that differs from the shared one makes each neuron store its own static parameters.
+     * @tparam T parameter type.
+     */
+    template <typename T>
+    class StaticParameterReference
+    {
+    public:
+        /**
+         * @brief Construct a reference to a static parameter.
+         * @param columns neuron columns.
+         * @param column static parameter column.
+         * @param index neuron index.
+         */
+        StaticParameterReference(neuron_columns &columns, std::vector<T> &column, size_t index)
+            : columns_(&columns), column_(&column), index_(index)
+        {
+        }
+
+        /**
+         * @brief Get parameter value.
+         * @return parameter value.
+         */
+        operator T() const { return (*column_)[columns_->get_static_index(index_)]; }  // NOLINT
+
+        /**
+         * @brief Set parameter value.
+         * @param value new parameter value.
+         * @return reference to the parameter.
+         */
+        StaticParameterReference &operator=(T value)
+        {
+            if (columns_->has_shared_static_parameters_)
+            {
+                if ((*column_)[0] == value) return *this;
+                columns_->unshare_static_parameters();
+            }
+            (*column_)[index_] = value;
+            return *this;
+        }
+
+        /**
+         * @brief Add a value to the parameter.
+         * @param value value to add.
+         * @return reference to the parameter.
+         */
+        StaticParameterReference &operator+=(T value) { return *this = static_cast<T>(*this) + value; }
+
+        /**
+         * @brief Subtract a value from the parameter.
+         * @param value value to subtract.
+         * @return reference to the parameter.
+         */
+        StaticParameterReference &operator-=(T value) { return *this = static_cast<T>(*this) - value; }
+
+        /**
+         * @brief Set parameter value from another parameter reference.
+         * @param other reference to a parameter which value is assigned.
+         * @return reference to the parameter.
+         */
+        StaticParameterReference &operator=(const StaticParameterReference &other)
+        {
+            return *this = static_cast<T>(other);
+        }
+
+    private:
+        neuron_columns *columns_;
+        std::vector<T> *column_;
+        size_t index_;
+    };
+
+    /**
+     * @brief Reference to parameters of a neuron stored in columns.
+     * @details The reference has the same fields as `Parameters`. Fields of dynamic parameters refer to column values
+     * directly, fields of static parameters are `StaticParameterReference` objects. The reference is invalidated if
+     * neurons are added or removed.
+     */
+    class Reference
+    {
+    public:
+        /**
+         * @brief Construct a reference to neuron parameters.
+         * @param columns neuron columns.
+         * @param index neuron index.
+         */
+        Reference(neuron_columns &columns, size_t index)
+            : n_time_steps_since_last_firing_(columns.n_time_steps_since_last_firing_[index]),
+              dynamic_threshold_(columns.dynamic_threshold_[index]),
+              postsynaptic_trace_(columns.postsynaptic_trace_[index]),
+              inhibitory_conductance_(columns.inhibitory_conductance_[index]),
+              potential_(columns.potential_[index]),
+              pre_impact_potential_(columns.pre_impact_potential_[index]),
+              bursting_phase_(columns.bursting_phase_[index]),
+              total_blocking_period_(columns.total_blocking_period_[index]),
+              dopamine_value_(columns.dopamine_value_[index]),
+              activation_threshold_(columns, columns.activation_threshold_, index),
+              threshold_decay_(columns, columns.threshold_decay_, index),
+              threshold_increment_(columns, columns.threshold_increment_, index),
+              postsynaptic_trace_decay_(columns, columns.postsynaptic_trace_decay_, index),
+              postsynaptic_trace_increment_(columns, columns.postsynaptic_trace_increment_, index),
+              inhibitory_conductance_decay_(columns, columns.inhibitory_conductance_decay_, index),
+              potential_decay_(columns, columns.potential_decay_, index),
+              bursting_period_(columns, columns.bursting_period_, index),
+              reflexive_weight_(columns, columns.reflexive_weight_, index),
+              reversal_inhibitory_potential_(columns, columns.reversal_inhibitory_potential_, index),
+              absolute_refractory_period_(columns, columns.absolute_refractory_period_, index),
+              potential_reset_value_(columns, columns.potential_reset_value_, index),
+              min_potential_(columns, columns.min_potential_, index),
+              columns_(&columns),
+              index_(index)
+        {
+        }
+
+        /**
+         * @brief Gather neuron parameters.
+         * @return neuron parameters.
+         */
+        operator Parameters() const { return columns_->get_neuron(index_); }  // NOLINT
+
+        /**
+         * @brief Set neuron parameters.
+         * @param neuron new neuron parameters.
+         * @return reference to the neuron parameters.
+         */
+        Reference &operator=(const Parameters &neuron)
+        {
+            columns_->set_neuron(index_, neuron);
+            return *this;
+        }
+
+        /**
+         * @brief Set neuron parameters from another neuron.
+         * @param other reference to the neuron which parameters are assigned.
+         * @return reference to the neuron parameters.
+         */
+        Reference &operator=(const Reference &other) { return *this = static_cast<Parameters>(other); }
+
+        /**
+         * @brief References to dynamic parameters with the same names as `Parameters` fields.
+         */
+        decltype(Parameters::n_time_steps_since_last_firing_) &n_time_steps_since_last_firing_;
+        decltype(Parameters::dynamic_threshold_) &dynamic_threshold_;
+        decltype(Parameters::postsynaptic_trace_) &postsynaptic_trace_;
+        decltype(Parameters::inhibitory_conductance_) &inhibitory_conductance_;
+        decltype(Parameters::potential_) &potential_;
+        decltype(Parameters::pre_impact_potential_) &pre_impact_potential_;
+        decltype(Parameters::bursting_phase_) &bursting_phase_;
+        decltype(Parameters::total_blocking_period_) &total_blocking_period_;
+        decltype(Parameters::dopamine_value_) &dopamine_value_;
+
+        /**
+         * @brief References to static parameters with the same names as `Parameters` fields.
+         */
+        StaticParameterReference<decltype(Parameters::activation_threshold_)> activation_threshold_;
+        StaticParameterReference<decltype(Parameters::threshold_decay_)> threshold_decay_;
+        StaticParameterReference<decltype(Parameters::threshold_increment_)> threshold_increment_;
+        StaticParameterReference<decltype(Parameters::postsynaptic_trace_decay_)> postsynaptic_trace_decay_;
+        StaticParameterReference<decltype(Parameters::postsynaptic_trace_increment_)> postsynaptic_trace_increment_;
+        StaticParameterReference<decltype(Parameters::inhibitory_conductance_decay_)> inhibitory_conductance_decay_;
+        StaticParameterReference<decltype(Parameters::potential_decay_)> potential_decay_;
+        StaticParameterReference<decltype(Parameters::bursting_period_)> bursting_period_;
+        StaticParameterReference<decltype(Parameters::reflexive_weight_)> reflexive_weight_;
+        StaticParameterReference<decltype(Parameters::reversal_inhibitory_potential_)> reversal_inhibitory_potential_;
+        StaticParameterReference<decltype(Parameters::absolute_refractory_period_)> absolute_refractory_period_;
+        StaticParameterReference<decltype(Parameters::potential_reset_value_)> potential_reset_value_;
+        StaticParameterReference<decltype(Parameters::min_potential_)> min_potential_;
+
+    private:
+        neuron_columns *columns_;
+        size_t index_;
+    };
+
+    /**
+     * @brief Get a reference to parameters of a neuron with the given index.
+     * @details In lazy update mode the neuron is activated, so that its dynamic parameters are up to date.
+     * @param index neuron index.
+     * @return reference to neuron parameters.
+     */
+    [[nodiscard]] Reference get_reference(size_t index)
+    {
+        if (is_lazy_update_enabled_) activate_neuron(index);
+        return Reference(*this, index);
+    }
+
+    /**
+     * @brief Call a function for each column that stores a value for each neuron.
+     * @details Static parameter columns are skipped if static parameters are shared by all neurons. Columns of lazy
+     * update mode are skipped.
+     * @tparam Function type of a function that takes a column.
+     * @param function function to call.
+     */
+    template <class Function>
+    void for_each_neuron_column(Function function)
+    {
+        function(n_time_steps_since_last_firing_);
+        function(dynamic_threshold_);
+        function(postsynaptic_trace_);
+        function(inhibitory_conductance_);
+        function(potential_);
+        function(pre_impact_potential_);
+        function(bursting_phase_);
+        function(total_blocking_period_);
+        function(dopamine_value_);
+        if (has_shared_static_parameters_) return;
+
+        function(activation_threshold_);
+        function(threshold_decay_);
+        function(threshold_increment_);
+        function(postsynaptic_trace_decay_);
+        function(postsynaptic_trace_increment_);
+        function(inhibitory_conductance_decay_);
+        function(potential_decay_);
+        function(bursting_period_);
+        function(reflexive_weight_);
+        function(reversal_inhibitory_potential_);
+        function(absolute_refractory_period_);
+        function(potential_reset_value_);
+        function(min_potential_);
+    }
+
+    /**
+     * @brief Check if two neurons have the same static parameters.
+     * @param first first neuron parameters.
+     * @param second second neuron parameters.
+     * @return `true` if all static parameters are equal.
+     */
+    [[nodiscard]] static bool have_same_static_parameters(const Parameters &first, const Parameters &second)
+    {
+        return first.activation_threshold_ == second.activation_threshold_ &&
+               first.threshold_decay_ == second.threshold_decay_ &&
+               first.threshold_increment_ == second.threshold_increment_ &&
+               first.postsynaptic_trace_decay_ == second.postsynaptic_trace_decay_ &&
+               first.postsynaptic_trace_increment_ == second.postsynaptic_trace_increment_ &&
+               first.inhibitory_conductance_decay_ == second.inhibitory_conductance_decay_ &&
+               first.potential_decay_ == second.potential_decay_ &&
+               first.bursting_period_ == second.bursting_period_ &&
+               first.reflexive_weight_ == second.reflexive_weight_ &&
+               first.reversal_inhibitory_potential_ == second.reversal_inhibitory_potential_ &&
+               first.absolute_refractory_period_ == second.absolute_refractory_period_ &&
+               first.potential_reset_value_ == second.potential_reset_value_ &&
+               first.min_potential_ == second.min_potential_;
+    }
+
+    /**
+     * @brief Store parameters of neurons in columns.
+     * @details Previous column contents are replaced. Static parameters are stored once if they are the same for all
+     * neurons.
+     * @param neurons neuron parameters.
+     */
+    void assign(const std::vector<Parameters> &neurons)
+    {
+        *this = neuron_columns{};
+        // Lazy update mode is disabled, calculation routines enable it again if needed.
+        has_shared_static_parameters_ =
+            !neurons.empty() && std::all_of(
+                                    neurons.begin(), neurons.end(), [&neurons](const Parameters &neuron)
+                                    { return have_same_static_parameters(neuron, neurons.front()); });
+
+        for (const auto &neuron : neurons)
+        {
+            n_time_steps_since_last_firing_.push_back(neuron.n_time_steps_since_last_firing_);
+            dynamic_threshold_.push_back(neuron.dynamic_threshold_);
+            postsynaptic_trace_.push_back(neuron.postsynaptic_trace_);
+            inhibitory_conductance_.push_back(neuron.inhibitory_conductance_);
+            potential_.push_back(neuron.potential_);
+            pre_impact_potential_.push_back(neuron.pre_impact_potential_);
+            bursting_phase_.push_back(neuron.bursting_phase_);
+            total_blocking_period_.push_back(neuron.total_blocking_period_);
+            dopamine_value_.push_back(neuron.dopamine_value_);
+        }
+
+        const size_t static_count = has_shared_static_parameters_ ? 1 : neurons.size();
+        for (size_t index = 0; index < static_count; ++index)
+        {
+            const auto &neuron = neurons[index];
+            activation_threshold_.push_back(neuron.activation_threshold_);
+            threshold_decay_.push_back(neuron.threshold_decay_);
+            threshold_increment_.push_back(neuron.threshold_increment_);
+            postsynaptic_trace_decay_.push_back(neuron.postsynaptic_trace_decay_);
+            postsynaptic_trace_increment_.push_back(neuron.postsynaptic_trace_increment_);
+            inhibitory_conductance_decay_.push_back(neuron.inhibitory_conductance_decay_);
+            potential_decay_.push_back(neuron.potential_decay_);
+            bursting_period_.push_back(neuron.bursting_period_);
+            reflexive_weight_.push_back(neuron.reflexive_weight_);
+            reversal_inhibitory_potential_.push_back(neuron.reversal_inhibitory_potential_);
+            absolute_refractory_period_.push_back(neuron.absolute_refractory_period_);
+            potential_reset_value_.push_back(neuron.potential_reset_value_);
+            min_potential_.push_back(neuron.min_potential_);
+        }
+    }
+
+    /**
+     * @brief Store parameters of a neuron with the given index in columns.
+     * @details In lazy update mode the neuron is activated.
+     * @param index neuron index.
+     * @param neuron neuron parameters.
+     */
+    void set_neuron(size_t index, const Parameters &neuron)
+    {
+        if (is_lazy_update_enabled_) activate_neuron(index);
+        if (has_shared_static_parameters_ && !have_same_static_parameters(neuron, get_neuron(0)))
+        {
+            unshare_static_parameters();
+        }
+        for_each_column_value(
+            index, [&neuron](auto &column, size_t value_index, auto Parameters::*field)
+            { column[value_index] = neuron.*field; });
+    }
+
+    /**
+     * @brief Add a neuron to the end of columns.
+     * @details Lazy update mode is disabled.
+     * @param neuron neuron parameters.
+     */
+    void push_back(const Parameters &neuron)
+    {
+        disable_lazy_update();
+        const size_t index = size();
+        if (0 == index)
+        {
+            has_shared_static_parameters_ = true;
+        }
+        else if (has_shared_static_parameters_ && !have_same_static_parameters(neuron, get_neuron(0)))
+        {
+            unshare_static_parameters();
+        }
+        // Shared static parameters are already stored if the neuron is not the first one.
+        for_each_column_value(
+            index, [&neuron](auto &column, size_t value_index, auto Parameters::*field)
+            {
+                if (value_index == column.size()) column.push_back(neuron.*field);
+            });
+    }
+
+    /**
+     * @brief Remove a neuron from columns.
+     * @details Lazy update mode is disabled.
+     * @param index neuron index.
+     */
+    void erase(size_t index)
+    {
+        disable_lazy_update();
+        const size_t neuron_count = size();
+        // Shared static parameters are removed with the last neuron.
+        for_each_column_value(
+            index, [neuron_count](auto &column, size_t value_index, auto)
+            {
+                if (column.size() != neuron_count) return;
+                column.erase(column.begin() + static_cast<std::ptrdiff_t>(value_index));
+            });
+        if (0 == size()) has_shared_static_parameters_ = false;
+    }
+
+    /**
+     * @brief Store static parameters of each neuron separately.
+     */
+    void unshare_static_parameters()
+    {
+        if (!has_shared_static_parameters_) return;
+        has_shared_static_parameters_ = false;
+        const size_t neuron_count = size();
+        for_each_static_column([neuron_count](auto &column) { column.resize(neuron_count, column.front()); });
+    }
+
+    /**
+     * @brief Gather parameters of a neuron with the given index from columns.
+     * @param index neuron index.
+     * @return neuron parameters.
+     */
+    [[nodiscard]] Parameters get_neuron(size_t index) const
+    {
+        Parameters neuron;
+        neuron.n_time_steps_since_last_firing_ = n_time_steps_since_last_firing_[index];
+        neuron.dynamic_threshold_ = dynamic_threshold_[index];
+        neuron.postsynaptic_trace_ = postsynaptic_trace_[index];
+        neuron.inhibitory_conductance_ = inhibitory_conductance_[index];
+        neuron.potential_ = potential_[index];
+        neuron.pre_impact_potential_ = pre_impact_potential_[index];
+        neuron.bursting_phase_ = bursting_phase_[index];
+        neuron.total_blocking_period_ = total_blocking_period_[index];
+        neuron.dopamine_value_ = dopamine_value_[index];
+
+        const size_t static_index = get_static_index(index);
+        neuron.activation_threshold_ = activation_threshold_[static_index];
+        neuron.threshold_decay_ = threshold_decay_[static_index];
+        neuron.threshold_increment_ = threshold_increment_[static_index];
+        neuron.postsynaptic_trace_decay_ = postsynaptic_trace_decay_[static_index];
+        neuron.postsynaptic_trace_increment_ = postsynaptic_trace_increment_[static_index];
+        neuron.inhibitory_conductance_decay_ = inhibitory_conductance_decay_[static_index];
+        neuron.potential_decay_ = potential_decay_[static_index];
+        neuron.bursting_period_ = bursting_period_[static_index];
+        neuron.reflexive_weight_ = reflexive_weight_[static_index];
+        neuron.reversal_inhibitory_potential_ = reversal_inhibitory_potential_[static_index];
+        neuron.absolute_refractory_period_ = absolute_refractory_period_[static_index];
+        neuron.potential_reset_value_ = potential_reset_value_[static_index];
+        neuron.min_potential_ = min_potential_[static_index];
+        if (is_lazy_update_enabled_ && !is_neuron_active_[index])
+        {
+            advance_quiescent_neuron(neuron, lazy_step_ - update_step_[index]);
+        }
+        return neuron;
+    }
+
+    /**
+     * @brief Check if lazy update mode is enabled.
+     * @return `true` if only active neurons are calculated at every step.
+     */
+    [[nodiscard]] bool is_lazy_update_enabled() const { return is_lazy_update_enabled_; }
+
+    /**
+     * @brief Enable lazy update mode.
+     * @details All neurons are active at first, calculation routines deactivate quiescent neurons.
+     */
+    void enable_lazy_update()
+    {
+        is_lazy_update_enabled_ = true;
+        lazy_step_ = 0;
+        update_step_.assign(size(), 0);
+        is_neuron_active_.assign(size(), true);
+        active_neurons_.resize(size());
+        std::iota(active_neurons_.begin(), active_neurons_.end(), 0);
+    }
+
+    /**
+     * @brief Disable lazy update mode.
+     * @details States of inactive neurons are advanced to the last calculated step.
+     */
+    void disable_lazy_update()
+    {
+        if (!is_lazy_update_enabled_) return;
+        for (size_t index = 0; index < size(); ++index) activate_neuron(index);
+        is_lazy_update_enabled_ = false;
+        update_step_.clear();
+        is_neuron_active_.clear();
+        active_neurons_.clear();
+    }
+
+    /**
+     * @brief Activate a neuron in lazy update mode.
+     * @details State of an inactive neuron is advanced to the last calculated step.
+     * @param index neuron index.
+     */
+    void activate_neuron(size_t index)
+    {
+        if (is_neuron_active_[index]) return;
+        auto neuron = get_neuron(index);
+        n_time_steps_since_last_firing_[index] = neuron.n_time_steps_since_last_firing_;
+        dynamic_threshold_[index] = neuron.dynamic_threshold_;
+        postsynaptic_trace_[index] = neuron.postsynaptic_trace_;
+        potential_[index] = neuron.potential_;
+        pre_impact_potential_[index] = neuron.pre_impact_potential_;
+        total_blocking_period_[index] = neuron.total_blocking_period_;
+        is_neuron_active_[index] = true;
+        active_neurons_.push_back(index);
+    }
+
+    /**
+     * @brief Start a step in lazy update mode.
+     * @return indexes of active neurons sorted in ascending order.
+     */
+    const std::vector<size_t> &start_lazy_step()
+    {
+        ++lazy_step_;
+        std::sort(active_neurons_.begin(), active_neurons_.end());
+        return active_neurons_;
+    }
+
+    /**
+     * @brief Finish a step in lazy update mode and deactivate quiescent neurons.
+     */
+    void finish_lazy_step()
+    {
+        const auto new_end = std::remove_if(
+            active_neurons_.begin(), active_neurons_.end(),
+            [this](size_t index)
+            {
+                if (!is_neuron_quiescent(index)) return false;
+                is_neuron_active_[index] = false;
+                update_step_[index] = lazy_step_;
+                return true;
+            });
+        active_neurons_.erase(new_end, active_neurons_.end());
+    }
+
+    /**
+     * @brief Check if a neuron is quiescent, i.e. its state without impacts can be calculated analytically.
+     * @details The potential of a quiescent neuron doesn't exceed `max(potential, 0, min_potential)` and its threshold
+     * isn't below `activation_threshold + min(dynamic_threshold, 0)` while the neuron gets no impacts.
+     * @param index neuron index.
+     * @return `true` if the neuron is quiescent.
+     */
+    [[nodiscard]] bool is_neuron_quiescent(size_t index) const
+    {
+        const size_t static_index = get_static_index(index);
+        const Real potential_decay = potential_decay_[static_index];
+        const Real threshold_decay = threshold_decay_[static_index];
+        if (bursting_phase_[index] || inhibitory_conductance_[index] != 0) return false;
+        if (!(potential_decay >= 0 && potential_decay <= 1 && threshold_decay >= 0 && threshold_decay <= 1))
+        {
+            return false;
+        }
+        const Real max_potential = std::max({potential_[index], Real{0}, min_potential_[static_index]});
+        return max_potential < activation_threshold_[static_index] + std::min(dynamic_threshold_[index], Real{0});
+    }
+
+    /**
+     * @brief Advance a quiescent neuron by the given number of steps without impacts.
+     * @details Decays are applied analytically, so results can differ from step-by-step calculation by rounding errors.
+     * @param neuron quiescent neuron parameters.
+     * @param steps number of steps.
+     */
+    static void advance_quiescent_neuron(Parameters &neuron, uint64_t steps)
+    {
+        if (!steps) return;
+        const auto decay = [steps](Real factor)
+        { return static_cast<Real>(std::pow(factor, static_cast<Real>(steps))); };
+
+        neuron.n_time_steps_since_last_firing_ += steps;
+        neuron.dynamic_threshold_ *= decay(neuron.threshold_decay_);
+        neuron.postsynaptic_trace_ *= decay(neuron.postsynaptic_trace_decay_);
+        // Potential is clamped by its minimum at every step, clamping the potential of the step before the last one
+        // gives the same result.
+        const Real previous_potential = std::max(
+            neuron.potential_ * static_cast<Real>(std::pow(neuron.potential_decay_, static_cast<Real>(steps - 1))),
+            neuron.min_potential_);
+        neuron.pre_impact_potential_ = previous_potential * neuron.potential_decay_;
+        neuron.potential_ = std::max(neuron.pre_impact_potential_, neuron.min_potential_);
+
+        // Positive blocking period decreases to zero, negative one increases to zero and then is set to maximum.
+        auto &blocking_period = neuron.total_blocking_period_;
+        if (blocking_period > 0)
+        {
+            blocking_period = steps < static_cast<uint64_t>(blocking_period) ? blocking_period - steps : 0;
+        }
+        else if (blocking_period < 0)
+        {
+            const uint64_t steps_to_zero = static_cast<uint64_t>(-(blocking_period + 1)) + 1;
+            blocking_period = steps < steps_to_zero
+                                  ? blocking_period + static_cast<int64_t>(steps)
+                                  : std::numeric_limits<int64_t>::max() - static_cast<int64_t>(steps - steps_to_zero);
+        }
+    }
+
+    /**
+     * @brief Call a function for each static parameter column.
+     * @tparam Function type of a function that takes a column.
+     * @param function function to call.
+     */
+    template <class Function>
+    void for_each_static_column(Function function)
+    {
+        function(activation_threshold_);
+        function(threshold_decay_);
+        function(threshold_increment_);
+        function(postsynaptic_trace_decay_);
+        function(postsynaptic_trace_increment_);
+        function(inhibitory_conductance_decay_);
+        function(potential_decay_);
+        function(bursting_period_);
+        function(reflexive_weight_);
+        function(reversal_inhibitory_potential_);
+        function(absolute_refractory_period_);
+        function(potential_reset_value_);
+        function(min_potential_);
+    }
+
+    /**
+     * @brief Call a function for each column with the index of a neuron value in the column.
+     * @tparam Function type of a function that takes a column, a value index and a pointer to `Parameters` field.
+     * @param index neuron index.
+     * @param function function to call.
+     */
+    template <class Function>
+    void for_each_column_value(size_t index, Function function)
+    {
+        function(n_time_steps_since_last_firing_, index, &Parameters::n_time_steps_since_last_firing_);
+        function(dynamic_threshold_, index, &Parameters::dynamic_threshold_);
+        function(postsynaptic_trace_, index, &Parameters::postsynaptic_trace_);
+        function(inhibitory_conductance_, index, &Parameters::inhibitory_conductance_);
+        function(potential_, index, &Parameters::potential_);
+        function(pre_impact_potential_, index, &Parameters::pre_impact_potential_);
+        function(bursting_phase_, index, &Parameters::bursting_phase_);
+        function(total_blocking_period_, index, &Parameters::total_blocking_period_);
+        function(dopamine_value_, index, &Parameters::dopamine_value_);
+
+        const size_t static_index = get_static_index(index);
+        function(activation_threshold_, static_index, &Parameters::activation_threshold_);
+        function(threshold_decay_, static_index, &Parameters::threshold_decay_);
+        function(threshold_increment_, static_index, &Parameters::threshold_increment_);
+        function(postsynaptic_trace_decay_, static_index, &Parameters::postsynaptic_trace_decay_);
+        function(postsynaptic_trace_increment_, static_index, &Parameters::postsynaptic_trace_increment_);
+        function(inhibitory_conductance_decay_, static_index, &Parameters::inhibitory_conductance_decay_);
+        function(potential_decay_, static_index, &Parameters::potential_decay_);
+        function(bursting_period_, static_index, &Parameters::bursting_period_);
+        function(reflexive_weight_, static_index, &Parameters::reflexive_weight_);
+        function(reversal_inhibitory_potential_, static_index, &Parameters::reversal_inhibitory_potential_);
+        function(absolute_refractory_period_, static_index, &Parameters::absolute_refractory_period_);
+        function(potential_reset_value_, static_index, &Parameters::potential_reset_value_);
+        function(min_potential_, static_index, &Parameters::min_potential_);
+    }
+
+    /**
+     * @brief Columns of dynamic parameters with the same names as `Parameters` fields, one value per neuron.
+     */
+    std::vector<decltype(Parameters::n_time_steps_since_last_firing_)> n_time_steps_since_last_firing_;
+    std::vector<decltype(Parameters::dynamic_threshold_)> dynamic_threshold_;
+    std::vector<decltype(Parameters::postsynaptic_trace_)> postsynaptic_trace_;
+    std::vector<decltype(Parameters::inhibitory_conductance_)> inhibitory_conductance_;
+    std::vector<decltype(Parameters::potential_)> potential_;
+    std::vector<decltype(Parameters::pre_impact_potential_)> pre_impact_potential_;
+    std::vector<decltype(Parameters::bursting_phase_)> bursting_phase_;
+    std::vector<decltype(Parameters::total_blocking_period_)> total_blocking_period_;
+    std::vector<decltype(Parameters::dopamine_value_)> dopamine_value_;
+
+    /**
+     * @brief Columns of static parameters with the same names as `Parameters` fields.
+     * @details Columns contain a single value if static parameters are shared by all neurons.
+     */
+    std::vector<decltype(Parameters::activation_threshold_)> activation_threshold_;
+    std::vector<decltype(Parameters::threshold_decay_)> threshold_decay_;
+    std::vector<decltype(Parameters::threshold_increment_)> threshold_increment_;
+    std::vector<decltype(Parameters::postsynaptic_trace_decay_)> postsynaptic_trace_decay_;
+    std::vector<decltype(Parameters::postsynaptic_trace_increment_)> postsynaptic_trace_increment_;
+    std::vector<decltype(Parameters::inhibitory_conductance_decay_)> inhibitory_conductance_decay_;
+    std::vector<decltype(Parameters::potential_decay_)> potential_decay_;
+    std::vector<decltype(Parameters::bursting_period_)> bursting_period_;
+    std::vector<decltype(Parameters::reflexive_weight_)> reflexive_weight_;
+    std::vector<decltype(Parameters::reversal_inhibitory_potential_)> reversal_inhibitory_potential_;
+    std::vector<decltype(Parameters::absolute_refractory_period_)> absolute_refractory_period_;
+    std::vector<decltype(Parameters::potential_reset_value_)> potential_reset_value_;
+    std::vector<decltype(Parameters::min_potential_)> min_potential_;
+
+    /**
+     * @brief `true` if static parameters are shared by all neurons.
+     */
+    bool has_shared_static_parameters_ = false;
+
+    /**
+     * @brief `true` if lazy update mode is enabled.
+     */
+    bool is_lazy_update_enabled_ = false;
+
+    /**
+     * @brief Number of steps calculated in lazy update mode.
+     */
+    uint64_t lazy_step_ = 0;
+
+    /**
+     * @brief Steps at which inactive neurons were deactivated in lazy update mode.
+     */
+    std::vector<uint64_t> update_step_;
+
+    /**
+     * @brief Flags of active neurons in lazy update mode.
+     */
+    std::vector<bool> is_neuron_active_;
+
+    /**
+     * @brief Indexes of active neurons in lazy update mode.
+     */
+    std::vector<size_t> active_neurons_;
 };
 
 }  // namespace knp::neuron_traits
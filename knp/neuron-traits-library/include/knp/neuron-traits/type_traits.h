@@ -42,5 +42,74 @@ struct neuron_parameters;
 template <typename NeuronType>
 struct default_values;
 
+/**
+ * @brief Structure for neuron parameters stored as columns, one container per parameter.
+ * @details Specialize the structure for neuron types that can be calculated over a structure-of-arrays layout.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType>
+struct neuron_columns;
+
+/**
+ * @brief Check if neuron parameters of the given type can be stored as columns.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType, typename = void>
+struct has_neuron_columns : std::false_type
+{
+};
+
+/**
+ * @brief Check if neuron parameters of the given type can be stored as columns.
+ * @details Specialization for neuron types that have `neuron_columns` defined.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType>
+struct has_neuron_columns<NeuronType, std::void_t<decltype(sizeof(neuron_columns<NeuronType>))>> : std::true_type
+{
+};
+
+/**
+ * @brief `true` if neuron parameters of the given type can be stored as columns.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType>
+constexpr bool has_neuron_columns_v = has_neuron_columns<NeuronType>::value;
+
+/**
+ * @brief Type of a non-constant reference to parameters of a single neuron.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType, typename = void>
+struct neuron_reference
+{
+    /**
+     * @brief Reference type.
+     */
+    using type = neuron_parameters<NeuronType> &;
+};
+
+/**
+ * @brief Type of a non-constant reference to parameters of a single neuron.
+ * @details Specialization for neuron types that have `neuron_columns` defined. Parameters are referenced by a proxy
+ * object defined as `neuron_columns<NeuronType>::Reference`.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType>
+struct neuron_reference<NeuronType, std::enable_if_t<has_neuron_columns_v<NeuronType>>>
+{
+    /**
+     * @brief Reference type.
+     */
+    using type = typename neuron_columns<NeuronType>::Reference;
+};
+
+/**
+ * @brief Type of a non-constant reference to parameters of a single neuron.
+ * @tparam NeuronType type of neurons.
+ */
+template <typename NeuronType>
+using neuron_reference_t = typename neuron_reference<NeuronType>::type;
+
 
 }  // namespace knp::neuron_traits
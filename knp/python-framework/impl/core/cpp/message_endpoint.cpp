@@ -124,7 +124,11 @@ py::class_<core::MessageEndpoint, boost::noncopyable, std::shared_ptr<core::Mess
     .def(
         "remove_receiver", &core::MessageEndpoint::remove_receiver,
         "Remove all subscriptions for a receiver with given UID.")
-    .def("send_message", &core::MessageEndpoint::send_message, "Send a message to the message bus.")
+    .def(
+        "send_message",
+        static_cast<void (core::MessageEndpoint::*)(const core::messaging::MessageVariant &)>(
+            &core::MessageEndpoint::send_message),
+        "Send a message to the message bus.")
     .def(
         "receive_all_messages",
         make_handler([](core::MessageEndpoint &self) -> size_t { return self.receive_all_messages(); }),
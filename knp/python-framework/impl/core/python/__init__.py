@@ -27,6 +27,7 @@ from knp.core._knp_python_framework_core import (
     AdditiveSTDPDeltaSynapseProjection,
     Backend,
     BaseData,
+    BLIFATFloatNeuronPopulation,
     BLIFATNeuronPopulation,
     DeltaSynapseParameters,
     DeltaSynapseProjection,
@@ -47,6 +48,7 @@ from knp.core._knp_python_framework_core import (
 __all__ = [
     'UID',
     'BLIFATNeuronPopulation',
+    'BLIFATFloatNeuronPopulation',
     'DeltaSynapseProjection',
     'AdditiveSTDPDeltaSynapseParameters',
     'AdditiveSTDPDeltaSynapseProjection',
@@ -22,8 +22,9 @@ limitations under the License.
 
 # pylint: disable = no-name-in-module
 from knp.neuron_traits._knp_python_framework_neuron_traits import (
+    BLIFATFloatNeuronParameters,
     BLIFATNeuronParameters,
     SynapticResourceSTDPBLIFATNeuronParameters,
 )
 
-__all__ = ['BLIFATNeuronParameters', 'SynapticResourceSTDPBLIFATNeuronParameters']
+__all__ = ['BLIFATNeuronParameters', 'BLIFATFloatNeuronParameters', 'SynapticResourceSTDPBLIFATNeuronParameters']
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <cinttypes>
+#include <cstdint>
 #include <vector>
 
 #include "stdp_common.h"
@@ -33,6 +34,40 @@
 namespace knp::synapse_traits
 {
 
+/**
+ * @brief Implementation variants of the additive STDP rule.
+ */
+enum class STDPAdditiveMode
+{
+    /**
+     * @brief Synapses store histories of spike times, weights are changed when the histories are full.
+     */
+    spike_history,
+    /**
+     * @brief Projection stores exponentially decaying traces of neuron spikes, weights are changed on each spike.
+     * @details Synapse spike time histories are not used, so synapses don't allocate memory.
+     */
+    traces
+};
+
+
+/**
+ * @brief Exponentially decaying trace of neuron spikes.
+ */
+struct STDPTrace
+{
+    /**
+     * @brief Trace value at the `step_` step.
+     */
+    float value_ = 0;
+
+    /**
+     * @brief Index of the step on which the trace was updated last time.
+     */
+    uint64_t step_ = 0;
+};
+
+
 /**
  * @brief STDP additive rule parameters.
  * @note Parameters for the `W(x)` function by Zhang et al. 1998.
@@ -70,4 +105,53 @@ struct STDPAdditiveRule
     std::vector<uint32_t> postsynaptic_spike_times_;
 };
 
+
+/**
+ * @brief Shared parameters for the additive STDP.
+ * @details Parameters other than `mode_` are used only in the `STDPAdditiveMode::traces` mode. In this mode,
+ * a postsynaptic spike increases the weight of a synapse by `a_plus_ * x_pre`, and a presynaptic spike decreases it by
+ * `a_minus_ * x_post`, where `x_pre` and `x_post` are the traces of the synapse neurons. Each trace is increased by
+ * `1` on a neuron spike and decays with the `tau_plus_` or `tau_minus_` time constant. Spikes of a step are paired
+ * with traces of previous steps only. As in the `STDPAdditiveMode::spike_history` mode, weights are not bounded.
+ * @tparam SynapseType synapse type linked with additive STDP rule.
+ */
+template <typename SynapseType>
+struct shared_synapse_parameters<STDP<STDPAdditiveRule, SynapseType>>
+{
+    /**
+     * @brief Implementation variant of the rule.
+     */
+    STDPAdditiveMode mode_ = STDPAdditiveMode::spike_history;
+
+    /**
+     * @brief Time constant of presynaptic traces in steps.
+     */
+    float tau_plus_ = 10;
+
+    /**
+     * @brief Time constant of postsynaptic traces in steps.
+     */
+    float tau_minus_ = 10;
+
+    /**
+     * @brief Weight increase amplitude.
+     */
+    float a_plus_ = 1;
+
+    /**
+     * @brief Weight decrease amplitude.
+     */
+    float a_minus_ = 1;
+
+    /**
+     * @brief Traces of presynaptic neurons indexed by neuron indexes.
+     */
+    std::vector<STDPTrace> presynaptic_traces_;
+
+    /**
+     * @brief Traces of postsynaptic neurons indexed by neuron indexes.
+     */
+    std::vector<STDPTrace> postsynaptic_traces_;
+};
+
 }  // namespace knp::synapse_traits
@@ -19,17 +19,36 @@
  * limitations under the License.
  */
 
+#include <knp/backends/cpu-library/delta_synapse_projection.h>
+#include <knp/backends/cpu-library/impl/part_size_tuner.h>
+#include <knp/backends/cpu-library/impl/parts.h>
 #include <knp/backends/cpu-multi-threaded/backend.h>
+#include <knp/backends/thread_pool/persistent_worker_pool.h>
+#include <knp/backends/thread_pool/task_graph.h>
+#include <knp/backends/thread_pool/thread_affinity.h>
 #include <knp/backends/thread_pool/thread_pool_context.h>
 #include <knp/backends/thread_pool/thread_pool_executor.h>
+#include <knp/backends/thread_pool/work_stealing_thread_pool.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
 
 #include <generators.h>
 #include <spdlog/spdlog.h>
+#include <testing_backends.h>
 #include <tests_common.h>
 
+#include <algorithm>
+#include <array>
+#include <chrono>
 #include <functional>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
 
@@ -44,6 +63,16 @@ class MTestingBack : public knp::backends::multi_threaded_cpu::MultiThreadedCPUB
 {
 public:
     MTestingBack() = default;
+    MTestingBack(
+        size_t thread_count, size_t population_part_size, size_t projection_part_size,
+        knp::backends::multi_threaded_cpu::ExecutionMode execution_mode =
+            knp::backends::multi_threaded_cpu::ExecutionMode::work_stealing,
+        knp::backends::multi_threaded_cpu::AffinityPolicy affinity_policy =
+            knp::backends::multi_threaded_cpu::AffinityPolicy::none)
+        : knp::backends::multi_threaded_cpu::MultiThreadedCPUBackend(
+              thread_count, population_part_size, projection_part_size, execution_mode, affinity_policy)
+    {
+    }
     void _init() override { knp::backends::multi_threaded_cpu::MultiThreadedCPUBackend::_init(); }
 };
 
@@ -117,6 +146,426 @@ TEST(MultiThreadCpuSuite, SmallestNetwork)
 }
 
 
+// If `changed_weight` is set, weights of the loop projection are changed through the backend on step 15.
+template <class Backend>
+std::vector<std::vector<knp::core::messaging::SpikeIndex>> run_partitioned_network(
+    Backend &backend, std::optional<float> changed_weight = std::nullopt)
+{
+    // Create a network: input -> input_projection -> population <=> loop_projection.
+    namespace kt = knp::testing;
+    const size_t population_size = 50;
+
+    kt::BLIFATPopulation population{kt::neuron_generator, population_size};
+    Projection loop_projection = kt::DeltaProjection{
+        population.get_uid(), population.get_uid(),
+        [](size_t index)
+        {
+            const uint32_t id_from = index / 2;
+            const uint32_t id_to = (id_from + 1 + 6 * (index % 2)) % population_size;
+            return kt::DeltaProjection::Synapse{
+                {1.0, static_cast<uint32_t>(1 + index % 3), knp::synapse_traits::OutputType::EXCITATORY}, id_from,
+                id_to};
+        },
+        population_size * 2};
+    Projection input_projection = kt::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(),
+        [](size_t index) {
+            return kt::DeltaProjection::Synapse{{1.0, 1, knp::synapse_traits::OutputType::EXCITATORY}, index, index};
+        },
+        population_size};
+    knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+    knp::core::UID loop_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, loop_projection);
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    auto endpoint = backend.get_message_bus().create_endpoint();
+    knp::core::UID in_channel_uid;
+    knp::core::UID out_channel_uid;
+    backend.template subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.template subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<std::vector<knp::core::messaging::SpikeIndex>> results;
+    backend._init();
+    for (knp::core::Step step = 0; step < 30; ++step)
+    {
+        if (step % 10 == 0)
+        {
+            endpoint.send_message(knp::core::messaging::SpikeMessage{{in_channel_uid, step}, {0, 10, 11, 30, 49}});
+        }
+        if (changed_weight && 15 == step)
+        {
+            for (auto projection = backend.begin_projections(); projection != backend.end_projections(); ++projection)
+            {
+                std::visit(
+                    [&loop_uid, &changed_weight](auto &proj)
+                    {
+                        if (proj.get_uid() != loop_uid) return;
+                        for (auto &synapse : proj) std::get<knp::core::synapse_data>(synapse).weight_ = *changed_weight;
+                    },
+                    projection->arg_);
+            }
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        for (auto &message : endpoint.template unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid))
+        {
+            results.push_back(std::move(message.neuron_indexes_));
+        }
+    }
+    return results;
+}
+
+
+TEST(MultiThreadCpuSuite, PartitionedNetwork)
+{
+    // Results of small parts must match results of a single part regardless of thread scheduling. Small parts also
+    // make the backend apply impacts by neuron ranges.
+    knp::testing::MTestingBack whole_backend(1, 1000, 1000);
+    const auto expected_results = run_partitioned_network(whole_backend);
+    ASSERT_FALSE(expected_results.empty());
+
+    for (const auto execution_mode :
+         {knp::backends::multi_threaded_cpu::ExecutionMode::work_stealing,
+          knp::backends::multi_threaded_cpu::ExecutionMode::persistent_workers,
+          knp::backends::multi_threaded_cpu::ExecutionMode::task_graph})
+    {
+        knp::testing::MTestingBack parted_backend(4, 3, 2, execution_mode);
+        const auto results = run_partitioned_network(parted_backend);
+
+        ASSERT_EQ(results, expected_results);
+        for (const auto &spikes : results)
+        {
+            ASSERT_TRUE(std::is_sorted(spikes.begin(), spikes.end()));
+        }
+    }
+
+    // Weights changed through the backend between steps are used by the next steps.
+    knp::testing::STestingBack reference_backend;
+    knp::testing::MTestingBack changed_backend(4, 3, 2);
+    const auto changed_results = run_partitioned_network(changed_backend, 0.0F);
+    ASSERT_NE(changed_results, expected_results);
+    ASSERT_EQ(changed_results, run_partitioned_network(reference_backend, 0.0F));
+}
+
+
+// Results of a network with learning.
+struct LearningNetworkResults
+{
+    // Spikes of the population.
+    std::vector<std::vector<knp::core::messaging::SpikeIndex>> spikes_;
+    // Weights of all projections before the network run.
+    std::vector<float> initial_weights_;
+    // Weights of all projections after the network run.
+    std::vector<float> weights_;
+};
+
+
+template <class Backend>
+std::vector<float> get_projection_weights(Backend &backend)
+{
+    std::vector<float> weights;
+    for (auto projection = backend.begin_projections(); projection != backend.end_projections(); ++projection)
+    {
+        std::visit(
+            [&weights](const auto &proj)
+            {
+                for (const auto &synapse : proj) weights.push_back(std::get<knp::core::synapse_data>(synapse).weight_);
+            },
+            projection->arg_);
+    }
+    return weights;
+}
+
+
+// Run a network with learning: input -> input_projection -> population <=> loop_projections, dopamine input ->
+// dopamine_projection -> population.
+template <class Backend>
+LearningNetworkResults run_learning_network(Backend &backend)
+{
+    namespace kt = knp::testing;
+    using ResourceSTDPPopulation = knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+    using ResourceSTDPProjection = knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>;
+    using AdditiveSTDPProjection = knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse>;
+    const size_t population_size = 50;
+
+    ResourceSTDPPopulation population{
+        [](size_t index)
+        {
+            ResourceSTDPPopulation::NeuronParameters neuron{{}};
+            neuron.synaptic_resource_threshold_ = 1;
+            neuron.free_synaptic_resource_ = static_cast<float>(index % 3);
+            neuron.isi_max_ = 2;
+            neuron.stability_change_parameter_ = 0.1F;
+            neuron.resource_drain_coefficient_ = 1;
+            return neuron;
+        },
+        population_size};
+    auto input_projection = ResourceSTDPProjection{
+        knp::core::UID{false}, population.get_uid(),
+        [](size_t index)
+        {
+            return ResourceSTDPProjection::Synapse{
+                {{1.0, 1, knp::synapse_traits::OutputType::EXCITATORY}, {2, 0, 2, 0, 5}}, index, index};
+        },
+        population_size};
+    auto loop_projection = ResourceSTDPProjection{
+        population.get_uid(), population.get_uid(),
+        [](size_t index)
+        {
+            const uint32_t id_from = index / 2;
+            const uint32_t id_to = (id_from + 1 + 6 * (index % 2)) % population_size;
+            return ResourceSTDPProjection::Synapse{
+                {{0.5, static_cast<uint32_t>(1 + index % 3), knp::synapse_traits::OutputType::EXCITATORY},
+                 {1, 0, 2, 0, 5}},
+                id_from,
+                id_to};
+        },
+        population_size * 2};
+    auto additive_projection = AdditiveSTDPProjection{
+        population.get_uid(), population.get_uid(),
+        [](size_t index)
+        {
+            return AdditiveSTDPProjection::Synapse{
+                {{0.1F, 2, knp::synapse_traits::OutputType::EXCITATORY}, {1, 1}}, index, (index + 3) % population_size};
+        },
+        population_size};
+    additive_projection.get_shared_parameters().stdp_populations_[population.get_uid()] =
+        AdditiveSTDPProjection::SharedSynapseParameters::ProcessingType::STDPAndSpike;
+    auto dopamine_projection = kt::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(),
+        [](size_t index) {
+            return kt::DeltaProjection::Synapse{{0.5, 1, knp::synapse_traits::OutputType::DOPAMINE}, index, index};
+        },
+        population_size};
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection, additive_projection, dopamine_projection});
+
+    auto endpoint = backend.get_message_bus().create_endpoint();
+    knp::core::UID in_channel_uid;
+    knp::core::UID dopamine_channel_uid;
+    knp::core::UID out_channel_uid;
+    backend.template subscribe<knp::core::messaging::SpikeMessage>(input_projection.get_uid(), {in_channel_uid});
+    backend.template subscribe<knp::core::messaging::SpikeMessage>(
+        dopamine_projection.get_uid(), {dopamine_channel_uid});
+    endpoint.template subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    LearningNetworkResults results;
+    results.initial_weights_ = get_projection_weights(backend);
+    backend._init();
+    backend.start_learning();
+    for (knp::core::Step step = 0; step < 40; ++step)
+    {
+        if (step % 10 == 0)
+        {
+            endpoint.send_message(knp::core::messaging::SpikeMessage{{in_channel_uid, step}, {0, 10, 11, 30, 49}});
+        }
+        if (step % 10 == 3)
+        {
+            endpoint.send_message(knp::core::messaging::SpikeMessage{{dopamine_channel_uid, step}, {1, 11, 12, 31}});
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        for (auto &message : endpoint.template unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid))
+        {
+            results.spikes_.push_back(std::move(message.neuron_indexes_));
+        }
+    }
+    results.weights_ = get_projection_weights(backend);
+    return results;
+}
+
+
+// Results of the single-threaded backend used as a reference.
+const LearningNetworkResults &get_reference_learning_results()
+{
+    static const LearningNetworkResults results = []()
+    {
+        knp::testing::STestingBack reference_backend;
+        return run_learning_network(reference_backend);
+    }();
+    return results;
+}
+
+
+// Multi-threaded backend settings.
+struct BackendSettings
+{
+    size_t thread_count_;
+    size_t population_part_size_;
+    size_t projection_part_size_;
+    knp::backends::multi_threaded_cpu::ExecutionMode execution_mode_;
+    knp::backends::multi_threaded_cpu::AffinityPolicy affinity_policy_;
+};
+
+
+class LearningNetworkSuite : public ::testing::TestWithParam<BackendSettings>
+{
+};
+
+
+TEST_P(LearningNetworkSuite, MatchesSingleThreadedBackend)
+{
+    // Learning must give the same spikes and weights as the single-threaded backend regardless of part sizes,
+    // thread pool, execution mode and thread pinning.
+    const auto &settings = GetParam();
+    knp::testing::MTestingBack backend(
+        settings.thread_count_, settings.population_part_size_, settings.projection_part_size_,
+        settings.execution_mode_, settings.affinity_policy_);
+    const auto &expected = get_reference_learning_results();
+    const auto results = run_learning_network(backend);
+
+    ASSERT_FALSE(expected.spikes_.empty());
+    ASSERT_NE(expected.weights_, expected.initial_weights_);
+    ASSERT_EQ(results.initial_weights_, expected.initial_weights_);
+    ASSERT_EQ(results.spikes_, expected.spikes_);
+    ASSERT_EQ(results.weights_, expected.weights_);
+}
+
+
+INSTANTIATE_TEST_SUITE_P(
+    MultiThreadCpuSuite, LearningNetworkSuite,
+    ::testing::Values(
+        BackendSettings{
+            1, 1000, 1000, knp::backends::multi_threaded_cpu::ExecutionMode::work_stealing,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::none},
+        BackendSettings{
+            4, 3, 2, knp::backends::multi_threaded_cpu::ExecutionMode::work_stealing,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::none},
+        BackendSettings{
+            4, knp::backends::multi_threaded_cpu::auto_part_size, knp::backends::multi_threaded_cpu::auto_part_size,
+            knp::backends::multi_threaded_cpu::ExecutionMode::work_stealing,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::none},
+        BackendSettings{
+            4, 3, 2, knp::backends::multi_threaded_cpu::ExecutionMode::persistent_workers,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::none},
+        BackendSettings{
+            4, 3, 2, knp::backends::multi_threaded_cpu::ExecutionMode::persistent_workers,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::pinned},
+        BackendSettings{
+            4, knp::backends::multi_threaded_cpu::auto_part_size, knp::backends::multi_threaded_cpu::auto_part_size,
+            knp::backends::multi_threaded_cpu::ExecutionMode::persistent_workers,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::pinned},
+        BackendSettings{
+            4, 3, 2, knp::backends::multi_threaded_cpu::ExecutionMode::task_graph,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::none},
+        BackendSettings{
+            4, knp::backends::multi_threaded_cpu::auto_part_size, knp::backends::multi_threaded_cpu::auto_part_size,
+            knp::backends::multi_threaded_cpu::ExecutionMode::task_graph,
+            knp::backends::multi_threaded_cpu::AffinityPolicy::pinned}));
+
+
+TEST(MultiThreadCpuSuite, ProjectionSpikesPartTest)
+{
+    // Impacts calculated from spiking neurons only must match impacts of the full synapse scan.
+    using DeltaProjection = knp::core::Projection<knp::synapse_traits::DeltaSynapse>;
+    using knp::backends::cpu::DelayedImpacts;
+    using knp::core::messaging::SpikeMessage;
+
+    // Neurons 3 and 6 have no synapses. Synapses of a neuron are not adjacent, so CSR ranges are split across parts.
+    const std::array<uint32_t, 6> sources{0, 1, 2, 4, 5, 7};
+    const size_t synapse_count = 30;
+    auto generator = [&sources](size_t index) -> std::optional<DeltaProjection::Synapse>
+    {
+        using knp::synapse_traits::OutputType;
+        return DeltaProjection::Synapse{
+            {static_cast<float>(index) + 0.5F, static_cast<uint32_t>(index % 3),
+             index % 4 ? OutputType::EXCITATORY : OutputType::INHIBITORY_CURRENT},
+            sources[(index * 5) % sources.size()],
+            static_cast<uint32_t>(index % 4)};
+    };
+    const DeltaProjection projection{knp::core::UID{}, knp::core::UID{}, generator, synapse_count};
+    const uint64_t step_n = 10;
+
+    auto sort_impacts = [](DelayedImpacts &impacts)
+    {
+        std::sort(
+            impacts.begin(), impacts.end(), [](const auto &impact1, const auto &impact2)
+            { return std::tie(impact1.first, impact1.second.connection_index_) <
+                     std::tie(impact2.first, impact2.second.connection_index_); });
+    };
+
+    const std::vector<std::vector<std::vector<knp::core::messaging::SpikeIndex>>> spike_sets{
+        {}, {{}}, {{3, 6}}, {{0, 3, 5}, {0, 7}}, {{0, 1, 2, 3, 4, 5, 6, 7}}};
+    size_t total_impacts = 0;
+    for (const auto &spike_set : spike_sets)
+    {
+        knp::backends::cpu::SharedSpikeMessages messages;
+        for (const auto &neuron_indexes : spike_set)
+        {
+            messages.push_back(
+                std::make_shared<const SpikeMessage>(SpikeMessage{{knp::core::UID{}, step_n}, neuron_indexes}));
+        }
+        const auto spikes = knp::backends::cpu::count_spikes(messages);
+
+        // Full scan of all synapses.
+        const std::unordered_map<size_t, size_t> spike_counts(spikes.begin(), spikes.end());
+        DelayedImpacts expected_impacts;
+        for (size_t synapse_index = 0; synapse_index < projection.size(); ++synapse_index)
+        {
+            const auto &[params, id_from, id_to] = projection[synapse_index];
+            auto spike_count = spike_counts.find(id_from);
+            if (spike_count == spike_counts.end() || !params.delay_) continue;
+            expected_impacts.emplace_back(
+                params.delay_ + step_n - 1,
+                knp::core::messaging::SynapticImpact{
+                    synapse_index, params.weight_ * spike_count->second, params.output_type_,
+                    static_cast<uint32_t>(id_from), static_cast<uint32_t>(id_to)});
+        }
+        sort_impacts(expected_impacts);
+        total_impacts += expected_impacts.size();
+
+        // Spike-driven parts of different sizes.
+        for (size_t part_size = 1; part_size <= spikes.size() + 1; ++part_size)
+        {
+            DelayedImpacts impacts;
+            DelayedImpacts part_impacts;
+            for (size_t part_start = 0; part_start < std::max<size_t>(spikes.size(), 1); part_start += part_size)
+            {
+                knp::backends::cpu::calculate_projection_spikes_part(
+                    projection, spikes, part_impacts, step_n, part_start, part_size);
+                impacts.insert(impacts.end(), part_impacts.begin(), part_impacts.end());
+            }
+            sort_impacts(impacts);
+            ASSERT_EQ(impacts, expected_impacts);
+        }
+    }
+    ASSERT_GT(total_impacts, 0);
+}
+
+
+TEST(MultiThreadCpuSuite, PartSizeTunerTest)
+{
+    using knp::backends::cpu::PartSizeTuner;
+    using namespace std::chrono_literals;
+
+    PartSizeTuner fixed_tuner(100, 2, false);
+    ASSERT_FALSE(fixed_tuner.is_measuring());
+    ASSERT_EQ(fixed_tuner.get_part_size(), 100);
+
+    // Expensive elements: each of 2 threads gets 4 parts of 1000 elements.
+    PartSizeTuner balanced_tuner(100, 2, true);
+    // Cheap elements: a part takes the target time.
+    PartSizeTuner timed_tuner(100, 2, true);
+    for (uint64_t step = 0; step < PartSizeTuner::measured_step_count; ++step)
+    {
+        ASSERT_TRUE(balanced_tuner.is_measuring());
+        // Steps without elements are not counted.
+        ASSERT_FALSE(balanced_tuner.finish_step());
+        balanced_tuner.add_measurement(1ms, 400);
+        balanced_tuner.add_measurement(9ms, 7600);
+        timed_tuner.add_measurement(80us, 8000);
+        ASSERT_EQ(balanced_tuner.finish_step(), step + 1 == PartSizeTuner::measured_step_count);
+        timed_tuner.finish_step();
+    }
+
+    ASSERT_FALSE(balanced_tuner.is_measuring());
+    ASSERT_EQ(balanced_tuner.get_part_size(), 1000);
+    ASSERT_EQ(timed_tuner.get_part_size(), 5000);
+}
+
+
 TEST(MultiThreadCpuSuite, NeuronsGettingTest)
 {
     const knp::testing::MTestingBack backend;
@@ -184,3 +633,204 @@ TEST(MultiThreadCpuSuite, ThreadPoolTest)
     ASSERT_EQ(result[1], 445);
     ASSERT_EQ(result[0], result[7]);  // Delayed tasks should give the same results as the first ones.
 }
+
+
+TEST(MultiThreadCpuSuite, WorkStealingThreadPoolTest)
+{
+    for (const size_t num_threads : {0, 1, 4})
+    {
+        knp::backends::cpu_executors::WorkStealingThreadPool pool(num_threads);
+        const int num_iterations = 10;
+        std::vector<uint64_t> result(1000, 0);
+        for (size_t i = 0; i < result.size(); ++i) pool.post(fibonacci, i % 10, num_iterations, &result[i]);
+        pool.join();
+        for (size_t i = 0; i < result.size(); ++i) ASSERT_EQ(result[i], (i % 10) * 89 % 1000);
+
+        if (0 == num_threads)
+        {
+            // Without workers tasks are executed in the posting order, also after the queue wraps around and grows.
+            std::vector<size_t> order;
+            std::vector<size_t> expected_order;
+            for (size_t i = 0; i < 100; ++i) pool.post([&order, i] { order.push_back(i); });
+            pool.join();
+            for (size_t i = 0; i < result.size(); ++i) pool.post([&order, i] { order.push_back(i); });
+            pool.join();
+            for (size_t i = 0; i < 100; ++i) expected_order.push_back(i);
+            for (size_t i = 0; i < result.size(); ++i) expected_order.push_back(i);
+            ASSERT_EQ(order, expected_order);
+        }
+
+        // Tasks posted by tasks are finished before join returns.
+        std::vector<uint64_t> nested_result(result.size(), 0);
+        for (size_t i = 0; i < result.size(); ++i)
+            pool.post(
+                [&pool, &nested_result, i]
+                { pool.post(fibonacci, i % 10, num_iterations, &nested_result[i]); });
+        pool.join();
+        ASSERT_EQ(nested_result, result);
+
+        // Functions that do not fit into a task are stored on heap.
+        std::array<uint64_t, 32> large_value{};
+        large_value.back() = 7;
+        uint64_t large_result = 0;
+        static_assert(!knp::backends::cpu_executors::InlineTask::is_stored_inline<decltype(large_value)>);
+        pool.post([large_value, &large_result] { large_result = large_value.back(); });
+
+        // The pool is reusable after a task throws an exception.
+        pool.post([] { throw std::runtime_error("Task error."); });
+        ASSERT_THROW(pool.join(), std::runtime_error);
+        ASSERT_EQ(large_result, 7);
+        pool.post(fibonacci, 2, num_iterations, &large_result);
+        pool.join();
+        ASSERT_EQ(large_result, 178);
+    }
+}
+
+
+TEST(MultiThreadCpuSuite, ConcatenatePartsTest)
+{
+    // Parts are filled concurrently, but the merged result depends only on the part order.
+    const size_t element_count = 1000;
+    const size_t part_size = 7;
+    const size_t part_count = (element_count + part_size - 1) / part_size;
+    std::vector<size_t> expected_result{element_count};
+    for (size_t i = 0; i < element_count; ++i)
+    {
+        if (i % 3 == 0 || i % 5 == 0) expected_result.push_back(i);
+    }
+
+    for (const size_t num_threads : {1, 2, 4})
+    {
+        knp::backends::cpu_executors::WorkStealingThreadPool pool(num_threads);
+        std::vector<std::vector<size_t>> parts(part_count);
+        for (size_t part_index = 0; part_index < part_count; ++part_index)
+        {
+            pool.post(
+                [&parts, part_index, part_size, element_count]
+                {
+                    for (size_t i = part_index * part_size; i < std::min((part_index + 1) * part_size, element_count);
+                         ++i)
+                    {
+                        if (i % 3 == 0 || i % 5 == 0) parts[part_index].push_back(i);
+                    }
+                });
+        }
+        pool.join();
+
+        // Values that are already in the result are kept.
+        std::vector<size_t> result{element_count};
+        knp::backends::cpu::concatenate_parts(parts.begin(), parts.end(), result);
+        ASSERT_TRUE(std::is_sorted(result.begin() + 1, result.end()));
+        ASSERT_EQ(result, expected_result);
+    }
+}
+
+
+TEST(MultiThreadCpuSuite, WorkerProcessorNumberTest)
+{
+    namespace ce = knp::backends::cpu_executors;
+    // Processor 0 is left for the thread that waits for workers, workers wrap around other processors.
+    const std::vector<size_t> expected_processors = {1, 2, 3, 1, 2, 3, 1};
+    for (size_t worker_index = 0; worker_index < expected_processors.size(); ++worker_index)
+    {
+        ASSERT_EQ(ce::get_worker_processor_number(worker_index, 4), expected_processors[worker_index]);
+    }
+    ASSERT_EQ(ce::get_worker_processor_number(0, 2), 1);
+    ASSERT_EQ(ce::get_worker_processor_number(5, 2), 1);
+    // The only processor is shared.
+    ASSERT_EQ(ce::get_worker_processor_number(0, 1), 0);
+    ASSERT_EQ(ce::get_worker_processor_number(3, 1), 0);
+}
+
+
+TEST(MultiThreadCpuSuite, PersistentWorkerPoolTest)
+{
+    for (const size_t num_threads : {0, 1, 3})
+    {
+        knp::backends::cpu_executors::PersistentWorkerPool pool(num_threads);
+        std::vector<std::thread::id> first_owners(10);
+        std::vector<std::thread::id> owners(first_owners.size());
+        auto save_owner = [](std::thread::id *owner) { *owner = std::this_thread::get_id(); };
+
+        // Each task index is executed by the same thread in every phase.
+        for (auto &owner : first_owners) pool.post(save_owner, &owner);
+        pool.join();
+        for (size_t phase = 0; phase < 100; ++phase)
+        {
+            for (auto &owner : owners) pool.post(save_owner, &owner);
+            pool.join();
+            ASSERT_EQ(owners, first_owners);
+        }
+        ASSERT_EQ(first_owners[0], std::this_thread::get_id());
+
+        pool.post([] { throw std::runtime_error("Task error."); });
+        ASSERT_THROW(pool.join(), std::runtime_error);
+        uint64_t result = 0;
+        pool.post(fibonacci, 2, 10, &result);
+        pool.join();
+        ASSERT_EQ(result, 178);
+    }
+}
+
+
+TEST(MultiThreadCpuSuite, TaskGraphTest)
+{
+    using knp::backends::cpu_executors::TaskGraph;
+
+    for (const bool by_levels : {true, false})
+    {
+        knp::backends::cpu_executors::WorkStealingThreadPool pool(3);
+        TaskGraph graph;
+        std::mutex mutex;
+        std::vector<size_t> finished_nodes;
+        std::vector<uint64_t> results(4, 0);
+        // Diamond graph: 0 -> {1, 2} -> 3. Each task of a node adds the results of the nodes it depends on.
+        const std::vector<std::vector<size_t>> dependencies{{}, {0}, {0}, {1, 2}};
+        for (size_t node_index = 0; node_index < dependencies.size(); ++node_index)
+        {
+            const size_t added_index = graph.add_node(
+                [&, node_index](TaskGraph::NodeTasks &tasks)
+                {
+                    for (size_t task_index = 0; task_index < 10; ++task_index)
+                    {
+                        tasks.post(
+                            [&, node_index]
+                            {
+                                std::lock_guard lock(mutex);
+                                results[node_index] += 1;
+                                for (const auto dependency : dependencies[node_index])
+                                {
+                                    results[node_index] += results[dependency];
+                                }
+                            });
+                    }
+                },
+                [&, node_index]
+                {
+                    std::lock_guard lock(mutex);
+                    finished_nodes.push_back(node_index);
+                });
+            ASSERT_EQ(added_index, node_index);
+            for (const auto dependency : dependencies[node_index]) graph.add_dependency(node_index, dependency);
+        }
+        ASSERT_THROW(graph.add_dependency(4, 0), std::out_of_range);
+
+        // The graph is reusable.
+        for (size_t run = 0; run < 2; ++run)
+        {
+            finished_nodes.clear();
+            std::fill(results.begin(), results.end(), 0);
+            graph.run(pool, by_levels);
+            ASSERT_EQ(finished_nodes.size(), 4);
+            ASSERT_EQ(finished_nodes.front(), 0);
+            ASSERT_EQ(finished_nodes.back(), 3);
+            ASSERT_EQ(results, std::vector<uint64_t>({10, 110, 110, 2210}));
+        }
+
+        // Nodes of a cycle can't be started.
+        graph.add_dependency(0, 3);
+        ASSERT_THROW(graph.run(pool, by_levels), std::logic_error);
+        graph.clear();
+        ASSERT_EQ(graph.size(), 0);
+    }
+}
@@ -19,6 +19,8 @@
  * limitations under the License.
  */
 
+#include <knp/backends/cpu-library/blifat_population.h>
+#include <knp/backends/cpu-library/impl/additive_stdp_impl.h>
 #include <knp/backends/cpu-single-threaded/backend.h>
 #include <knp/core/population.h>
 #include <knp/core/projection.h>
@@ -28,8 +30,15 @@
 
 #include <generators.h>
 #include <spdlog/spdlog.h>
+#include <testing_backends.h>
 #include <tests_common.h>
 
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 
@@ -37,17 +46,54 @@ using Population = knp::backends::single_threaded_cpu::SingleThreadedCPUBackend:
 using Projection = knp::backends::single_threaded_cpu::SingleThreadedCPUBackend::ProjectionVariants;
 
 
-namespace knp::testing
+// Run a single-neuron neural network: input -> input_projection -> population <=> loop_projection.
+template <class Neuron>
+std::vector<knp::core::Step> run_smallest_network(bool lazy_neuron_update = false)
 {
+    knp::testing::STestingBack backend;
+    backend.set_lazy_neuron_update(lazy_neuron_update);
 
-class STestingBack : public knp::backends::single_threaded_cpu::SingleThreadedCPUBackend
-{
-public:
-    STestingBack() = default;
-    void _init() override { knp::backends::single_threaded_cpu::SingleThreadedCPUBackend::_init(); }
-};
+    knp::core::Population<Neuron> population{
+        [](size_t) { return knp::neuron_traits::neuron_parameters<Neuron>{}; }, 1};
+    Projection loop_projection =
+        knp::testing::DeltaProjection{population.get_uid(), population.get_uid(), knp::testing::synapse_generator, 1};
+    Projection input_projection = knp::testing::DeltaProjection{
+        knp::core::UID{false}, population.get_uid(), knp::testing::input_projection_gen, 1};
+    knp::core::UID const input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
 
-}  // namespace knp::testing
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    backend._init();
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    const knp::core::UID in_channel_uid, out_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<knp::core::Step> results;
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        if (step % 5 == 0)
+        {
+            knp::core::messaging::SpikeMessage message{{in_channel_uid, step}, {0}};
+            endpoint.send_message(message);
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        // Write the steps on which the network sends a spike.
+        if (!endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid).empty())
+        {
+            results.push_back(step);
+        }
+    }
+
+    return results;
+}
 
 
 TEST(SingleThreadCpuSuite, SmallestNetwork)
@@ -99,6 +145,24 @@ TEST(SingleThreadCpuSuite, SmallestNetwork)
 }
 
 
+TEST(SingleThreadCpuSuite, SmallestFloatNetwork)
+{
+    // Single-precision neurons must spike on the same steps as double-precision ones.
+    ASSERT_EQ(
+        run_smallest_network<knp::neuron_traits::BLIFATFloatNeuron>(),
+        run_smallest_network<knp::neuron_traits::BLIFATNeuron>());
+}
+
+
+TEST(SingleThreadCpuSuite, SmallestLazyNetwork)
+{
+    // Lazy update mode must not change spiking steps.
+    ASSERT_EQ(
+        run_smallest_network<knp::neuron_traits::BLIFATNeuron>(true),
+        run_smallest_network<knp::neuron_traits::BLIFATNeuron>());
+}
+
+
 TEST(SingleThreadCpuSuite, AdditiveSTDPNetwork)
 {
     using STDPDeltaProjection = knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse>;
@@ -188,6 +252,188 @@ TEST(SingleThreadCpuSuite, AdditiveSTDPNetwork)
 }
 
 
+using AdditiveSTDPDeltaProjection = knp::core::Projection<knp::synapse_traits::AdditiveSTDPDeltaSynapse>;
+
+
+// Run a single-neuron network: input -> input_projection -> population <=> loop_projection. The loop projection is
+// trained by the additive STDP rule with parameters set by `configure`. Return spike steps of the population and the
+// loop projection after the run.
+template <class ConfigureFunction>
+std::pair<std::vector<knp::core::Step>, AdditiveSTDPDeltaProjection> run_additive_stdp_network(
+    ConfigureFunction configure)
+{
+    // Create an STDP input projection.
+    auto stdp_input_projection_gen = [](size_t /*index*/) -> std::optional<AdditiveSTDPDeltaProjection::Synapse> {
+        return AdditiveSTDPDeltaProjection::Synapse{
+            {{1.0, 1, knp::synapse_traits::OutputType::EXCITATORY}, {2, 2}}, 0, 0};
+    };
+
+    // Create an STDP loop projection.
+    auto stdp_synapse_generator = [](size_t /*index*/) -> std::optional<AdditiveSTDPDeltaProjection::Synapse> {
+        return AdditiveSTDPDeltaProjection::Synapse{
+            {{1.0, 6, knp::synapse_traits::OutputType::EXCITATORY}, {1, 1}}, 0, 0};
+    };
+
+    auto stdp_neurons_generator = [](size_t /*index*/)  // NOLINT
+        -> knp::neuron_traits::neuron_parameters<knp::neuron_traits::BLIFATNeuron>
+    { return knp::neuron_traits::neuron_parameters<knp::neuron_traits::BLIFATNeuron>{}; };
+
+    knp::testing::STestingBack backend;
+
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population{knp::core::UID(), stdp_neurons_generator, 1};
+
+    auto loop_projection =
+        AdditiveSTDPDeltaProjection{population.get_uid(), population.get_uid(), stdp_synapse_generator, 1};
+    Projection input_projection =
+        AdditiveSTDPDeltaProjection{knp::core::UID{false}, population.get_uid(), stdp_input_projection_gen, 1};
+    knp::core::UID input_uid = std::visit([](const auto &proj) { return proj.get_uid(); }, input_projection);
+
+    loop_projection.get_shared_parameters().stdp_populations_[population.get_uid()] =
+        AdditiveSTDPDeltaProjection::SharedSynapseParameters::ProcessingType::STDPAndSpike;
+    configure(loop_projection);
+
+    backend.load_populations({population});
+    backend.load_projections({input_projection, loop_projection});
+
+    backend._init();
+    auto endpoint = backend.get_message_bus().create_endpoint();
+
+    knp::core::UID in_channel_uid, out_channel_uid;
+
+    // Create input and output.
+    backend.subscribe<knp::core::messaging::SpikeMessage>(input_uid, {in_channel_uid});
+    endpoint.subscribe<knp::core::messaging::SpikeMessage>(out_channel_uid, {population.get_uid()});
+
+    std::vector<knp::core::Step> results;
+
+    for (knp::core::Step step = 0; step < 20; ++step)
+    {
+        // Send inputs on steps 0, 5, 10, 15.
+        if (step % 5 == 0)
+        {
+            knp::core::messaging::SpikeMessage message{{in_channel_uid, 0}, {0}};
+            endpoint.send_message(message);
+        }
+        backend._step();
+        endpoint.receive_all_messages();
+        auto output = endpoint.unload_messages<knp::core::messaging::SpikeMessage>(out_channel_uid);
+        // Write the steps on which the network sends a spike.
+        if (!output.empty()) results.push_back(step);
+    }
+
+    for (auto proj = backend.begin_projections(); proj != backend.end_projections(); ++proj)
+    {
+        const auto &prj = std::get<AdditiveSTDPDeltaProjection>(proj->arg_);
+        if (prj.get_uid() == loop_projection.get_uid()) return {results, prj};
+    }
+    throw std::logic_error("Loop projection was not found.");
+}
+
+
+TEST(SingleThreadCpuSuite, AdditiveSTDPTraceNetwork)
+{
+    const float a_plus = 1.0F;
+    const float a_minus = 0.5F;
+    const auto [results, loop_projection] = run_additive_stdp_network(
+        [a_plus, a_minus](AdditiveSTDPDeltaProjection &projection)
+        {
+            auto &stdp_params = projection.get_shared_parameters().synapses_parameters_;
+            stdp_params.mode_ = knp::synapse_traits::STDPAdditiveMode::traces;
+            stdp_params.a_plus_ = a_plus;
+            stdp_params.a_minus_ = a_minus;
+        });
+
+    // Spikes on steps "5n + 1" (input) and on "previous_spike_n + 6" (positive feedback loop).
+    const std::vector<knp::core::Step> expected_results = {1, 6, 7, 11, 12, 13, 16, 17, 18, 19};
+    ASSERT_EQ(results, expected_results);
+
+    // Spikes of the loop projection are both presynaptic and postsynaptic, so both traces are equal, and each spike
+    // changes the weight by `(a_plus - a_minus) * trace`.
+    const auto &params = loop_projection.get_shared_parameters().synapses_parameters_;
+    float trace = 0;
+    float expected_weight = 1.0F;
+    for (size_t spike_index = 0; spike_index < results.size(); ++spike_index)
+    {
+        if (spike_index > 0)
+        {
+            trace *= std::exp(-static_cast<float>(results[spike_index] - results[spike_index - 1]) / params.tau_plus_);
+        }
+        expected_weight += (a_plus - a_minus) * trace;
+        trace += 1;
+    }
+    const float weight = std::get<knp::core::synapse_data>(loop_projection[0]).weight_;
+    ASSERT_GT(weight, 1.0F);
+    ASSERT_NEAR(weight, expected_weight, 1e-4);
+
+    // Synapses don't store spike histories in the trace mode.
+    for (const auto &synapse : loop_projection)
+    {
+        ASSERT_TRUE(std::get<knp::core::synapse_data>(synapse).rule_.presynaptic_spike_times_.empty());
+        ASSERT_TRUE(std::get<knp::core::synapse_data>(synapse).rule_.postsynaptic_spike_times_.empty());
+    }
+}
+
+
+TEST(SingleThreadCpuSuite, AdditiveSTDPTraceTest)
+{
+    std::vector<knp::synapse_traits::STDPTrace> traces{{2.0F, 10}};
+    ASSERT_FLOAT_EQ(knp::backends::cpu::get_trace_value(traces, 0, 20, 10), 2.0F * std::exp(-1.0F));
+    // A trace updated on a later step is not decayed.
+    ASSERT_FLOAT_EQ(knp::backends::cpu::get_trace_value(traces, 0, 5, 10), 2.0F);
+    ASSERT_FLOAT_EQ(knp::backends::cpu::get_trace_value({}, 0, 20, 10), 0.0F);
+
+    // A spike of an earlier step increases the trace without moving its step back.
+    knp::backends::cpu::add_spikes_to_traces(traces, {0, 2}, 5, 10);
+    ASSERT_EQ(traces.size(), 3);
+    ASSERT_FLOAT_EQ(traces[0].value_, 3.0F);
+    ASSERT_EQ(traces[0].step_, 10);
+    ASSERT_FLOAT_EQ(traces[2].value_, 1.0F);
+    ASSERT_EQ(traces[2].step_, 5);
+}
+
+
+TEST(SingleThreadCpuSuite, AdditiveSTDPTraceOrderTest)
+{
+    using knp::core::messaging::SpikeMessage;
+    using ProcessingType = AdditiveSTDPDeltaProjection::SharedSynapseParameters::ProcessingType;
+    const knp::core::UID pre_uid, post_uid;
+    const float tau = 10.0F;
+    const float a_minus = 0.5F;
+
+    auto synapse_generator = [](size_t /*index*/) -> std::optional<AdditiveSTDPDeltaProjection::Synapse> {
+        return AdditiveSTDPDeltaProjection::Synapse{
+            {{1.0, 1, knp::synapse_traits::OutputType::EXCITATORY}, {}}, 0, 0};
+    };
+
+    // Process presynaptic and postsynaptic spikes of the given steps in the given order, return the synapse weight.
+    auto run = [&](const std::vector<std::pair<bool, uint64_t>> &spike_order)
+    {
+        AdditiveSTDPDeltaProjection projection{pre_uid, post_uid, synapse_generator, 1};
+        auto &params = projection.get_shared_parameters();
+        params.stdp_populations_[post_uid] = ProcessingType::STDPOnly;
+        params.synapses_parameters_.mode_ = knp::synapse_traits::STDPAdditiveMode::traces;
+        params.synapses_parameters_.tau_plus_ = tau;
+        params.synapses_parameters_.tau_minus_ = tau;
+        params.synapses_parameters_.a_minus_ = a_minus;
+
+        knp::backends::cpu::SharedSpikeMessages messages;
+        for (const auto &[is_postsynaptic, step] : spike_order)
+        {
+            messages.push_back(std::make_shared<const SpikeMessage>(
+                SpikeMessage{{is_postsynaptic ? post_uid : pre_uid, step}, {0}}));
+        }
+        knp::backends::cpu::register_additive_stdp_traces(projection, messages);
+        return std::get<knp::core::synapse_data>(projection[0]).weight_;
+    };
+
+    // Simultaneous spikes are not paired, spikes of step 3 are paired with both spikes of step 1.
+    const float expected_weight = 1.0F + (1.0F - a_minus) * std::exp(-2.0F / tau);
+    ASSERT_NEAR(run({{false, 1}, {true, 1}, {false, 3}, {true, 3}}), expected_weight, 1e-6);
+    ASSERT_FLOAT_EQ(
+        run({{true, 3}, {true, 1}, {false, 3}, {false, 1}}), run({{false, 1}, {true, 1}, {false, 3}, {true, 3}}));
+}
+
+
 TEST(SingleThreadCpuSuite, ResourceSTDPNetwork)
 {
     using STDPDeltaProjection = knp::core::Projection<knp::synapse_traits::SynapticResourceSTDPDeltaSynapse>;
@@ -283,6 +529,233 @@ TEST(SingleThreadCpuSuite, ResourceSTDPNetwork)
 }
 
 
+TEST(SingleThreadCpuSuite, ResourceSTDPSynapsesTest)
+{
+    // Synapses of trained projections are regrouped when a projection is added, removed, locked or changed.
+    using SynapseType = knp::synapse_traits::SynapticResourceSTDPDeltaSynapse;
+    using STDPDeltaProjection = knp::core::Projection<SynapseType>;
+    struct ProjectionEntry
+    {
+        knp::core::AllProjectionsVariant arg_;
+    };
+
+    const size_t population_size = 3;
+    const knp::core::UID population_uid;
+    // Synapse `i` of a projection leads to neuron `i`.
+    auto make_projection = [](const knp::core::UID &post_uid, size_t synapse_count)
+    {
+        STDPDeltaProjection projection{
+            knp::core::UID{}, post_uid,
+            [](size_t index) -> std::optional<STDPDeltaProjection::Synapse> {
+                return STDPDeltaProjection::Synapse{{}, 0, index};
+            },
+            synapse_count};
+        projection.unlock_weights();
+        return projection;
+    };
+
+    knp::backends::cpu::ResourceSTDPState<SynapseType> state;
+    auto count_synapses = [&state]()
+    {
+        std::vector<size_t> result;
+        for (size_t index = 0; index < population_size; ++index) result.push_back(state.synapses_.find(index).size());
+        return result;
+    };
+    std::vector<ProjectionEntry> projections{
+        {make_projection(population_uid, 1)}, {make_projection(knp::core::UID{}, 3)},
+        {make_projection(population_uid, 3)}};
+    auto update_state = [&projections, &state, &population_uid]()
+    {
+        auto incoming_projections =
+            knp::backends::cpu::group_projections_by_postsynaptic<SynapseType>(projections);
+        state.update_synapses(incoming_projections[population_uid], population_size);
+        return incoming_projections[population_uid].size();
+    };
+
+    ASSERT_EQ(update_state(), 2);
+    ASSERT_EQ(count_synapses(), std::vector<size_t>({2, 1, 1}));
+
+    // A projection is added.
+    projections.push_back({make_projection(population_uid, 2)});
+    ASSERT_EQ(update_state(), 3);
+    ASSERT_EQ(count_synapses(), std::vector<size_t>({3, 2, 1}));
+
+    // A projection is removed.
+    projections.erase(projections.begin());
+    ASSERT_EQ(update_state(), 2);
+    ASSERT_EQ(count_synapses(), std::vector<size_t>({2, 2, 1}));
+
+    // A locked projection is not trained.
+    auto &last_projection = std::get<STDPDeltaProjection>(projections.back().arg_);
+    last_projection.lock_weights();
+    ASSERT_EQ(update_state(), 2);
+    ASSERT_EQ(count_synapses(), std::vector<size_t>({1, 1, 1}));
+    last_projection.unlock_weights();
+
+    // Synapses are added to a projection.
+    last_projection.add_synapses(
+        [](size_t) -> std::optional<STDPDeltaProjection::Synapse> {
+            return STDPDeltaProjection::Synapse{{}, 1, 2};
+        },
+        1);
+    ASSERT_EQ(update_state(), 2);
+    ASSERT_EQ(count_synapses(), std::vector<size_t>({2, 2, 2}));
+}
+
+
+TEST(SingleThreadCpuSuite, ResourceSTDPActiveNeuronsTest)
+{
+    // Neurons stay in the active set while they are in ISI period and leave it after they go quiet.
+    using SynapseType = knp::synapse_traits::SynapticResourceSTDPDeltaSynapse;
+    using STDPDeltaProjection = knp::core::Projection<SynapseType>;
+    using BlifatStdpPopulation = knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+
+    const size_t population_size = 4;
+    BlifatStdpPopulation population{
+        [](size_t) -> std::optional<BlifatStdpPopulation::NeuronParameters>
+        {
+            BlifatStdpPopulation::NeuronParameters neuron{{}};
+            neuron.synaptic_resource_threshold_ = 1;
+            neuron.free_synaptic_resource_ = 0;
+            neuron.isi_max_ = 3;
+            return neuron;
+        },
+        population_size};
+    STDPDeltaProjection projection{
+        knp::core::UID{}, population.get_uid(),
+        [](size_t index) -> std::optional<STDPDeltaProjection::Synapse>
+        {
+            STDPDeltaProjection::Synapse synapse{{}, 0, index};
+            std::get<knp::core::synapse_data>(synapse).rule_.dopamine_plasticity_period_ = 10;
+            return synapse;
+        },
+        population_size};
+    projection.unlock_weights();
+    std::vector<STDPDeltaProjection *> projections{&projection};
+
+    knp::backends::cpu::ResourceSTDPState<SynapseType> state;
+    state.prepare(population_size);
+    state.update_synapses(projections, population_size);
+    auto get_active_neurons = [&state]()
+    {
+        auto result = state.resource_neurons_.get_indexes();
+        std::sort(result.begin(), result.end());
+        return result;
+    };
+
+    // All neurons are checked at first, they are kept until their ISI period ends.
+    knp::backends::cpu::do_STDP_resource_plasticity(population, state, std::nullopt, 1);
+    ASSERT_EQ(get_active_neurons(), std::vector<size_t>({0, 1, 2, 3}));
+    knp::backends::cpu::do_STDP_resource_plasticity(population, state, std::nullopt, 4);
+    ASSERT_TRUE(get_active_neurons().empty());
+
+    // A neuron that spiked receives dopamine, so its free resource exceeds the threshold.
+    population[2].last_step_ = 5;
+    population[2].dopamine_value_ = 2;
+    state.dopamine_neurons_.insert(2);
+    knp::backends::cpu::do_STDP_resource_plasticity(population, state, std::nullopt, 5);
+    ASSERT_TRUE(state.dopamine_neurons_.get_indexes().empty());
+    ASSERT_EQ(get_active_neurons(), std::vector<size_t>({2}));
+    ASSERT_FLOAT_EQ(population[2].free_synaptic_resource_, -2.0F);
+    ASSERT_FLOAT_EQ(std::get<knp::core::synapse_data>(projection[2]).rule_.synaptic_resource_, 2.0F);
+
+    // The resource is renormalized after the neuron goes quiet.
+    population[2].dopamine_value_ = 0;
+    knp::backends::cpu::do_STDP_resource_plasticity(population, state, std::nullopt, 8);
+    ASSERT_EQ(get_active_neurons(), std::vector<size_t>({2}));
+    knp::backends::cpu::do_STDP_resource_plasticity(population, state, std::nullopt, 9);
+    ASSERT_TRUE(get_active_neurons().empty());
+    ASSERT_FLOAT_EQ(population[2].free_synaptic_resource_, 0.0F);
+    ASSERT_FLOAT_EQ(std::get<knp::core::synapse_data>(projection[2]).rule_.synaptic_resource_, 0.0F);
+}
+
+
+TEST(SingleThreadCpuSuite, ResourceSTDPStateTest)
+{
+    // Learning with a state kept between steps gives the same results as learning that checks all neurons each step.
+    using SynapseType = knp::synapse_traits::SynapticResourceSTDPDeltaSynapse;
+    using STDPDeltaProjection = knp::core::Projection<SynapseType>;
+    using BlifatStdpPopulation = knp::core::Population<knp::neuron_traits::SynapticResourceSTDPBLIFATNeuron>;
+
+    const size_t population_size = 4;
+    BlifatStdpPopulation cached_population{
+        [](size_t index) -> std::optional<BlifatStdpPopulation::NeuronParameters>
+        {
+            BlifatStdpPopulation::NeuronParameters neuron{{}};
+            neuron.synaptic_resource_threshold_ = 1.5F;
+            neuron.free_synaptic_resource_ = static_cast<float>(index);
+            neuron.isi_max_ = 2;
+            neuron.d_h_ = 0.6F;
+            neuron.stability_change_parameter_ = 0.1F;
+            neuron.resource_drain_coefficient_ = 1;
+            return neuron;
+        },
+        population_size};
+    // A synapse leads from each presynaptic neuron to each postsynaptic neuron.
+    STDPDeltaProjection cached_projection{
+        knp::core::UID{}, cached_population.get_uid(),
+        [](size_t index) -> std::optional<STDPDeltaProjection::Synapse>
+        {
+            STDPDeltaProjection::Synapse synapse{{}, index / population_size, index % population_size};
+            std::get<knp::core::synapse_data>(synapse).rule_.dopamine_plasticity_period_ = 3;
+            return synapse;
+        },
+        population_size * population_size};
+    cached_projection.unlock_weights();
+    auto population = cached_population;
+    auto projection = cached_projection;
+    const auto initial_projection = cached_projection;
+    std::vector<STDPDeltaProjection *> cached_projections{&cached_projection};
+    std::vector<STDPDeltaProjection *> projections{&projection};
+
+    knp::backends::cpu::ResourceSTDPState<SynapseType> state;
+    state.prepare(population_size);
+    state.update_synapses(cached_projections, population_size);
+    for (uint64_t step = 1; step < 40; ++step)
+    {
+        // Presynaptic neuron spikes reach synapses.
+        for (auto synapse_index : projection.synapses_of_presynaptic(step % population_size))
+        {
+            std::get<knp::core::synapse_data>(cached_projection[synapse_index]).rule_.last_spike_step_ = step;
+            std::get<knp::core::synapse_data>(projection[synapse_index]).rule_.last_spike_step_ = step;
+        }
+
+        // Some neurons receive dopamine.
+        const float dopamine = step % 7 == 0 ? 1.0F : (step % 11 == 0 ? -0.5F : 0.0F);
+        for (size_t index = 0; index < population_size; ++index)
+        {
+            const float neuron_dopamine = index == step % 3 ? dopamine : 0.0F;
+            cached_population[index].dopamine_value_ = neuron_dopamine;
+            population[index].dopamine_value_ = neuron_dopamine;
+            if (neuron_dopamine != 0.0F) state.dopamine_neurons_.insert(index);
+        }
+
+        // Some neurons spike.
+        std::optional<knp::core::messaging::SpikeMessage> message;
+        if (step % 3 != 0) message = knp::core::messaging::SpikeMessage{{}, {static_cast<uint32_t>(step % 4)}};
+
+        knp::backends::cpu::do_STDP_resource_plasticity(cached_population, state, message, step);
+        knp::backends::cpu::do_STDP_resource_plasticity(population, projections, message, step);
+    }
+
+    bool is_weight_changed = false;
+    for (size_t index = 0; index < projection.size(); ++index)
+    {
+        const auto &synapse = std::get<knp::core::synapse_data>(projection[index]);
+        const auto &cached_synapse = std::get<knp::core::synapse_data>(cached_projection[index]);
+        ASSERT_FLOAT_EQ(cached_synapse.rule_.synaptic_resource_, synapse.rule_.synaptic_resource_);
+        ASSERT_FLOAT_EQ(cached_synapse.weight_, synapse.weight_);
+        is_weight_changed |= synapse.weight_ != std::get<knp::core::synapse_data>(initial_projection[index]).weight_;
+    }
+    for (size_t index = 0; index < population_size; ++index)
+    {
+        ASSERT_FLOAT_EQ(cached_population[index].free_synaptic_resource_, population[index].free_synaptic_resource_);
+        ASSERT_FLOAT_EQ(cached_population[index].stability_, population[index].stability_);
+    }
+    ASSERT_TRUE(is_weight_changed);
+}
+
+
 TEST(SingleThreadCpuSuite, NeuronsGettingTest)
 {
     const knp::testing::STestingBack backend;
@@ -303,3 +776,241 @@ TEST(SingleThreadCpuSuite, SynapsesGettingTest)
     ASSERT_LE(s_synapses.size(), boost::mp11::mp_size<knp::synapse_traits::AllSynapses>());
     ASSERT_EQ(s_synapses[0], "DeltaSynapse");
 }
+
+
+TEST(SingleThreadCpuSuite, DelayQueueTest)
+{
+    knp::backends::cpu::DelayQueue queue(2);
+    ASSERT_EQ(queue.size(), 3);
+
+    const knp::core::messaging::SynapticImpact impact{0, 1.0F, knp::synapse_traits::OutputType::EXCITATORY, 0, 1};
+    const uint64_t step = 10;
+    queue.push(step, step, impact);
+    queue.push(step, step + 2, impact);
+    queue.push(step, step + 2, impact);
+    // The impact delay is larger than the queue length, so the queue grows and keeps existing impacts.
+    queue.push(step, step + 5, impact);
+    ASSERT_EQ(queue.size(), 6);
+    ASSERT_EQ(queue.get_impacts(step).size(), 1);
+    ASSERT_TRUE(queue.get_impacts(step + 1).empty());
+    ASSERT_EQ(queue.get_impacts(step + 2).size(), 2);
+    ASSERT_EQ(queue.get_impacts(step + 5).size(), 1);
+
+    queue.clear_step(step);
+    ASSERT_TRUE(queue.get_impacts(step).empty());
+    // The slot of the cleared step is reused by the step that follows the last step of the queue.
+    queue.push(step + 1, step + 6, impact);
+    ASSERT_EQ(queue.get_impacts(step + 6).size(), 1);
+}
+
+
+// Compare column neuron calculation with calculation of separate neurons.
+// If `KNP_ENABLE_AVX` is defined, vectorized routines of the corresponding precision are checked.
+template <class Real>
+void check_blifat_columns(bool shared_static_parameters)
+{
+    using BLIFATNeuron = knp::neuron_traits::BLIFATNeuronT<Real>;
+    using BLIFATParams = knp::neuron_traits::neuron_parameters<BLIFATNeuron>;
+    // Not a multiple of the vector width, so both vectorized and scalar routines are used.
+    constexpr size_t neurons_count = 37;
+    constexpr size_t steps_count = 20;
+
+    auto generator = [shared_static_parameters](size_t index)
+    {
+        // Static parameters depend on the neuron index only if they are not shared.
+        const size_t static_index = shared_static_parameters ? 1 : index;
+        BLIFATParams neuron;
+        neuron.potential_ = static_cast<Real>(index % 7) * static_cast<Real>(0.3);
+        neuron.potential_decay_ = 0.9;
+        neuron.activation_threshold_ = 1.0;
+        neuron.threshold_increment_ = static_cast<Real>(0.1) * static_cast<Real>(static_index % 3);
+        neuron.threshold_decay_ = 0.95;
+        neuron.postsynaptic_trace_increment_ = 1.0;
+        neuron.postsynaptic_trace_decay_ = 0.8;
+        neuron.inhibitory_conductance_decay_ = 0.7;
+        neuron.bursting_period_ = static_index % 4;
+        neuron.reflexive_weight_ = 0.5;
+        neuron.absolute_refractory_period_ = static_index % 2;
+        neuron.min_potential_ = -0.5;
+        // Cover positive, negative and absent blocking periods.
+        if (index % 5 == 0) neuron.total_blocking_period_ = 2;
+        if (index % 5 == 1) neuron.total_blocking_period_ = -3;
+        return std::optional<BLIFATParams>(neuron);
+    };
+
+    std::vector<BLIFATParams> expected;
+    for (size_t index = 0; index < neurons_count; ++index) expected.push_back(*generator(index));
+    knp::core::Population<BLIFATNeuron> population(generator, neurons_count);
+    ASSERT_EQ(population.get_neuron_columns().has_shared_static_parameters(), shared_static_parameters);
+
+    for (size_t step = 0; step < steps_count; ++step)
+    {
+        std::vector<knp::core::messaging::SynapticImpact> impacts;
+        for (uint32_t index = step % 3; index < neurons_count; index += 3)
+        {
+            const auto type = (index + step) % 11 == 0 ? knp::synapse_traits::OutputType::INHIBITORY_CONDUCTANCE
+                                                       : knp::synapse_traits::OutputType::EXCITATORY;
+            impacts.push_back({0, static_cast<float>(step % 4) * 0.4F, type, 0, index});
+        }
+        const knp::backends::cpu::SharedImpactMessages messages{
+            std::make_shared<const knp::core::messaging::SynapticImpactMessage>(
+                knp::core::messaging::SynapticImpactMessage{{}, {}, {}, false, impacts})};
+
+        knp::core::messaging::SpikeData expected_spikes;
+        for (size_t index = 0; index < neurons_count; ++index)
+        {
+            ++expected[index].n_time_steps_since_last_firing_;
+            knp::backends::cpu::calculate_single_neuron_state<BLIFATNeuron>(expected[index]);
+        }
+        for (const auto &impact : impacts)
+        {
+            knp::backends::cpu::impact_neuron<BLIFATNeuron>(
+                expected[impact.postsynaptic_neuron_index_], impact.synapse_type_, impact.impact_value_);
+        }
+        for (size_t index = 0; index < neurons_count; ++index)
+        {
+            if (knp::backends::cpu::calculate_neuron_post_input_state<BLIFATNeuron>(expected[index]))
+            {
+                expected_spikes.push_back(index);
+            }
+        }
+
+        knp::core::messaging::SpikeData spikes;
+        knp::backends::cpu::calculate_neurons_state(population, messages);
+        knp::backends::cpu::calculate_neurons_post_input_state(population, spikes);
+        ASSERT_EQ(spikes, expected_spikes);
+    }
+
+    for (size_t index = 0; index < neurons_count; ++index)
+    {
+        const auto &neuron = population[index];
+        if constexpr (std::is_same_v<Real, double>)
+        {
+            ASSERT_DOUBLE_EQ(neuron.potential_, expected[index].potential_);
+            ASSERT_DOUBLE_EQ(neuron.dynamic_threshold_, expected[index].dynamic_threshold_);
+            ASSERT_DOUBLE_EQ(neuron.postsynaptic_trace_, expected[index].postsynaptic_trace_);
+            ASSERT_DOUBLE_EQ(neuron.inhibitory_conductance_, expected[index].inhibitory_conductance_);
+        }
+        else
+        {
+            ASSERT_FLOAT_EQ(neuron.potential_, expected[index].potential_);
+            ASSERT_FLOAT_EQ(neuron.dynamic_threshold_, expected[index].dynamic_threshold_);
+            ASSERT_FLOAT_EQ(neuron.postsynaptic_trace_, expected[index].postsynaptic_trace_);
+            ASSERT_FLOAT_EQ(neuron.inhibitory_conductance_, expected[index].inhibitory_conductance_);
+        }
+        ASSERT_EQ(neuron.n_time_steps_since_last_firing_, expected[index].n_time_steps_since_last_firing_);
+        ASSERT_EQ(neuron.bursting_phase_, expected[index].bursting_phase_);
+        ASSERT_EQ(neuron.total_blocking_period_, expected[index].total_blocking_period_);
+    }
+}
+
+
+TEST(SingleThreadCpuSuite, BLIFATColumnsTest)
+{
+    check_blifat_columns<double>(false);
+}
+
+
+TEST(SingleThreadCpuSuite, BLIFATSharedColumnsTest)
+{
+    check_blifat_columns<double>(true);
+}
+
+
+TEST(SingleThreadCpuSuite, BLIFATFloatColumnsTest)
+{
+    check_blifat_columns<float>(false);
+}
+
+
+TEST(SingleThreadCpuSuite, BLIFATSharedFloatColumnsTest)
+{
+    check_blifat_columns<float>(true);
+}
+
+
+TEST(SingleThreadCpuSuite, BLIFATLazyColumnsTest)
+{
+    using BLIFATNeuron = knp::neuron_traits::BLIFATNeuron;
+    using BLIFATParams = knp::neuron_traits::neuron_parameters<BLIFATNeuron>;
+    constexpr size_t neurons_count = 50;
+    constexpr size_t steps_count = 60;
+    constexpr double tolerance = 1e-9;
+
+    auto generator = [](size_t index)
+    {
+        BLIFATParams neuron;
+        neuron.potential_ = static_cast<double>(index % 7) * 0.3;
+        neuron.potential_decay_ = 0.9;
+        neuron.threshold_increment_ = 0.2;
+        neuron.threshold_decay_ = 0.95;
+        neuron.postsynaptic_trace_increment_ = 1.0;
+        neuron.postsynaptic_trace_decay_ = 0.8;
+        neuron.bursting_period_ = index % 3;
+        neuron.reflexive_weight_ = 0.3;
+        neuron.min_potential_ = -0.5;
+        // Cover positive, negative and absent blocking periods.
+        if (index % 5 == 0) neuron.total_blocking_period_ = 20;
+        if (index % 5 == 1) neuron.total_blocking_period_ = -30;
+        return std::optional<BLIFATParams>(neuron);
+    };
+
+    std::vector<BLIFATParams> expected;
+    for (size_t index = 0; index < neurons_count; ++index) expected.push_back(*generator(index));
+    knp::core::Population<BLIFATNeuron> population(generator, neurons_count);
+
+    size_t min_active_count = neurons_count;
+    for (size_t step = 0; step < steps_count; ++step)
+    {
+        // Impact a few neurons, so that most neurons are quiescent most of the time.
+        std::vector<knp::core::messaging::SynapticImpact> impacts;
+        for (uint32_t index = step % 11; index < neurons_count; index += 17)
+        {
+            const auto type = step % 7 == 0 ? knp::synapse_traits::OutputType::INHIBITORY_CURRENT
+                                            : knp::synapse_traits::OutputType::EXCITATORY;
+            impacts.push_back({0, 0.6F, type, 0, index});
+        }
+        const knp::backends::cpu::SharedImpactMessages messages{
+            std::make_shared<const knp::core::messaging::SynapticImpactMessage>(
+                knp::core::messaging::SynapticImpactMessage{{}, {}, {}, false, impacts})};
+
+        knp::core::messaging::SpikeData expected_spikes;
+        for (size_t index = 0; index < neurons_count; ++index)
+        {
+            ++expected[index].n_time_steps_since_last_firing_;
+            knp::backends::cpu::calculate_single_neuron_state<BLIFATNeuron>(expected[index]);
+        }
+        for (const auto &impact : impacts)
+        {
+            knp::backends::cpu::impact_neuron<BLIFATNeuron>(
+                expected[impact.postsynaptic_neuron_index_], impact.synapse_type_, impact.impact_value_);
+        }
+        for (size_t index = 0; index < neurons_count; ++index)
+        {
+            if (knp::backends::cpu::calculate_neuron_post_input_state<BLIFATNeuron>(expected[index]))
+            {
+                expected_spikes.push_back(index);
+            }
+        }
+
+        knp::core::messaging::SpikeData spikes;
+        auto &columns = population.get_neuron_columns();
+        knp::backends::cpu::calculate_lazy_column_neurons(columns, messages, spikes);
+        ASSERT_EQ(spikes, expected_spikes);
+        min_active_count = std::min(min_active_count, columns.active_neurons_.size());
+    }
+    ASSERT_LT(min_active_count, neurons_count / 2);
+
+    // Gathering neurons advances inactive neurons to the last step.
+    for (size_t index = 0; index < neurons_count; ++index)
+    {
+        const auto &neuron = population[index];
+        ASSERT_NEAR(neuron.potential_, expected[index].potential_, tolerance);
+        ASSERT_NEAR(neuron.pre_impact_potential_, expected[index].pre_impact_potential_, tolerance);
+        ASSERT_NEAR(neuron.dynamic_threshold_, expected[index].dynamic_threshold_, tolerance);
+        ASSERT_NEAR(neuron.postsynaptic_trace_, expected[index].postsynaptic_trace_, tolerance);
+        ASSERT_EQ(neuron.n_time_steps_since_last_firing_, expected[index].n_time_steps_since_last_firing_);
+        ASSERT_EQ(neuron.bursting_phase_, expected[index].bursting_phase_);
+        ASSERT_EQ(neuron.total_blocking_period_, expected[index].total_blocking_period_);
+    }
+}
@@ -0,0 +1,40 @@
+/**
+ * @file testing_backends.h
+ * @brief Backends with test access to protected methods.
+ * @kaspersky_support Artiom N.
+ * @date 18.10.2026
+ * @license Apache 2.0
+ * @copyright © 2024 AO Kaspersky Lab
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include <knp/backends/cpu-single-threaded/backend.h>
+
+
+/**
+ * @brief Test namespace.
+ */
+namespace knp::testing
+{
+
+class STestingBack : public knp::backends::single_threaded_cpu::SingleThreadedCPUBackend
+{
+public:
+    STestingBack() = default;
+    void _init() override { knp::backends::single_threaded_cpu::SingleThreadedCPUBackend::_init(); }
+};
+
+}  // namespace knp::testing
@@ -24,6 +24,10 @@
 
 #include <tests_common.h>
 
+#include <algorithm>
+#include <thread>
+#include <vector>
+
 
 TEST(MessageBusSuite, AddSubscriptionMessage)
 {
@@ -49,13 +53,24 @@ TEST(MessageBusSuite, SubscribeUnsubscribe)
     auto entry_point{bus.create_endpoint()};
     const knp::core::UID sender{true}, receiver{true}, false_uid{true};
     // Add subscription for spike messages.
-    entry_point.subscribe<knp::core::messaging::SpikeMessage>(receiver, {sender});
+    size_t revision = entry_point.get_subscriptions_revision();
+    auto &subscription = entry_point.subscribe<knp::core::messaging::SpikeMessage>(receiver, {sender});
+    EXPECT_NE(entry_point.get_subscriptions_revision(), revision);
+    // Adding a new sender changes subscription revision, adding an existing one doesn't.
+    revision = entry_point.get_subscriptions_revision();
+    subscription.add_sender(sender);
+    EXPECT_EQ(entry_point.get_subscriptions_revision(), revision);
+    subscription.add_sender(false_uid);
+    EXPECT_NE(entry_point.get_subscriptions_revision(), revision);
     // Try removing subscription with a wrong ID. This should return false.
+    revision = entry_point.get_subscriptions_revision();
     EXPECT_EQ(entry_point.unsubscribe<knp::core::messaging::SpikeMessage>(false_uid), false);
+    EXPECT_EQ(entry_point.get_subscriptions_revision(), revision);
     // Try removing subscription to a wrong message type. This should return false.
     EXPECT_EQ(entry_point.unsubscribe<knp::core::messaging::SynapticImpactMessage>(receiver), false);
     // Try removing an existing subscription. This should return true.
     EXPECT_EQ(entry_point.unsubscribe<knp::core::messaging::SpikeMessage>(receiver), true);
+    EXPECT_NE(entry_point.get_subscriptions_revision(), revision);
     // Try removing the subscribtion again. This should return false as it's already deleted.
     EXPECT_EQ(entry_point.unsubscribe<knp::core::messaging::SpikeMessage>(receiver), false);
 }
@@ -81,8 +96,8 @@ TEST(MessageBusSuite, CreateBusAndEndpointZMQ)
     const auto &msgs = subscription.get_messages();
 
     EXPECT_EQ(msgs.size(), 1);
-    EXPECT_EQ(msgs[0].header_.sender_uid_, msg.header_.sender_uid_);
-    EXPECT_EQ(msgs[0].neuron_indexes_, msg.neuron_indexes_);
+    EXPECT_EQ(msgs[0]->header_.sender_uid_, msg.header_.sender_uid_);
+    EXPECT_EQ(msgs[0]->neuron_indexes_, msg.neuron_indexes_);
 }
 
 
@@ -99,15 +114,242 @@ TEST(MessageBusSuite, CreateBusAndEndpointCPU)
     auto &subscription = ep2.subscribe<SpikeMessage>(knp::core::UID(), {msg.header_.sender_uid_});
 
     ep1.send_message(msg);
-    // Message ID and message data.
-    EXPECT_EQ(bus.route_messages(), 2);
+    // The message is delivered only to the subscribed endpoint.
+    EXPECT_EQ(bus.route_messages(), 1);
     ep2.receive_all_messages();
 
     const auto &msgs = subscription.get_messages();
 
     EXPECT_EQ(msgs.size(), 1);
-    EXPECT_EQ(msgs[0].header_.sender_uid_, msg.header_.sender_uid_);
-    EXPECT_EQ(msgs[0].neuron_indexes_, msg.neuron_indexes_);
+    EXPECT_EQ(msgs[0]->header_.sender_uid_, msg.header_.sender_uid_);
+    EXPECT_EQ(msgs[0]->neuron_indexes_, msg.neuron_indexes_);
+}
+
+
+TEST(MessageBusSuite, SubscriptionRoutingCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    knp::core::MessageBus bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus.create_endpoint()};
+    auto ep1{bus.create_endpoint()};
+    auto ep2{bus.create_endpoint()};
+    const knp::core::UID sender1, sender2, receiver;
+
+    auto &subscription1 = ep1.subscribe<SpikeMessage>(receiver, {sender1});
+    auto &subscription2 = ep2.subscribe<SpikeMessage>(receiver, {sender2});
+    // Endpoints build routing tables when they receive messages.
+    ep1.receive_all_messages();
+    ep2.receive_all_messages();
+
+    sender_ep.send_message(SpikeMessage{{sender1}, {1}});
+    sender_ep.send_message(SpikeMessage{{sender2}, {2}});
+    sender_ep.send_message(SpikeMessage{{knp::core::UID{}}, {3}});
+    // Each message is delivered only to the endpoint subscribed to its sender.
+    EXPECT_EQ(bus.route_messages(), 2);
+    ep1.receive_all_messages();
+    ep2.receive_all_messages();
+    ASSERT_EQ(subscription1.get_messages().size(), 1);
+    EXPECT_EQ(subscription1.get_messages()[0]->neuron_indexes_, std::vector<uint32_t>{1});
+    ASSERT_EQ(subscription2.get_messages().size(), 1);
+    EXPECT_EQ(subscription2.get_messages()[0]->neuron_indexes_, std::vector<uint32_t>{2});
+
+    // A sender added to the subscription directly is taken into account.
+    subscription2.add_sender(sender1);
+    sender_ep.send_message(SpikeMessage{{sender1}, {4}});
+    bus.route_messages();
+    ep1.receive_all_messages();
+    ep2.receive_all_messages();
+    EXPECT_EQ(subscription1.get_messages().size(), 2);
+    ASSERT_EQ(subscription2.get_messages().size(), 2);
+    EXPECT_EQ(subscription2.get_messages()[1]->neuron_indexes_, std::vector<uint32_t>{4});
+    // Both subscriptions share the same message.
+    EXPECT_EQ(subscription1.get_messages()[1].get(), subscription2.get_messages()[1].get());
+
+    // Unsubscribed endpoint doesn't receive messages.
+    ASSERT_TRUE(ep1.unsubscribe<SpikeMessage>(receiver));
+    ep1.receive_all_messages();
+    sender_ep.send_message(SpikeMessage{{sender1}, {5}});
+    EXPECT_EQ(bus.route_messages(), 1);
+}
+
+
+TEST(MessageBusSuite, NewSenderRoutingCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    knp::core::MessageBus bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus.create_endpoint()};
+    auto ep{bus.create_endpoint()};
+
+    const knp::core::UID sender1, sender2, receiver;
+    auto &subscription = ep.subscribe<SpikeMessage>(receiver, {sender1});
+    ep.receive_all_messages();
+
+    // The second sender was never subscribed to before the message is routed.
+    sender_ep.send_message(SpikeMessage{{sender2}, {1}});
+    subscription.add_sender(sender2);
+    EXPECT_EQ(bus.route_messages(), 1);
+    EXPECT_EQ(ep.receive_all_messages(), 1);
+    ASSERT_EQ(subscription.get_messages().size(), 1);
+    EXPECT_EQ(subscription.get_messages()[0]->neuron_indexes_, std::vector<uint32_t>{1});
+
+    // Messages from both senders are routed by the updated tables.
+    sender_ep.send_message(SpikeMessage{{sender1}, {2}});
+    sender_ep.send_message(SpikeMessage{{sender2}, {3}});
+    EXPECT_EQ(bus.route_messages(), 2);
+    EXPECT_EQ(ep.receive_all_messages(), 2);
+    EXPECT_EQ(subscription.get_messages().size(), 3);
+}
+
+
+TEST(MessageBusSuite, SharedMessagesCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    knp::core::MessageBus bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus.create_endpoint()};
+    auto ep1{bus.create_endpoint()};
+    auto ep2{bus.create_endpoint()};
+
+    const knp::core::UID sender;
+    const knp::core::UID receiver1, receiver2;
+
+    ep1.subscribe<SpikeMessage>(receiver1, {sender});
+    ep1.subscribe<SpikeMessage>(receiver2, {sender});
+    ep2.subscribe<SpikeMessage>(receiver1, {sender});
+
+    sender_ep.send_message(SpikeMessage{{sender}, {1, 2, 3}});
+    EXPECT_EQ(bus.route_messages(), 2);
+    ep1.receive_all_messages();
+    ep2.receive_all_messages();
+
+    // All receivers get the same message without copying.
+    const auto shared_msgs1 = ep1.unload_shared_messages<SpikeMessage>(receiver1);
+    const auto shared_msgs2 = ep2.unload_shared_messages<SpikeMessage>(receiver1);
+    ASSERT_EQ(shared_msgs1.size(), 1);
+    ASSERT_EQ(shared_msgs2.size(), 1);
+    EXPECT_EQ(shared_msgs1[0].get(), shared_msgs2[0].get());
+    EXPECT_EQ(shared_msgs1[0]->neuron_indexes_, std::vector<uint32_t>({1, 2, 3}));
+
+    // Message shared with other receivers is copied.
+    const auto msgs = ep1.unload_messages<SpikeMessage>(receiver2);
+    ASSERT_EQ(msgs.size(), 1);
+    EXPECT_EQ(msgs[0].neuron_indexes_, shared_msgs1[0]->neuron_indexes_);
+    EXPECT_NE(msgs[0].neuron_indexes_.data(), shared_msgs1[0]->neuron_indexes_.data());
+    EXPECT_TRUE(ep1.unload_messages<SpikeMessage>(receiver2).empty());
+}
+
+
+TEST(MessageBusSuite, UnsharedMessageMoveCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    knp::core::MessageBus bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus.create_endpoint()};
+    auto ep{bus.create_endpoint()};
+
+    const knp::core::UID sender, receiver;
+    ep.subscribe<SpikeMessage>(receiver, {sender});
+
+    SpikeMessage message{{sender}, {1, 2, 3}};
+    const auto *indexes_data = message.neuron_indexes_.data();
+    sender_ep.send_message(std::move(message));
+    EXPECT_EQ(bus.route_messages(), 1);
+    ep.receive_all_messages();
+
+    // Message without other receivers is moved from sender to receiver.
+    const auto msgs = ep.unload_messages<SpikeMessage>(receiver);
+    ASSERT_EQ(msgs.size(), 1);
+    EXPECT_EQ(msgs[0].neuron_indexes_, std::vector<uint32_t>({1, 2, 3}));
+    EXPECT_EQ(msgs[0].neuron_indexes_.data(), indexes_data);
+}
+
+
+TEST(MessageBusSuite, BatchedRoutingCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    knp::core::MessageBus bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus.create_endpoint()};
+    auto ep1{bus.create_endpoint()};
+    auto ep2{bus.create_endpoint()};
+
+    const knp::core::UID sender1, sender2, receiver;
+    auto &subscription1 = ep1.subscribe<SpikeMessage>(receiver, {sender1, sender2});
+    auto &subscription2 = ep2.subscribe<SpikeMessage>(receiver, {sender2});
+    ep1.receive_all_messages();
+    ep2.receive_all_messages();
+
+    sender_ep.send_message(SpikeMessage{{sender1}, {1}});
+    sender_ep.send_message(SpikeMessage{{sender2}, {2}});
+    sender_ep.send_message(SpikeMessage{{sender1}, {3}});
+    // All messages are routed at once.
+    EXPECT_EQ(bus.route_messages(), 4);
+    EXPECT_EQ(bus.step(), 0);
+    EXPECT_EQ(ep1.receive_all_messages(), 3);
+    EXPECT_EQ(ep2.receive_all_messages(), 1);
+
+    // Messages are received in the order they were sent.
+    const auto &msgs = subscription1.get_messages();
+    ASSERT_EQ(msgs.size(), 3);
+    EXPECT_EQ(msgs[0]->neuron_indexes_, std::vector<uint32_t>{1});
+    EXPECT_EQ(msgs[1]->neuron_indexes_, std::vector<uint32_t>{2});
+    EXPECT_EQ(msgs[2]->neuron_indexes_, std::vector<uint32_t>{3});
+    ASSERT_EQ(subscription2.get_messages().size(), 1);
+    EXPECT_EQ(msgs[1].get(), subscription2.get_messages()[0].get());
+}
+
+
+TEST(MessageBusSuite, ConcurrentSendCPU)
+{
+    using SpikeMessage = knp::core::messaging::SpikeMessage;
+    constexpr size_t threads_count = 4;
+    constexpr uint32_t messages_count = 100;
+
+    knp::core::MessageBus bus = knp::core::MessageBus::construct_cpu_bus();
+
+    auto sender_ep{bus.create_endpoint()};
+    auto receiver_ep{bus.create_endpoint()};
+
+    const knp::core::UID receiver;
+    std::vector<knp::core::UID> senders(threads_count);
+    auto &subscription = receiver_ep.subscribe<SpikeMessage>(receiver, senders);
+    receiver_ep.receive_all_messages();
+
+    // Queue nodes freed in the first round are reused by the senders in the second one.
+    for (size_t round = 0; round < 2; ++round)
+    {
+        // All threads send messages via the same endpoint.
+        std::vector<std::thread> threads;
+        for (size_t thread_index = 0; thread_index < threads_count; ++thread_index)
+        {
+            threads.emplace_back(
+                [&sender_ep, &senders, thread_index]()
+                {
+                    for (uint32_t message_index = 0; message_index < messages_count; ++message_index)
+                    {
+                        sender_ep.send_message(SpikeMessage{{senders[thread_index], message_index}, {message_index}});
+                    }
+                });
+        }
+        for (auto &thread : threads) thread.join();
+
+        EXPECT_EQ(bus.route_messages(), threads_count * messages_count);
+        EXPECT_EQ(receiver_ep.receive_all_messages(), threads_count * messages_count);
+
+        // Messages of each sender are received in the order they were sent.
+        std::vector<uint32_t> next_message_index(threads_count, 0);
+        for (const auto &message : subscription.get_messages())
+        {
+            const auto sender_iter = std::find(senders.begin(), senders.end(), message->header_.sender_uid_);
+            ASSERT_NE(sender_iter, senders.end());
+            auto &expected_index = next_message_index[sender_iter - senders.begin()];
+            EXPECT_EQ(message->neuron_indexes_, std::vector<uint32_t>{expected_index});
+            ++expected_index;
+        }
+        subscription.clear_messages();
+    }
 }
 
 
@@ -135,11 +377,11 @@ TEST(MessageBusSuite, SynapticImpactMessageSendZMQ)
     const auto &msgs = subscription.get_messages();
 
     EXPECT_EQ(msgs.size(), 1);
-    EXPECT_EQ(msgs[0].header_.sender_uid_, msg.header_.sender_uid_);
-    ASSERT_EQ(msgs[0].presynaptic_population_uid_, msg.presynaptic_population_uid_);
-    ASSERT_EQ(msgs[0].postsynaptic_population_uid_, msg.postsynaptic_population_uid_);
-    ASSERT_EQ(msgs[0].is_forcing_, msg.is_forcing_);
-    ASSERT_EQ(msgs[0].impacts_, msg.impacts_);
+    EXPECT_EQ(msgs[0]->header_.sender_uid_, msg.header_.sender_uid_);
+    ASSERT_EQ(msgs[0]->presynaptic_population_uid_, msg.presynaptic_population_uid_);
+    ASSERT_EQ(msgs[0]->postsynaptic_population_uid_, msg.postsynaptic_population_uid_);
+    ASSERT_EQ(msgs[0]->is_forcing_, msg.is_forcing_);
+    ASSERT_EQ(msgs[0]->impacts_, msg.impacts_);
 }
 
 
@@ -167,9 +409,9 @@ TEST(MessageBusSuite, SynapticImpactMessageSendCPU)
     const auto &msgs = subscription.get_messages();
 
     EXPECT_EQ(msgs.size(), 1);
-    EXPECT_EQ(msgs[0].header_.sender_uid_, msg.header_.sender_uid_);
-    ASSERT_EQ(msgs[0].presynaptic_population_uid_, msg.presynaptic_population_uid_);
-    ASSERT_EQ(msgs[0].postsynaptic_population_uid_, msg.postsynaptic_population_uid_);
-    ASSERT_EQ(msgs[0].is_forcing_, msg.is_forcing_);
-    ASSERT_EQ(msgs[0].impacts_, msg.impacts_);
+    EXPECT_EQ(msgs[0]->header_.sender_uid_, msg.header_.sender_uid_);
+    ASSERT_EQ(msgs[0]->presynaptic_population_uid_, msg.presynaptic_population_uid_);
+    ASSERT_EQ(msgs[0]->postsynaptic_population_uid_, msg.postsynaptic_population_uid_);
+    ASSERT_EQ(msgs[0]->is_forcing_, msg.is_forcing_);
+    ASSERT_EQ(msgs[0]->impacts_, msg.impacts_);
 }
@@ -81,3 +81,79 @@ TEST(PopulationSuite, SetNeuronParameter)
 
     ASSERT_EQ(150, population[p_index].potential_);
 }
+
+
+TEST(PopulationSuite, NeuronColumns)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+
+    auto &columns = population.get_neuron_columns();
+    ASSERT_EQ(columns.size(), neurons_count);
+    ASSERT_EQ(population.size(), neurons_count);
+    for (size_t index = 0; index < neurons_count; ++index)
+    {
+        ASSERT_EQ(columns.potential_[index], index);
+    }
+
+    constexpr size_t p_index = neurons_count / 2;
+    columns.potential_[p_index] = 150;
+    columns.bursting_phase_[p_index] = 3;
+
+    // Constant access gathers parameters from columns.
+    const auto &const_population = population;
+    ASSERT_EQ(const_population[p_index].potential_, 150);
+    ASSERT_EQ(const_population.get_neuron_parameters(p_index).bursting_phase_, 3);
+    ASSERT_EQ(const_population.gather_neurons_parameters().size(), neurons_count);
+    size_t neuron_index = 0;
+    for (const auto &neuron : const_population) ASSERT_EQ(neuron.potential_, columns.potential_[neuron_index++]);
+    ASSERT_EQ(neuron_index, neurons_count);
+
+    // Non-constant access refers to column values, so references stay valid.
+    auto neuron = population[p_index];
+    ASSERT_EQ(&neuron.potential_, &columns.potential_[p_index]);
+    ASSERT_EQ(neuron.bursting_phase_, 3);
+    neuron.potential_ = 10;
+    ASSERT_EQ(columns.potential_[p_index], 10);
+    ASSERT_EQ(&population.get_neuron_columns(), &columns);
+    for (auto neuron_ref : population) neuron_ref.dopamine_value_ = 1;
+    ASSERT_EQ(columns.dopamine_value_[0], 1);
+    ASSERT_EQ(neuron.dopamine_value_, 1);
+
+    // Parameters are assigned to columns.
+    auto parameters = const_population[0];
+    parameters.potential_ = 20;
+    population[p_index] = parameters;
+    ASSERT_EQ(columns.potential_[p_index], 20);
+    population.set_neuron_parameters(p_index + 1, std::move(parameters));
+    ASSERT_EQ(columns.potential_[p_index + 1], 20);
+
+    // Neurons are added to and removed from columns.
+    population.remove_neuron(0);
+    ASSERT_EQ(columns.size(), neurons_count - 1);
+    ASSERT_EQ(columns.potential_[0], 1);
+    population.add_neurons(neuron_generator, 1);
+    ASSERT_EQ(population.size(), neurons_count);
+    ASSERT_EQ(columns.potential_[neurons_count - 1], 0);
+    ASSERT_TRUE(columns.has_shared_static_parameters());
+}
+
+
+TEST(PopulationSuite, SharedNeuronParameters)
+{
+    knp::core::Population<knp::neuron_traits::BLIFATNeuron> population(neuron_generator, neurons_count);
+
+    // All neurons have default static parameters, so they are stored once.
+    const auto &columns = population.get_neuron_columns();
+    ASSERT_TRUE(columns.has_shared_static_parameters());
+    ASSERT_EQ(columns.activation_threshold_.size(), 1);
+    ASSERT_EQ(columns.absolute_refractory_period_.size(), 1);
+    ASSERT_EQ(columns.potential_.size(), neurons_count);
+    ASSERT_EQ(population[neurons_count - 1].activation_threshold_, population[0].activation_threshold_);
+
+    population[1].activation_threshold_ += 1;
+    const auto &changed_columns = population.get_neuron_columns();
+    ASSERT_FALSE(changed_columns.has_shared_static_parameters());
+    ASSERT_EQ(changed_columns.activation_threshold_.size(), neurons_count);
+    ASSERT_EQ(changed_columns.activation_threshold_[1], changed_columns.activation_threshold_[0] + 1);
+    ASSERT_EQ(population[1].activation_threshold_, population[0].activation_threshold_ + 1);
+}
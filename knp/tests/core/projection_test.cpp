@@ -26,6 +26,7 @@
 
 #include <cstdlib>
 #include <optional>
+#include <utility>
 
 
 namespace knc = knp::core;
@@ -184,6 +185,83 @@ TEST(ProjectionSuite, DeletePostsynapticTest)
 }
 
 
+TEST(ProjectionSuite, SynapseIndexTest)
+{
+    const uint32_t size_from = 99;
+    const uint32_t size_to = 101;
+    const size_t synapses_per_neuron = 5;
+    auto generator =
+        make_cyclic_generator({size_from, size_to}, {0.0F, 1, knp::synapse_traits::OutputType::EXCITATORY});
+    DeltaProjection projection{knc::UID{}, knc::UID{}, generator, size_from * synapses_per_neuron};
+
+    for (size_t neuron_index = 0; neuron_index < size_to; ++neuron_index)
+    {
+        std::vector<size_t> expected_pre;
+        std::vector<size_t> expected_post;
+        for (size_t i = 0; i < projection.size(); ++i)
+        {
+            if (std::get<knp::core::source_neuron_id>(projection[i]) == neuron_index) expected_pre.push_back(i);
+            if (std::get<knp::core::target_neuron_id>(projection[i]) == neuron_index) expected_post.push_back(i);
+        }
+        const auto pre_range = projection.synapses_of_presynaptic(neuron_index);
+        const auto post_range = projection.synapses_of_postsynaptic(neuron_index);
+        ASSERT_EQ(std::vector<size_t>(pre_range.begin(), pre_range.end()), expected_pre);
+        ASSERT_EQ(std::vector<size_t>(post_range.begin(), post_range.end()), expected_post);
+        ASSERT_EQ(projection.find_synapses(neuron_index, DeltaProjection::Search::by_presynaptic), expected_pre);
+    }
+
+    // Neurons outside the projection have no synapses.
+    ASSERT_TRUE(projection.synapses_of_presynaptic(size_to * 2).empty());
+
+    // Index is rebuilt after the projection is modified.
+    projection.remove_presynaptic_neuron_synapses(0);
+    ASSERT_TRUE(projection.synapses_of_presynaptic(0).empty());
+    ASSERT_EQ(projection.synapses_of_presynaptic(1).size(), synapses_per_neuron);
+    projection.clear();
+    ASSERT_TRUE(projection.synapses_of_postsynaptic(1).empty());
+}
+
+
+TEST(ProjectionSuite, SynapseColumnsTest)
+{
+    const uint32_t size_from = 99;
+    const uint32_t size_to = 101;
+    auto generator = make_dense_generator({size_from, size_to}, {1.5F, 3, knp::synapse_traits::OutputType::BLOCKING});
+    DeltaProjection projection{knc::UID{}, knc::UID{}, generator, size_from * size_to};
+
+    const auto &columns = std::as_const(projection).get_synapse_columns();
+    ASSERT_EQ(columns.size(), projection.size());
+    for (size_t i = 0; i < projection.size(); ++i)
+    {
+        const auto &[params, id_from, id_to] = std::as_const(projection)[i];
+        ASSERT_EQ(columns.weights_[i], params.weight_);
+        ASSERT_EQ(columns.delays_[i], params.delay_);
+        ASSERT_EQ(columns.output_types_[i], params.output_type_);
+        ASSERT_EQ(columns.source_neuron_ids_[i], id_from);
+        ASSERT_EQ(columns.target_neuron_ids_[i], id_to);
+    }
+
+    // Columns are updated after synapses are modified through non-constant access.
+    std::get<knp::core::synapse_data>(projection[10]).weight_ = 2.0F;
+    ASSERT_EQ(projection.get_synapse_columns().weights_[10], 2.0F);
+    for (auto &synapse : projection) std::get<knp::core::synapse_data>(synapse).delay_ = 4;
+    ASSERT_EQ(projection.get_synapse_columns().delays_[20], 4);
+
+    // Synapses changed through a stored reference are applied after the projection is notified.
+    auto &synapse = std::get<knp::core::synapse_data>(projection[10]);
+    (void)projection.get_synapse_columns();
+    synapse.weight_ = 2.5F;
+    projection.mark_synapses_modified();
+    ASSERT_EQ(projection.get_synapse_columns().weights_[10], 2.5F);
+    synapse.weight_ = 2.0F;
+    projection.mark_synapses_modified();
+    projection.remove_synapse(0);
+    ASSERT_EQ(projection.get_synapse_columns().size(), size_from * size_to - 1);
+    ASSERT_EQ(projection.get_synapse_columns().weights_[9], 2.0F);
+    ASSERT_EQ(projection.get_synapse_columns().weights_[10], 1.5F);
+}
+
+
 TEST(ProjectionSuite, SynapseRemoval)
 {
     // Projection does not contain the neuron we are removing.
@@ -218,6 +296,29 @@ TEST(ProjectionSuite, SynapseRemoval)
 }
 
 
+TEST(ProjectionSuite, SynapsesRevisionTest)
+{
+    DeltaProjection projection{knc::UID{}, knc::UID{}};
+    auto revision = projection.get_synapses_revision();
+
+    projection.add_synapses(make_dense_generator({10, 10}, {0, 1, knp::synapse_traits::OutputType::EXCITATORY}), 100);
+    ASSERT_NE(projection.get_synapses_revision(), revision);
+    revision = projection.get_synapses_revision();
+
+    // Synapse parameters change doesn't change the synapse set.
+    std::get<knp::core::synapse_data>(projection[0]).weight_ = 2;
+    projection.lock_weights();
+    ASSERT_EQ(projection.get_synapses_revision(), revision);
+
+    projection.remove_synapse(0);
+    ASSERT_NE(projection.get_synapses_revision(), revision);
+    revision = projection.get_synapses_revision();
+
+    projection.clear();
+    ASSERT_NE(projection.get_synapses_revision(), revision);
+}
+
+
 TEST(ProjectionSuite, LockTest)
 {
     DeltaProjection projection(knc::UID{}, knc::UID{});
@@ -130,3 +130,27 @@ TEST_F(SaveLoadNetworkSuite, SaveLoadTest)
     auto network_loaded = knp::framework::sonata::load_network(path_to_network_);
     ASSERT_TRUE(are_networks_similar(network, network_loaded));
 }
+
+
+TEST_F(SaveLoadNetworkSuite, SaveLoadFloatNeuronsTest)
+{
+    using FloatNeuron = knp::neuron_traits::BLIFATFloatNeuron;
+    path_to_network_ = ".";
+    knp::core::Population<FloatNeuron> population{
+        [](size_t index)
+        {
+            knp::neuron_traits::neuron_parameters<FloatNeuron> neuron;
+            neuron.potential_ = 0.5F * static_cast<float>(index);
+            return neuron;
+        },
+        3};
+    knp::framework::Network network;
+    network.add_population(population);
+    knp::framework::sonata::save_network(network, path_to_network_);
+
+    auto network_loaded = knp::framework::sonata::load_network(path_to_network_);
+    ASSERT_TRUE(are_networks_similar(network, network_loaded));
+    const auto &loaded_population =
+        std::get<knp::core::Population<FloatNeuron>>(network_loaded.get_populations().front());
+    ASSERT_EQ(loaded_population[2].potential_, 1.0F);
+}